@@ -16,7 +16,7 @@
 #include "config.hpp"
 #include "engine/engine.hpp"
 #include "logger.hpp"
-#include "plasma-api/client.hpp"
+#include "plasma-api/client_handle.hpp"
 #include "plasma-api/workspace.hpp"
 #include "ts-proxy.hpp"
 
@@ -39,12 +39,16 @@ void Controller::bindEvents()
 {
     auto &workspace = m_plasmaApi.workspace();
     connect(&workspace, &PlasmaApi::Workspace::currentDesktopChanged, this, &Controller::onCurrentSurfaceChanged);
+    connect(&workspace, &PlasmaApi::Workspace::numberScreensChanged, this, &Controller::onSurfacesChanged);
     connect(&workspace, &PlasmaApi::Workspace::numberScreensChanged, this, &Controller::onSurfaceUpdate);
+    connect(&workspace, &PlasmaApi::Workspace::numberDesktopsChanged, this, &Controller::onSurfacesChanged);
+    connect(&workspace, &PlasmaApi::Workspace::activityAdded, this, &Controller::onSurfacesChanged);
+    connect(&workspace, &PlasmaApi::Workspace::activityRemoved, this, &Controller::onSurfacesChanged);
     connect(&workspace, &PlasmaApi::Workspace::screenResized, this, &Controller::onSurfaceUpdate);
     connect(&workspace, &PlasmaApi::Workspace::currentActivityChanged, this, &Controller::onCurrentSurfaceChanged);
     connect(&workspace, &PlasmaApi::Workspace::clientAdded, this, &Controller::onClientAdded);
     connect(&workspace, &PlasmaApi::Workspace::clientRemoved, this, &Controller::onClientRemoved);
-    connect(&workspace, &PlasmaApi::Workspace::clientMaximizeSet, this, [this](PlasmaApi::Client client, bool h, bool v) {
+    connect(&workspace, &PlasmaApi::Workspace::clientMaximizeSet, this, [this](PlasmaApi::ClientHandle client, bool h, bool v) {
         if (h == true && v == true) {
             onClientMaximized(client);
         } else if (h == false && v == false) {
@@ -53,6 +57,7 @@ void Controller::bindEvents()
     });
     connect(&workspace, &PlasmaApi::Workspace::clientMinimized, this, &Controller::onClientMinimized);
     connect(&workspace, &PlasmaApi::Workspace::clientUnminimized, this, &Controller::onClientUnminimized);
+    connect(&workspace, &PlasmaApi::Workspace::clientActivated, this, &Controller::onClientActivated);
 }
 
 void Controller::registerShortcuts()
@@ -88,15 +93,19 @@ void Controller::registerShortcuts()
 
     addShortcut("focus_upper_window", "Focus Upper Window", "Meta+K", [=]() {
         qDebug(Bi) << "Focus Upper Window Triggered!";
+        m_engine.focusWindowByDirection(Engine::FocusDirection::Up);
     });
     addShortcut("focus_bottom_window", "Focus Bottom Window", "Meta+J", [=]() {
         qDebug(Bi) << "Focus Bottom Window Triggered!";
+        m_engine.focusWindowByDirection(Engine::FocusDirection::Down);
     });
     addShortcut("focus_left_window", "Focus Left Window", "Meta+H", [=]() {
         qDebug(Bi) << "Focus Left Window Triggered!";
+        m_engine.focusWindowByDirection(Engine::FocusDirection::Left);
     });
     addShortcut("focus_right_window", "Focus Right Window", "Meta+L", [=]() {
         qDebug(Bi) << "Focus Right Window Triggered!";
+        m_engine.focusWindowByDirection(Engine::FocusDirection::Right);
     });
 
     addShortcut("move_window_to_next_pos", "Move Window to the Next Position", "", [=]() {
@@ -108,15 +117,19 @@ void Controller::registerShortcuts()
 
     addShortcut("move_window_to_upper_pos", "Move Window Up", "Meta+Shift+K", [=]() {
         qDebug(Bi) << "Move Window Up Triggered!";
+        m_engine.swapWindowByDirection(Engine::FocusDirection::Up);
     });
     addShortcut("move_window_to_bottom_pos", "Move Window Down", "Meta+Shift+J", [=]() {
         qDebug(Bi) << "Move Window Down Triggered!";
+        m_engine.swapWindowByDirection(Engine::FocusDirection::Down);
     });
     addShortcut("move_window_to_left_pos", "Move Window Left", "Meta+Shift+H", [=]() {
         qDebug(Bi) << "Move Window Left Triggered!";
+        m_engine.swapWindowByDirection(Engine::FocusDirection::Left);
     });
     addShortcut("move_window_to_right_pos", "Move Window Right", "Meta+Shift+L", [=]() {
         qDebug(Bi) << "Move Window Right Triggered!";
+        m_engine.swapWindowByDirection(Engine::FocusDirection::Right);
     });
 
     addShortcut("move_window_to_upper_surf", "Move Window Up Surface", "Meta+Alt+K", [=]() {
@@ -166,20 +179,25 @@ void Controller::registerShortcuts()
 
     addShortcut("push_window_to_master", "Push Active Window to Master Area", "Meta+Return", [=]() {
         qDebug(Bi) << "Push Active Window to Master Area Triggered!";
+        m_engine.pushWindowToMaster();
     });
 
     addShortcut("next_layout", "Switch to the Next Layout", "Meta+\\", [=]() {
         qDebug(Bi) << "Switch to the Next Layout Triggered!";
+        m_engine.cycleLayout(1);
     });
     addShortcut("prev_layout", "Switch to the Previous Layout", "Meta+|", [=]() {
         qDebug(Bi) << "Switch to the Previous Layout Triggered!";
+        m_engine.cycleLayout(-1);
     });
 
     addShortcut("toggle_tile_layout", "Toggle Tile Layout", "Meta+T", [=]() {
         qDebug(Bi) << "Toggle Tile Layout Triggered!";
+        m_engine.toggleLayout(QStringLiteral("TileLayout"));
     });
     addShortcut("toggle_monocle_layout", "Toggle Monocle Layout", "Meta+M", [=]() {
         qDebug(Bi) << "Toggle Monocle Layout Triggered!";
+        m_engine.toggleLayout(QStringLiteral("MonocleLayout"));
     });
 
     addShortcut("rotate", "Rotate Layout Clockwise", "Meta+R", [=]() {
@@ -349,7 +367,9 @@ void Controller::registerAction(const Action &data)
 
 void Controller::onCurrentSurfaceChanged()
 {
-    if (m_proxy && !m_config.experimentalBackend()) {
+    if (m_config.experimentalBackend()) {
+        m_engine.arrangeStaleSurfaces();
+    } else if (m_proxy) {
         auto ctl = m_proxy->jsController();
         auto func = ctl.property("onCurrentSurfaceChanged");
         func.callWithInstance(ctl);
@@ -358,41 +378,57 @@ void Controller::onCurrentSurfaceChanged()
 
 void Controller::onSurfaceUpdate()
 {
-    if (m_proxy && !m_config.experimentalBackend()) {
+    if (m_config.experimentalBackend()) {
+        m_engine.arrangeWindowsOnAllSurfaces();
+    } else if (m_proxy) {
         auto ctl = m_proxy->jsController();
         auto func = ctl.property("onSurfaceUpdate");
         func.callWithInstance(ctl);
     }
 }
 
-void Controller::onClientAdded(PlasmaApi::Client client)
+void Controller::onSurfacesChanged()
+{
+    if (m_config.experimentalBackend()) {
+        m_engine.updateSurfaces();
+    }
+}
+
+void Controller::onClientAdded(PlasmaApi::ClientHandle client)
 {
     if (m_config.experimentalBackend()) {
         m_engine.addWindow(client);
     }
 }
 
-void Controller::onClientRemoved(PlasmaApi::Client client)
+void Controller::onClientRemoved(PlasmaApi::ClientHandle client)
 {
     if (m_config.experimentalBackend()) {
         m_engine.removeWindow(client);
     }
 }
 
-void Controller::onClientMaximized(PlasmaApi::Client)
+void Controller::onClientMaximized(PlasmaApi::ClientHandle)
+{
+}
+
+void Controller::onClientUnmaximized(PlasmaApi::ClientHandle)
 {
 }
 
-void Controller::onClientUnmaximized(PlasmaApi::Client)
+void Controller::onClientMinimized(PlasmaApi::ClientHandle)
 {
 }
 
-void Controller::onClientMinimized(PlasmaApi::Client)
+void Controller::onClientUnminimized(PlasmaApi::ClientHandle)
 {
 }
 
-void Controller::onClientUnminimized(PlasmaApi::Client)
+void Controller::onClientActivated(PlasmaApi::ClientHandle client)
 {
+    if (m_config.experimentalBackend()) {
+        m_engine.windowActivated(client);
+    }
 }
 
 void Controller::setProxy(TSProxy *proxy)
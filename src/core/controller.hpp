@@ -14,7 +14,7 @@
 #include "config.hpp"
 #include "engine/engine.hpp"
 #include "plasma-api/api.hpp"
-#include "plasma-api/client.hpp"
+#include "plasma-api/client_handle.hpp"
 
 class TSProxy;
 
@@ -46,12 +46,14 @@ public:
 public Q_SLOTS:
     void onCurrentSurfaceChanged();
     void onSurfaceUpdate();
-    void onClientAdded(PlasmaApi::Client);
-    void onClientRemoved(PlasmaApi::Client);
-    void onClientMaximized(PlasmaApi::Client);
-    void onClientUnmaximized(PlasmaApi::Client);
-    void onClientMinimized(PlasmaApi::Client);
-    void onClientUnminimized(PlasmaApi::Client);
+    void onSurfacesChanged();
+    void onClientAdded(PlasmaApi::ClientHandle);
+    void onClientRemoved(PlasmaApi::ClientHandle);
+    void onClientMaximized(PlasmaApi::ClientHandle);
+    void onClientUnmaximized(PlasmaApi::ClientHandle);
+    void onClientMinimized(PlasmaApi::ClientHandle);
+    void onClientUnminimized(PlasmaApi::ClientHandle);
+    void onClientActivated(PlasmaApi::ClientHandle);
 
 private:
     std::vector<QAction *> m_registeredShortcuts{};
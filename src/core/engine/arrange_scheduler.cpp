@@ -0,0 +1,117 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include "arrange_scheduler.hpp"
+
+#include <utility>
+
+#include "engine/surface.hpp"
+
+namespace Bismuth
+{
+ArrangeScheduler::ArrangeScheduler(ArrangeFunction arrange, QObject *parent)
+    : QObject(parent)
+    , m_arrange(std::move(arrange))
+    , m_flushTimer()
+{
+    // Zero interval fires, once the events already in the queue are processed
+    m_flushTimer.setSingleShot(true);
+    m_flushTimer.setInterval(0);
+    connect(&m_flushTimer, &QTimer::timeout, this, &ArrangeScheduler::flush);
+}
+
+void ArrangeScheduler::schedule(const Surface &surface)
+{
+    m_requestedArranges++;
+    m_dirtySurfaces.insert(surface);
+    requestFlush();
+}
+
+void ArrangeScheduler::schedule(const std::vector<Surface> &surfaces)
+{
+    for (auto &surface : surfaces) {
+        schedule(surface);
+    }
+}
+
+void ArrangeScheduler::flush()
+{
+    m_flushTimer.stop();
+
+    // Arranging might ask for more arranges, they go to the next flush
+    auto surfaces = std::set<Surface>();
+    std::swap(surfaces, m_dirtySurfaces);
+
+    for (auto &surface : surfaces) {
+        if (m_isVisible && !m_isVisible(surface)) {
+            // A surface, that is already stale, needs just one arrange anyway
+            auto [_, inserted] = m_staleSurfaces.insert(surface);
+            m_deferredArranges += inserted;
+            continue;
+        }
+
+        m_staleSurfaces.erase(surface);
+        m_executedArranges++;
+        m_arrange(surface);
+    }
+}
+
+bool ArrangeScheduler::hasPendingArranges() const
+{
+    return !m_dirtySurfaces.empty();
+}
+
+void ArrangeScheduler::setVisibilityFilter(VisibilityFunction isVisible)
+{
+    m_isVisible = std::move(isVisible);
+}
+
+void ArrangeScheduler::scheduleStale()
+{
+    if (m_staleSurfaces.empty()) {
+        return;
+    }
+
+    // These are not new requests, so the counters stay the same
+    m_dirtySurfaces.insert(m_staleSurfaces.begin(), m_staleSurfaces.end());
+    requestFlush();
+}
+
+bool ArrangeScheduler::isStale(const Surface &surface) const
+{
+    return m_staleSurfaces.find(surface) != m_staleSurfaces.end();
+}
+
+void ArrangeScheduler::dropRemovedSurfaces(const ExistenceFunction &exists)
+{
+    for (auto it = m_staleSurfaces.begin(); it != m_staleSurfaces.end();) {
+        if (exists(*it)) {
+            ++it;
+        } else {
+            it = m_staleSurfaces.erase(it);
+        }
+    }
+}
+
+quint64 ArrangeScheduler::requestedArranges() const
+{
+    return m_requestedArranges;
+}
+
+quint64 ArrangeScheduler::executedArranges() const
+{
+    return m_executedArranges;
+}
+
+quint64 ArrangeScheduler::deferredArranges() const
+{
+    return m_deferredArranges;
+}
+
+void ArrangeScheduler::requestFlush()
+{
+    if (!m_flushTimer.isActive()) {
+        m_flushTimer.start();
+    }
+}
+}
@@ -0,0 +1,96 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <QObject>
+#include <QTimer>
+
+#include <functional>
+#include <set>
+#include <vector>
+
+#include "engine/surface.hpp"
+
+namespace Bismuth
+{
+/**
+ * Collects the surfaces, that need to be arranged, and arranges each of them
+ * once per event loop turn, no matter how many times it was requested.
+ *
+ * Surfaces, that nobody can see, are not arranged, but marked stale. They are
+ * arranged, once they are shown.
+ */
+class ArrangeScheduler : public QObject
+{
+    Q_OBJECT
+public:
+    using ArrangeFunction = std::function<void(const Surface &)>;
+    using VisibilityFunction = std::function<bool(const Surface &)>;
+    using ExistenceFunction = std::function<bool(const Surface &)>;
+
+    explicit ArrangeScheduler(ArrangeFunction arrange, QObject *parent = nullptr);
+
+    /**
+     * Mark the @p surface dirty. It is arranged on the next flush.
+     */
+    void schedule(const Surface &surface);
+    void schedule(const std::vector<Surface> &surfaces);
+
+    /**
+     * Arrange the dirty surfaces right away
+     */
+    void flush();
+
+    bool hasPendingArranges() const;
+
+    /**
+     * Arrange only the surfaces, for which @p isVisible returns true. By
+     * default all the surfaces are arranged.
+     */
+    void setVisibilityFilter(VisibilityFunction isVisible);
+
+    /**
+     * Schedule the stale surfaces again, e.g. because the current desktop
+     * changed. The ones, that are still hidden, stay stale.
+     */
+    void scheduleStale();
+
+    bool isStale(const Surface &surface) const;
+
+    /**
+     * Forget the stale surfaces, for which @p exists returns false, e.g. the
+     * ones of the removed screens. They would never be shown otherwise.
+     */
+    void dropRemovedSurfaces(const ExistenceFunction &exists);
+
+    /**
+     * Number of the arranges asked for, including the ones coalesced with others
+     */
+    quint64 requestedArranges() const;
+
+    /**
+     * Number of the arranges actually done
+     */
+    quint64 executedArranges() const;
+
+    /**
+     * Number of the times a hidden surface was marked stale instead of being arranged
+     */
+    quint64 deferredArranges() const;
+
+private:
+    void requestFlush();
+
+    ArrangeFunction m_arrange;
+    VisibilityFunction m_isVisible{};
+    std::set<Surface> m_dirtySurfaces{};
+    std::set<Surface> m_staleSurfaces{};
+
+    QTimer m_flushTimer;
+
+    quint64 m_requestedArranges{};
+    quint64 m_executedArranges{};
+    quint64 m_deferredArranges{};
+};
+}
@@ -0,0 +1,93 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include "client_snapshot.hpp"
+
+namespace Bismuth
+{
+ClientSnapshot ClientSnapshot::capture(PlasmaApi::ClientHandle client)
+{
+    auto result = ClientSnapshot();
+    result.geometry = client.frameGeometry();
+    result.desktop = client.desktop();
+    result.screen = client.screen();
+    result.activities = client.activities();
+    result.minSize = client.minSize();
+    result.maxSize = client.maxSize();
+    result.minimized = client.minimized();
+    result.onAllDesktops = client.onAllDesktops();
+    result.keepAbove = client.keepAbove();
+    result.specialWindow = client.specialWindow();
+    result.dialog = client.dialog();
+    result.resourceClass = client.resourceClass();
+    return result;
+}
+
+ClientSnapshotCache::ClientSnapshotCache(PlasmaApi::ClientHandle client)
+    : QObject()
+    , m_client(client)
+{
+    m_client.connectPropertyChanges(
+        {
+            "minSize",
+            "maxSize",
+            "keepAbove",
+            "specialWindow",
+            "dialog",
+            "resourceClass",
+        },
+        this,
+        "invalidate()");
+
+    m_client.connectPropertyChanges({"frameGeometry"}, this, "invalidateGeometry()");
+
+    // These decide, on which surfaces the client is shown
+    m_client.connectPropertyChanges(
+        {
+            "desktop",
+            "screen",
+            "activities",
+            "minimized",
+            "onAllDesktops",
+        },
+        this,
+        "onSurfacePropertyChanged()");
+
+    m_client.connectSignal("clientFinishUserMovedResized", this, "onUserMoveResizeFinished()");
+}
+
+const ClientSnapshot &ClientSnapshotCache::snapshot()
+{
+    if (!m_snapshot.has_value()) {
+        m_snapshot = ClientSnapshot::capture(m_client);
+        m_geometryOutdated = false;
+    } else if (m_geometryOutdated) {
+        m_snapshot->geometry = m_client.frameGeometry();
+        m_geometryOutdated = false;
+    }
+
+    return m_snapshot.value();
+}
+
+void ClientSnapshotCache::invalidate()
+{
+    m_snapshot.reset();
+}
+
+void ClientSnapshotCache::invalidateGeometry()
+{
+    m_geometryOutdated = true;
+}
+
+void ClientSnapshotCache::onSurfacePropertyChanged()
+{
+    invalidate();
+    Q_EMIT surfacesChanged();
+}
+
+void ClientSnapshotCache::onUserMoveResizeFinished()
+{
+    invalidateGeometry();
+    Q_EMIT userMoveResizeFinished();
+}
+}
@@ -0,0 +1,85 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <QByteArray>
+#include <QObject>
+#include <QRect>
+#include <QSize>
+#include <QStringList>
+
+#include <optional>
+
+#include "plasma-api/client_handle.hpp"
+
+namespace Bismuth
+{
+/**
+ * Copy of the client properties, that the engine makes its decisions on.
+ * Reading it does not cross the KWin boundary.
+ */
+struct ClientSnapshot {
+    QRect geometry{};
+    int desktop{};
+    int screen{};
+    QStringList activities{}; ///< Empty, when the client is on all activities
+    QSize minSize{};
+    QSize maxSize{};
+
+    bool minimized{};
+    bool onAllDesktops{};
+    bool keepAbove{};
+    bool specialWindow{};
+    bool dialog{};
+
+    QByteArray resourceClass{};
+
+    static ClientSnapshot capture(PlasmaApi::ClientHandle);
+};
+
+/**
+ * Keeps the snapshot of the client until any of the captured properties change
+ */
+class ClientSnapshotCache : public QObject
+{
+    Q_OBJECT
+public:
+    explicit ClientSnapshotCache(PlasmaApi::ClientHandle);
+
+    /**
+     * @returns the snapshot, capturing it first, if it was invalidated
+     */
+    const ClientSnapshot &snapshot();
+
+public Q_SLOTS:
+    void invalidate();
+
+    /**
+     * Read only the geometry again on the next access. It changes on every
+     * arrange, while the rest of the properties almost never do.
+     */
+    void invalidateGeometry();
+
+Q_SIGNALS:
+    /**
+     * Emitted, when the client might have moved to other surfaces, e.g. its
+     * desktop changed or it was minimized
+     */
+    void surfacesChanged();
+
+    /**
+     * Emitted, when the user finished moving or resizing the client
+     */
+    void userMoveResizeFinished();
+
+private Q_SLOTS:
+    void onSurfacePropertyChanged();
+    void onUserMoveResizeFinished();
+
+private:
+    PlasmaApi::ClientHandle m_client;
+    std::optional<ClientSnapshot> m_snapshot{};
+    bool m_geometryOutdated{};
+};
+}
@@ -3,13 +3,17 @@
 
 #include "engine.hpp"
 
+#include <QString>
+
 #include <algorithm>
 
 #include "config.hpp"
+#include "engine/client_snapshot.hpp"
 #include "engine/surface.hpp"
 #include "engine/window.hpp"
 #include "logger.hpp"
 #include "plasma-api/api.hpp"
+#include "state/state_store.hpp"
 
 namespace Bismuth
 {
@@ -18,13 +22,36 @@ Engine::Engine(PlasmaApi::Api &api, const Bismuth::Config &config)
     , m_windows(api.workspace())
     , m_activeLayouts(config)
     , m_plasmaApi(api)
+    , m_arrangeScheduler([this](const Surface &surface) {
+        arrangeWindowsOnSurface(surface);
+    })
 {
+    m_arrangeScheduler.setVisibilityFilter([this](const Surface &surface) {
+        return isVisible(surface);
+    });
+}
+
+void Engine::setStateStore(StateStore &store)
+{
+    m_activeLayouts.setStateStore(&store);
+
+    // Only the surfaces, that are already arranged, might get the other
+    // layouts. The pending arranges use the restored ones anyway, and there
+    // are none, unless the native backend is enabled.
+    auto arrangedSurfaces = std::vector<Surface>();
+    for (auto &[surface, _] : m_neighborIndices) {
+        arrangedSurfaces.push_back(surface);
+    }
+
+    arrangeWindowsOnSurfaces(arrangedSurfaces);
 }
 
-void Engine::addWindow(PlasmaApi::Client client)
+void Engine::addWindow(PlasmaApi::ClientHandle client)
 {
+    auto snapshot = ClientSnapshot::capture(client);
+
     // Don't manage special windows - docks, panels, etc.
-    if (client.specialWindow() || client.dialog()) {
+    if (snapshot.specialWindow || snapshot.dialog) {
         return;
     }
 
@@ -32,84 +59,181 @@ void Engine::addWindow(PlasmaApi::Client client)
     // definitely does not want to be tiled. This also might be a signal, that
     // the window is a launcher: KRunner, ULauncher, etc. This also keeps away
     // various application pop-ups
-    if (client.keepAbove()) {
+    if (snapshot.keepAbove) {
         return;
     }
 
+    // The window is created anew, if it is already managed
+    if (auto oldWindow = m_windows.find(client)) {
+        forgetWindow(*oldWindow);
+    }
+
     auto &newWindow = m_windows.add(client);
 
+    // Like in the TS backend, the window is placed relative to the one, that had the focus
+    auto focusedWindow = m_windows.activeWindow();
+    if (focusedWindow == &newWindow) {
+        focusedWindow = nullptr;
+    }
+
+    auto spawnLocation = m_config.newWindowSpawnLocation();
+    if (spawnLocation == QStringLiteral("master")) {
+        m_windows.pushToMaster(newWindow);
+    } else if (focusedWindow && spawnLocation == QStringLiteral("beforeFocused")) {
+        m_windows.moveBefore(newWindow, *focusedWindow);
+    } else if (focusedWindow && spawnLocation == QStringLiteral("afterFocused")) {
+        m_windows.moveAfter(newWindow, *focusedWindow);
+    }
+
     auto surfaces = newWindow.surfaces();
 
     arrangeWindowsOnSurfaces(surfaces);
 
     qDebug(Bi) << "New Window appears on" << surfaces.size() << "surfaces!";
 
-    // Bind events of this window
+    // The window is looked up again, since it might be gone by then
+    newWindow.onUserMoveResizeFinished([this, client]() {
+        if (auto window = m_windows.find(client)) {
+            adjustLayout(*window);
+        }
+    });
 }
 
-void Engine::removeWindow(PlasmaApi::Client client)
+void Engine::removeWindow(PlasmaApi::ClientHandle client)
 {
+    if (auto window = m_windows.find(client)) {
+        forgetWindow(*window);
+    }
+
     m_windows.remove(client);
 }
 
-void Engine::focusWindowByOrder(FocusOrder focusOrder)
+void Engine::windowActivated(PlasmaApi::ClientHandle client)
 {
-    auto windowsToChoseFrom = m_windows.visibleWindowsOn(activeSurface());
-
-    if (windowsToChoseFrom.empty()) {
-        return;
+    if (auto window = m_windows.find(client)) {
+        m_focusHistory.touch(*window, window->surfaces());
     }
+}
+
+void Engine::focusWindowByOrder(FocusOrder focusOrder)
+{
+    auto surface = activeSurface();
 
-    // If there is no current window, select the first one.
+    // If there is no current window, start from the last focused one or the first one.
     auto activeWindow = m_windows.activeWindow();
-    if (!activeWindow.has_value()) {
-        activeWindow = windowsToChoseFrom.front();
+    if (!activeWindow) {
+        activeWindow = m_focusHistory.lastFocused(surface);
+    }
+    if (!activeWindow) {
+        activeWindow = m_windows.firstWindowOn(surface);
     }
-
-    auto windowIter = std::find(windowsToChoseFrom.begin(), windowsToChoseFrom.end(), activeWindow.value());
 
     // If there is no windows to chose - do nothing
-    if (windowIter == windowsToChoseFrom.end()) {
+    if (!activeWindow) {
         return;
     }
 
-    // Select the next or the previous window circularly
-    if (focusOrder == FocusOrder::Next) {
-        windowIter++;
-        if (windowIter == windowsToChoseFrom.end()) {
-            windowIter = windowsToChoseFrom.begin();
-        }
-    } else if (focusOrder == FocusOrder::Previous) {
-        windowIter--;
-        if (windowIter < windowsToChoseFrom.begin()) {
-            windowIter = --windowsToChoseFrom.end();
-        }
+    // Select the next or the previous window circularly. There is none, if
+    // the window is not on the surface.
+    auto window = focusOrder == FocusOrder::Next ? m_windows.nextWindowOn(surface, *activeWindow)
+                                                 : m_windows.previousWindowOn(surface, *activeWindow);
+    if (!window) {
+        return;
     }
-    windowIter->activate();
-    qDebug() << "Activated window title:" << windowIter->caption();
+
+    window->activate();
+    qDebug() << "Activated window title:" << window->caption();
 }
 
 void Engine::focusWindowByDirection(FocusDirection direction)
 {
-    auto windowsToChoseFrom = m_windows.visibleWindowsOn(activeSurface());
+    auto surface = activeSurface();
+    auto windowsToChoseFrom = m_windows.visibleWindowsOn(surface);
 
     if (windowsToChoseFrom.empty()) {
         return;
     }
 
-    // If there is no current window, select the first one.
+    // If there is no current window, start from the last focused one or the first one.
     auto activeWindow = m_windows.activeWindow();
-    if (!activeWindow.has_value()) {
-        activeWindow = windowsToChoseFrom.front();
+    if (!activeWindow) {
+        activeWindow = m_focusHistory.lastFocused(surface);
+    }
+    if (!activeWindow) {
+        activeWindow = &windowsToChoseFrom.front();
     }
 
-    auto window = windowNeighbor(direction, activeWindow.value());
+    auto window = windowNeighbor(direction, *activeWindow);
 
-    if (window.has_value()) {
+    if (window) {
         window->activate();
     }
 }
 
+void Engine::swapWindowByDirection(FocusDirection direction)
+{
+    auto activeWindow = m_windows.activeWindow();
+    if (!activeWindow) {
+        return;
+    }
+
+    auto neighbor = windowNeighbor(direction, *activeWindow);
+    if (!neighbor) {
+        return;
+    }
+
+    m_windows.swap(*activeWindow, *neighbor);
+
+    // The windows might be on some other surfaces as well
+    arrangeWindowsOnSurfaces(activeWindow->surfaces());
+    arrangeWindowsOnSurfaces(neighbor->surfaces());
+}
+
+void Engine::pushWindowToMaster()
+{
+    auto activeWindow = m_windows.activeWindow();
+    if (!activeWindow) {
+        return;
+    }
+
+    m_windows.pushToMaster(*activeWindow);
+    arrangeWindowsOnSurfaces(activeWindow->surfaces());
+}
+
+void Engine::cycleLayout(int step)
+{
+    auto surface = activeSurface();
+    m_activeLayouts.cycleLayout(surface, step);
+    arrangeWindowsOnSurfaces({surface});
+}
+
+void Engine::toggleLayout(const QString &layoutId)
+{
+    auto surface = activeSurface();
+    m_activeLayouts.toggleLayout(surface, layoutId);
+    arrangeWindowsOnSurfaces({surface});
+}
+
+void Engine::updateSurfaces()
+{
+    m_windows.updateSurfaces();
+
+    // The surfaces, that are gone, are never shown again
+    auto surfaceExists = [this](const Surface &surface) {
+        return exists(surface);
+    };
+    m_arrangeScheduler.dropRemovedSurfaces(surfaceExists);
+    for (auto it = m_neighborIndices.begin(); it != m_neighborIndices.end();) {
+        if (surfaceExists(it->first)) {
+            ++it;
+        } else {
+            it = m_neighborIndices.erase(it);
+        }
+    }
+
+    arrangeWindowsOnAllSurfaces();
+}
+
 void Engine::arrangeWindowsOnAllSurfaces()
 {
     auto allSurfaces = [this]() -> std::vector<Surface> {
@@ -149,73 +273,100 @@ void Engine::arrangeWindowsOnVisibleSurfaces()
 
 void Engine::arrangeWindowsOnSurfaces(const std::vector<Surface> &surfaces)
 {
-    for (auto &surface : surfaces) {
-        arrangeWindowsOnSurface(surface);
+    m_arrangeScheduler.schedule(surfaces);
+}
+
+void Engine::arrangeStaleSurfaces()
+{
+    m_arrangeScheduler.scheduleStale();
+}
+
+ArrangeScheduler &Engine::arrangeScheduler()
+{
+    return m_arrangeScheduler;
+}
+
+Window *Engine::windowNeighbor(FocusDirection direction, const Window &basisWindow)
+{
+    // The index knows only the geometries of the finished arranges
+    if (m_arrangeScheduler.hasPendingArranges()) {
+        m_arrangeScheduler.flush();
+    }
+
+    auto it = m_neighborIndices.find(activeSurface());
+    if (it == m_neighborIndices.end()) {
+        return nullptr;
+    }
+
+    return it->second.neighbor(basisWindow.geometry(), direction, [this](const Window &window) {
+        return m_focusHistory.lastUse(window);
+    });
+}
+
+void Engine::forgetWindow(const Window &window)
+{
+    for (auto &[_, index] : m_neighborIndices) {
+        index.remove(window);
     }
+    m_focusHistory.remove(window);
 }
 
-std::optional<Window> Engine::windowNeighbor(FocusDirection direction, const Window &basisWindow)
-{
-    /**
-     * Tests if two ranges are overlapping
-     * @param min1 Range 1, begin
-     * @param max1 Range 1, end
-     * @param min2 Range 2, begin
-     * @param max2 Range 2, end
-     */
-    // auto overlap = [](int min1, int max1, int min2, int max2) {
-    //     return std::max(0, std::min(max1, max2) - std::max(min1, min2)) > 0;
-    // };
-    //
-    // auto getNeighborCandidates = [&](const Window &basis, FocusDirection direction) {
-    //     auto surfaceWindows = m_windows.visibleWindowsOn(activeSurface());
-    //
-    //     // Flipping all inputs' signs allows for the same logic to find closest windows in either direction
-    //     auto sign = direction == FocusDirection::Down || direction == FocusDirection::Right ? 1 : -1;
-    //
-    //     auto result = std::vector<Window>();
-    //     if (direction == FocusDirection::Up || direction == FocusDirection::Down) {
-    //         std::copy_if(surfaceWindows.cbegin(), surfaceWindows.cend(), result.begin(), [&](const Window &window) {
-    //             return window.geometry().y() * sign > basis.geometry().y() * sign
-    //                 && overlap(basis.geometry().x(), basis.geometry().right(), window.geometry().x(), window.geometry().right());
-    //         });
-    //     } else {
-    //         std::copy_if(surfaceWindows.cbegin(), surfaceWindows.cend(), result.begin(), [&](const Window window) {
-    //             return window.geometry().x() * sign > basis.geometry().x() * sign
-    //                 && overlap(basis.geometry().y(), basis.geometry().bottom(), window.geometry().y(), window.geometry().bottom());
-    //         });
-    //     }
-    //
-    //     return result;
-    // };
-    //
-    // auto neighborCandidates = getNeighborCandidates(basisWindow, direction);
-    //
-    // if (neighborCandidates.empty()) {
-    //     return {};
-    // }
-    //
-    // auto getClosestRelativWindowCorner = [&]() {
-    //     return std::reduce(neighborCandidates.cbegin(), neighborCandidates.cend(), [&](int prevValue, const Window &window) {
-    //         if (direction == FocusDirection::Up) {
-    //             return std::max(window.geometry().bottom(), prevValue);
-    //         } else if (direction == FocusDirection::Down) {
-    //             return std::min(window.geometry().y(), prevValue);
-    //         } else if (direction == FocusDirection::Left) {
-    //             return std::max(window.geometry().right(), prevValue);
-    //         } else {
-    //             return std::min(window.geometry().x(), prevValue);
-    //         }
-    //     });
-    // };
-    // auto closestWindowCorner = getClosestRelativWindowCorner(neighborCandidates, dir);
-
-    // auto closestWindows = this.getClosestRelativeWindow(neighborCandidates, dir, closestWindowCorner);
-
-    // return closestWindows.front();
-
-    // TODO Implement
-    return {};
+void Engine::adjustLayout(Window &window)
+{
+    if (window.mode() != Window::Mode::Tiled) {
+        return;
+    }
+
+    auto adjustedSurfaces = std::vector<Surface>();
+
+    for (auto &surface : window.surfaces()) {
+        if (!isVisible(surface)) {
+            continue;
+        }
+
+        // The index has the geometry, that the window got from the layout
+        auto indexIt = m_neighborIndices.find(surface);
+        if (indexIt == m_neighborIndices.end()) {
+            continue;
+        }
+        auto oldGeometry = indexIt->second.geometry(window);
+        if (!oldGeometry) {
+            continue;
+        }
+
+        auto newGeometry = window.geometry();
+        adjustedSurfaces.push_back(surface);
+
+        // The window was only moved, so it just goes back to its place
+        if (oldGeometry->size() == newGeometry.size()) {
+            continue;
+        }
+
+        auto tiledWindows = std::vector<Window *>();
+        for (auto &visibleWindow : m_windows.visibleWindowsOn(surface)) {
+            if (visibleWindow.mode() == Window::Mode::Tiled) {
+                tiledWindows.push_back(&visibleWindow);
+            }
+        }
+
+        auto basisIt = std::find(tiledWindows.cbegin(), tiledWindows.cend(), &window);
+        if (basisIt == tiledWindows.cend()) {
+            continue;
+        }
+
+        // The windows don't have their own weights yet, so they are all equal
+        auto weights = std::vector<double>(tiledWindows.size(), 1.0);
+
+        auto &layout = m_activeLayouts.layoutOnSurface(surface);
+        layout.adjust(layout.tilingArea(workingArea(surface)),
+                      weights,
+                      static_cast<std::size_t>(basisIt - tiledWindows.cbegin()),
+                      RectDelta::fromRects(*oldGeometry, newGeometry));
+
+        m_activeLayouts.saveLayoutState(surface);
+    }
+
+    arrangeWindowsOnSurfaces(adjustedSurfaces);
 }
 
 Surface Engine::activeSurface() const
@@ -227,6 +378,22 @@ Surface Engine::activeSurface() const
     return Surface(currentDesktop, activeScreen, currentActivity);
 }
 
+bool Engine::isVisible(const Surface &surface) const
+{
+    auto &workspace = m_plasmaApi.workspace();
+
+    return surface.desktop() == workspace.currentDesktop() && surface.activity() == workspace.currentActivity()
+        && surface.screen() < workspace.numScreens();
+}
+
+bool Engine::exists(const Surface &surface) const
+{
+    auto &workspace = m_plasmaApi.workspace();
+
+    return surface.desktop() <= workspace.desktops() && surface.screen() < workspace.numScreens()
+        && workspace.activities().contains(surface.activity());
+}
+
 void Engine::arrangeWindowsOnSurface(const Surface &surface)
 {
     auto &layout = m_activeLayouts.layoutOnSurface(surface);
@@ -236,6 +403,9 @@ void Engine::arrangeWindowsOnSurface(const Surface &surface)
     auto windowsThatCanBeTiled = visibleWindows; // TODO: Filter windows
 
     layout.apply(tilingArea, windowsThatCanBeTiled);
+
+    // KWin might have constrained the windows, so the index reads their actual geometries
+    m_neighborIndices[surface].commit(windowsThatCanBeTiled);
 }
 
 QRect Engine::workingArea(const Surface &surface) const
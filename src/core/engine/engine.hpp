@@ -3,26 +3,70 @@
 
 #pragma once
 
+#include <map>
+
+#include "engine/arrange_scheduler.hpp"
+#include "engine/focus_history.hpp"
 #include "engine/layout/layout_list.hpp"
+#include "engine/neighbor_index.hpp"
 #include "engine/surface.hpp"
 #include "plasma-api/api.hpp"
-#include "plasma-api/client.hpp"
+#include "plasma-api/client_handle.hpp"
 #include "windows_list.hpp"
 
 namespace Bismuth
 {
+class StateStore;
+
 struct Engine {
     enum class FocusOrder { Next, Previous };
-    enum class FocusDirection { Up, Down, Right, Left };
+    using FocusDirection = Direction;
 
     Engine(PlasmaApi::Api &, const Bismuth::Config &);
 
-    void addWindow(PlasmaApi::Client);
-    void removeWindow(PlasmaApi::Client);
+    /**
+     * Keep the layouts of the surfaces in the @p store between the sessions
+     * and restore the ones, that were kept there
+     */
+    void setStateStore(StateStore &store);
+
+    void addWindow(PlasmaApi::ClientHandle);
+    void removeWindow(PlasmaApi::ClientHandle);
+
+    /**
+     * Remember the window of the @p client as the most recently focused one
+     */
+    void windowActivated(PlasmaApi::ClientHandle client);
 
     void focusWindowByOrder(FocusOrder);
     void focusWindowByDirection(FocusDirection);
 
+    /**
+     * Swap the active window with its neighbor in the @p direction
+     */
+    void swapWindowByDirection(FocusDirection direction);
+
+    /**
+     * Put the active window first in the tiling order
+     */
+    void pushWindowToMaster();
+
+    /**
+     * Switch the active surface to the next enabled layout or to the previous
+     * one for the negative @p step
+     */
+    void cycleLayout(int step);
+
+    /**
+     * Switch the active surface to the layout with the @p layoutId or back to
+     * the previous one, if it is current already
+     */
+    void toggleLayout(const QString &layoutId);
+
+    /**
+     * The arrange functions only schedule the arranges. They are done all
+     * together, once the current event is processed.
+     */
     void arrangeWindowsOnAllSurfaces();
 
     /**
@@ -32,9 +76,44 @@ struct Engine {
 
     void arrangeWindowsOnSurfaces(const std::vector<Surface> &);
 
+    /**
+     * Arrange the surfaces, that were changed while hidden and are visible
+     * now, e.g. after the current desktop or activity changed
+     */
+    void arrangeStaleSurfaces();
+
+    /**
+     * Find the surfaces of all the windows again and arrange them. Needed,
+     * when the desktops, the activities or the screens are added or removed.
+     */
+    void updateSurfaces();
+
+    ArrangeScheduler &arrangeScheduler();
+
 private:
-    std::optional<Window> windowNeighbor(FocusDirection, const Window &);
+    /**
+     * @returns the neighbor of the @p basisWindow on the active surface or nullptr
+     */
+    Window *windowNeighbor(FocusDirection direction, const Window &basisWindow);
+
+    /**
+     * Drop the references to the @p window, before it is destroyed
+     */
+    void forgetWindow(const Window &window);
+
+    /**
+     * Update the layouts of the surfaces, where the user resized the tiled
+     * @p window, like adjustLayout of the TS backend
+     */
+    void adjustLayout(Window &window);
+
     Surface activeSurface() const;
+    bool isVisible(const Surface &) const;
+
+    /**
+     * @returns whether the screen, the desktop and the activity of the surface are still there
+     */
+    bool exists(const Surface &) const;
 
     void arrangeWindowsOnSurface(const Surface &);
     QRect workingArea(const Surface &surface) const;
@@ -43,5 +122,10 @@ private:
     WindowsList m_windows;
     LayoutList m_activeLayouts;
     PlasmaApi::Api &m_plasmaApi;
+    ArrangeScheduler m_arrangeScheduler;
+
+    /// Tiled windows with the geometries, they got on the last arrange
+    std::map<Surface, NeighborIndex> m_neighborIndices{};
+    FocusHistory m_focusHistory{};
 };
 }
@@ -0,0 +1,103 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include "focus_history.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+namespace Bismuth
+{
+void FocusHistory::touch(Window &window, const std::vector<Surface> &surfaces)
+{
+    auto &entry = m_entries[&window];
+    entry.lastUse = ++m_useCounter;
+
+    auto positions = std::vector<std::pair<Surface, Order::iterator>>();
+    positions.reserve(surfaces.size());
+
+    for (auto &surface : surfaces) {
+        auto &order = m_surfaceOrders[surface];
+
+        auto known = std::find_if(entry.positions.begin(), entry.positions.end(), [&surface](const auto &position) {
+            return position.first == surface;
+        });
+
+        if (known != entry.positions.end()) {
+            // Moving the node keeps the iterator valid
+            order.splice(order.begin(), order, known->second);
+            entry.positions.erase(known);
+        } else {
+            order.push_front(&window);
+        }
+
+        positions.emplace_back(surface, order.begin());
+    }
+
+    // Whatever is left, are the surfaces the window is not on anymore
+    for (auto &[surface, position] : entry.positions) {
+        removeFromSurface(surface, position);
+    }
+
+    entry.positions = std::move(positions);
+}
+
+void FocusHistory::remove(const Window &window)
+{
+    auto it = m_entries.find(&window);
+    if (it == m_entries.end()) {
+        return;
+    }
+
+    for (auto &[surface, position] : it->second.positions) {
+        removeFromSurface(surface, position);
+    }
+    m_entries.erase(it);
+}
+
+Window *FocusHistory::lastFocused(const Surface &surface) const
+{
+    auto it = m_surfaceOrders.find(surface);
+    if (it == m_surfaceOrders.end() || it->second.empty()) {
+        return nullptr;
+    }
+
+    return it->second.front();
+}
+
+Window *FocusHistory::previous(const Surface &surface, const Window &window) const
+{
+    auto entryIt = m_entries.find(&window);
+    if (entryIt == m_entries.end()) {
+        return nullptr;
+    }
+
+    auto &positions = entryIt->second.positions;
+    auto known = std::find_if(positions.begin(), positions.end(), [&surface](const auto &position) {
+        return position.first == surface;
+    });
+    if (known == positions.end()) {
+        return nullptr;
+    }
+
+    auto &order = m_surfaceOrders.at(surface);
+    auto next = std::next(known->second);
+    return next != order.end() ? *next : nullptr;
+}
+
+quint64 FocusHistory::lastUse(const Window &window) const
+{
+    auto it = m_entries.find(&window);
+    return it != m_entries.end() ? it->second.lastUse : 0;
+}
+
+void FocusHistory::removeFromSurface(const Surface &surface, Order::iterator position)
+{
+    auto orderIt = m_surfaceOrders.find(surface);
+    orderIt->second.erase(position);
+
+    if (orderIt->second.empty()) {
+        m_surfaceOrders.erase(orderIt);
+    }
+}
+}
@@ -0,0 +1,70 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <QtGlobal>
+
+#include <list>
+#include <map>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "engine/surface.hpp"
+#include "engine/window.hpp"
+
+namespace Bismuth
+{
+/**
+ * Windows of each surface, from the most recently focused to the least
+ * recently focused one. Every window remembers its places in the lists, so
+ * that it is moved or removed without scanning them. Only the surfaces of the
+ * window itself are looked through to find its place on a surface.
+ *
+ * Windows are referred to by pointers, so they must be removed from the
+ * history before they are destroyed.
+ */
+class FocusHistory
+{
+public:
+    /**
+     * Make the @p window the most recently focused one on the @p surfaces. It
+     * is dropped from the surfaces, it was focused on before, but is not on anymore.
+     */
+    void touch(Window &window, const std::vector<Surface> &surfaces);
+
+    void remove(const Window &window);
+
+    /**
+     * @returns the most recently focused window on the @p surface or nullptr
+     */
+    Window *lastFocused(const Surface &surface) const;
+
+    /**
+     * @returns the window, that was focused on the @p surface right before
+     * the @p window, or nullptr
+     */
+    Window *previous(const Surface &surface, const Window &window) const;
+
+    /**
+     * The bigger the value, the more recently the @p window was focused. Zero
+     * for the windows, that were never focused, like in the TS backend.
+     */
+    quint64 lastUse(const Window &window) const;
+
+private:
+    using Order = std::list<Window *>;
+
+    struct Entry {
+        quint64 lastUse{};
+        std::vector<std::pair<Surface, Order::iterator>> positions{};
+    };
+
+    void removeFromSurface(const Surface &surface, Order::iterator position);
+
+    std::map<Surface, Order> m_surfaceOrders{};
+    std::unordered_map<const Window *, Entry> m_entries{};
+    quint64 m_useCounter{};
+};
+}
@@ -3,6 +3,8 @@
 
 #include "layout.hpp"
 
+#include "state/layout_state.hpp"
+
 namespace Bismuth
 {
 Layout::Layout(const Bismuth::Config &config)
@@ -10,6 +12,18 @@ Layout::Layout(const Bismuth::Config &config)
 {
 }
 
+void Layout::adjust(QRect, Span<double>, std::size_t, RectDelta)
+{
+}
+
+void Layout::saveState(LayoutState &) const
+{
+}
+
+void Layout::loadState(const LayoutState &)
+{
+}
+
 QRect Layout::tilingArea(QRect workingArea) const
 {
     auto marginLeft = m_config.screenGapLeft();
@@ -19,4 +33,12 @@ QRect Layout::tilingArea(QRect workingArea) const
 
     return workingArea.adjusted(+marginLeft, +marginTop, -marginRight, -marginBottom);
 }
+
+void Layout::tile(WindowsView windows, Span<const QRect> geometries)
+{
+    for (auto i = std::size_t(0); i < geometries.size(); i++) {
+        windows[i].setMode(Window::Mode::Tiled);
+        windows[i].setGeometry(geometries[i]);
+    }
+}
 }
@@ -4,22 +4,49 @@
 #pragma once
 
 #include <QRect>
+#include <QString>
 
+#include <cstddef>
 #include <vector>
 
 #include "config.hpp"
+#include "engine/layout/layout_utils.hpp"
+#include "engine/layout/span.hpp"
 #include "engine/window.hpp"
+#include "engine/windows_view.hpp"
 
 namespace Bismuth
 {
+struct LayoutState;
+
 struct Layout {
     Layout(const Bismuth::Config &);
+    virtual ~Layout() = default;
+
+    /**
+     * Id of the layout, the same as the classID of the TS backend, e.g. "TileLayout"
+     */
+    virtual QString id() const = 0;
 
     /**
      * Apply layout for the @p windows on tiling @p area. Method changes the
      * geometry of the windows to match the particular layout.
      */
-    virtual void apply(QRect area, std::vector<Window> &windows) const = 0;
+    virtual void apply(QRect area, WindowsView windows) const = 0;
+
+    /**
+     * Update the layout and the @p weights of the windows, after the @p basis
+     * window was resized by the @p delta. Does nothing by default.
+     */
+    virtual void adjust(QRect area, Span<double> weights, std::size_t basis, RectDelta delta);
+
+    /**
+     * Write the parameters, that are kept between the sessions, into the
+     * @p state of the surface. Like in the TS backend, all the layouts of a
+     * surface share a single state.
+     */
+    virtual void saveState(LayoutState &state) const;
+    virtual void loadState(const LayoutState &state);
 
     /**
      * Get the area on which tiled windows could be placed given the general @p workingArea
@@ -27,6 +54,11 @@ struct Layout {
     virtual QRect tilingArea(QRect workingArea) const;
 
 protected:
+    /**
+     * Tile the @p windows and give them the @p geometries in the same order
+     */
+    static void tile(WindowsView windows, Span<const QRect> geometries);
+
     const Bismuth::Config &m_config;
 };
 }
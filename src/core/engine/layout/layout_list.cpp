@@ -3,13 +3,16 @@
 
 #include "layout_list.hpp"
 
-#include <functional>
 #include <memory>
 
 #include "engine/layout/layout.hpp"
 #include "engine/layout/monocle.hpp"
-#include "engine/layout/stacked.hpp"
+#include "engine/layout/quarter.hpp"
+#include "engine/layout/spiral.hpp"
+#include "engine/layout/three_column.hpp"
+#include "engine/layout/tile.hpp"
 #include "engine/surface.hpp"
+#include "state/state_store.hpp"
 
 namespace Bismuth
 {
@@ -19,15 +22,199 @@ LayoutList::LayoutList(const Bismuth::Config &config)
 {
 }
 
-const Layout &LayoutList::layoutOnSurface(const Surface &surface)
+void LayoutList::setStateStore(StateStore *store)
 {
-    auto it = m_layouts.find(surface);
+    m_stateStore = store;
+    if (!m_stateStore) {
+        return;
+    }
+
+    for (auto &[surface, surfaceEntry] : m_entries) {
+        loadStoredState(surface, surfaceEntry);
+    }
+}
+
+void LayoutList::saveLayoutState(const Surface &surface)
+{
+    if (m_stateStore) {
+        m_stateStore->setLayoutState(stateId(surface), layoutState(surface));
+    }
+}
+
+Layout &LayoutList::layoutOnSurface(const Surface &surface)
+{
+    auto &surfaceEntry = entry(surface);
+    return *loadLayout(surfaceEntry, surfaceEntry.currentId);
+}
+
+Layout &LayoutList::cycleLayout(const Surface &surface, int step)
+{
+    auto &surfaceEntry = entry(surface);
+    auto order = layoutOrder();
+    auto count = order.size();
+
+    // After a layout, that is not in the order, cycling starts from the first one
+    auto index = surfaceEntry.currentIndex ? ((*surfaceEntry.currentIndex + step) % count + count) % count : 0;
+
+    switchLayout(surfaceEntry, order[index]);
+    saveLayoutState(surface);
+    return *loadLayout(surfaceEntry, surfaceEntry.currentId);
+}
+
+Layout &LayoutList::toggleLayout(const Surface &surface, const QString &layoutId)
+{
+    auto &surfaceEntry = entry(surface);
+
+    if (loadLayout(surfaceEntry, layoutId)) {
+        // Toggle if requested, set otherwise
+        switchLayout(surfaceEntry, surfaceEntry.currentId == layoutId ? surfaceEntry.previousId : layoutId);
+        saveLayoutState(surface);
+    }
 
-    if (it == m_layouts.end()) {
-        auto [it2, _] = m_layouts.insert_or_assign(surface, std::make_unique<Monocle>(m_config));
+    return *loadLayout(surfaceEntry, surfaceEntry.currentId);
+}
+
+LayoutState LayoutList::layoutState(const Surface &surface)
+{
+    auto &surfaceEntry = entry(surface);
+
+    auto result = surfaceEntry.state;
+    result.classId = surfaceEntry.currentId;
+    loadLayout(surfaceEntry, surfaceEntry.currentId)->saveState(result);
+    return result;
+}
+
+void LayoutList::restoreLayoutState(const Surface &surface, const LayoutState &state)
+{
+    restoreEntry(entry(surface), state);
+}
+
+void LayoutList::restoreEntry(Entry &surfaceEntry, const LayoutState &state)
+{
+    if (loadLayout(surfaceEntry, state.classId)) {
+        switchLayout(surfaceEntry, state.classId);
+        surfaceEntry.previousId = surfaceEntry.currentId;
+    }
+
+    // Replaces whatever the switch saved
+    surfaceEntry.state = state;
+    for (auto &[_, layout] : surfaceEntry.layouts) {
+        layout->loadState(state);
+    }
+}
+
+QStringList LayoutList::layoutOrder() const
+{
+    auto result = QStringList();
+
+    // The same order as the one of the TS backend without the layouts, that are not there yet
+    if (m_config.enableTileLayout()) {
+        result.append(QStringLiteral("TileLayout"));
+    }
+    if (m_config.enableMonocleLayout()) {
+        result.append(QStringLiteral("MonocleLayout"));
+    }
+    if (m_config.enableThreeColumnLayout()) {
+        result.append(QStringLiteral("ThreeColumnLayout"));
+    }
+    if (m_config.enableSpiralLayout()) {
+        result.append(QStringLiteral("SpiralLayout"));
+    }
+    if (m_config.enableQuarterLayout()) {
+        result.append(QStringLiteral("QuarterLayout"));
+    }
+
+    if (result.isEmpty()) {
+        result.append(QStringLiteral("TileLayout"));
+    }
+
+    return result;
+}
+
+std::unique_ptr<Layout> LayoutList::createLayout(const QString &id, const Bismuth::Config &config)
+{
+    if (id == QStringLiteral("TileLayout")) {
+        return std::make_unique<Tile>(config);
+    } else if (id == QStringLiteral("MonocleLayout")) {
+        return std::make_unique<Monocle>(config);
+    } else if (id == QStringLiteral("ThreeColumnLayout")) {
+        return std::make_unique<ThreeColumn>(config);
+    } else if (id == QStringLiteral("SpiralLayout")) {
+        return std::make_unique<Spiral>(config);
+    } else if (id == QStringLiteral("QuarterLayout")) {
+        return std::make_unique<Quarter>(config);
+    }
+
+    return nullptr;
+}
+
+LayoutList::Entry &LayoutList::entry(const Surface &surface)
+{
+    auto it = m_entries.find(surface);
+
+    if (it == m_entries.end()) {
+        auto newEntry = Entry();
+        newEntry.currentId = layoutOrder().front();
+        newEntry.previousId = newEntry.currentId;
+        newEntry.currentIndex = 0;
+
+        auto [it2, _] = m_entries.insert_or_assign(surface, std::move(newEntry));
         it = it2;
+
+        // The states of the surfaces are loaded lazily, like their layouts
+        if (m_stateStore) {
+            loadStoredState(surface, it->second);
+        }
     }
 
-    return *it->second;
+    return it->second;
+}
+
+void LayoutList::loadStoredState(const Surface &surface, Entry &surfaceEntry)
+{
+    auto state = m_stateStore->layoutState(stateId(surface));
+
+    // Nothing was saved for the surface yet
+    if (state.classId.isEmpty()) {
+        return;
+    }
+
+    restoreEntry(surfaceEntry, state);
+}
+
+QString LayoutList::stateId(const Surface &surface)
+{
+    return QStringLiteral("%1:%2:%3").arg(surface.activity()).arg(surface.desktop()).arg(surface.screen());
+}
+
+Layout *LayoutList::loadLayout(Entry &surfaceEntry, const QString &id)
+{
+    auto it = surfaceEntry.layouts.find(id);
+
+    if (it == surfaceEntry.layouts.end()) {
+        auto layout = createLayout(id, m_config);
+        if (!layout) {
+            return nullptr;
+        }
+
+        // Like in the TS backend, the layouts get their parameters on creation
+        layout->loadState(surfaceEntry.state);
+
+        auto [it2, _] = surfaceEntry.layouts.insert_or_assign(id, std::move(layout));
+        it = it2;
+    }
+
+    return it->second.get();
+}
+
+void LayoutList::switchLayout(Entry &surfaceEntry, QString id)
+{
+    loadLayout(surfaceEntry, surfaceEntry.currentId)->saveState(surfaceEntry.state);
+
+    surfaceEntry.previousId = surfaceEntry.currentId;
+    surfaceEntry.currentId = id;
+
+    auto index = layoutOrder().indexOf(id);
+    surfaceEntry.currentIndex = index >= 0 ? std::optional<int>(index) : std::nullopt;
 }
 }
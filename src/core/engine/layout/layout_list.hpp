@@ -3,23 +3,126 @@
 
 #pragma once
 
-#include <functional>
+#include <QString>
+#include <QStringList>
+
 #include <map>
 #include <memory>
+#include <optional>
 
 #include "config.hpp"
 #include "engine/surface.hpp"
 #include "layout.hpp"
+#include "state/layout_state.hpp"
 
 namespace Bismuth
 {
+class StateStore;
+
+/**
+ * Layouts of every surface. The same as the LayoutStore of the TS backend:
+ * every surface has its own instances of the layouts, one of which is the
+ * current one.
+ */
 struct LayoutList {
     LayoutList(const Bismuth::Config &);
 
-    const Layout &layoutOnSurface(const Surface &);
+    /**
+     * Keep the layout states of the surfaces in the @p store. The surfaces,
+     * that are already there, are restored from it at once, the rest - when
+     * they are used for the first time.
+     */
+    void setStateStore(StateStore *store);
+
+    /**
+     * Put the current layout state of the @p surface into the state store, if
+     * there is one. Needed after the parameters of the current layout change.
+     */
+    void saveLayoutState(const Surface &);
+
+    /**
+     * The current layout of the @p surface. At first it is the first enabled one.
+     */
+    Layout &layoutOnSurface(const Surface &);
+
+    /**
+     * Switch the @p surface to the next enabled layout or to the previous one
+     * for the negative @p step
+     * @returns the new current layout
+     */
+    Layout &cycleLayout(const Surface &, int step);
+
+    /**
+     * Switch the @p surface to the layout with the @p layoutId or back to the
+     * previous one, if it is the current layout already. Unknown layouts are
+     * ignored.
+     * @returns the new current layout
+     */
+    Layout &toggleLayout(const Surface &, const QString &layoutId);
+
+    /**
+     * State of the layouts of the @p surface to keep between the sessions.
+     * The layouts share it, so the parameters of the current layout take
+     * precedence over the ones saved, when the other layouts were current.
+     */
+    LayoutState layoutState(const Surface &);
+
+    /**
+     * Make the layout from the @p state current on the @p surface and load
+     * the parameters of the layouts from it
+     */
+    void restoreLayoutState(const Surface &, const LayoutState &state);
+
+    /**
+     * Ids of the layouts enabled in the config in the cycling order. Tile is
+     * used, if none of them are enabled.
+     */
+    QStringList layoutOrder() const;
+
+    /**
+     * @returns the layout with the @p id or nullptr, if there is no such layout
+     */
+    static std::unique_ptr<Layout> createLayout(const QString &id, const Bismuth::Config &);
 
 private:
-    std::map<Surface, std::unique_ptr<Layout>> m_layouts{};
+    struct Entry {
+        std::map<QString, std::unique_ptr<Layout>> layouts{};
+        QString currentId{};
+        QString previousId{};
+        std::optional<int> currentIndex{}; ///< Index in the layout order, if the current layout is there
+        LayoutState state{}; ///< Saved, when the current layout changes
+    };
+
+    Entry &entry(const Surface &);
+
+    void restoreEntry(Entry &, const LayoutState &state);
+
+    /**
+     * Restore the @p surface from the state store, if it has its state
+     */
+    void loadStoredState(const Surface &, Entry &);
+
+    /**
+     * Id of the state of the @p surface in the state store. Unlike the ones of
+     * the TS backend, which are per screen and group, it is per surface.
+     */
+    static QString stateId(const Surface &);
+
+    /**
+     * @returns the layout with the @p id, which is created on the first use,
+     * or nullptr, if there is no such layout
+     */
+    Layout *loadLayout(Entry &, const QString &id);
+
+    /**
+     * Make the layout with the @p id current, saving the parameters of the
+     * previous one. The @p id is copied, since it might be the previous id,
+     * that changes here.
+     */
+    void switchLayout(Entry &, QString id);
+
+    std::map<Surface, Entry> m_entries{};
     const Bismuth::Config &m_config;
+    StateStore *m_stateStore{};
 };
 }
@@ -0,0 +1,42 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include "layout_parts.hpp"
+
+namespace Bismuth::LayoutParts
+{
+void Fill::apply(QRect area, Span<const double>, Span<QRect> out) const
+{
+    for (auto &geometry : out) {
+        geometry = area;
+    }
+}
+
+RectDelta Fill::adjust(QRect, Span<double>, std::size_t, RectDelta delta)
+{
+    return delta;
+}
+
+void Stack::apply(QRect area, Span<const double> weights, Span<QRect> out) const
+{
+    LayoutUtils::splitAreaWeighted(area, weights, gap, false, out);
+}
+
+RectDelta Stack::adjust(QRect area, Span<double> weights, std::size_t basis, RectDelta delta)
+{
+    auto count = weights.size();
+    if (basis >= count) {
+        return delta;
+    }
+
+    LayoutUtils::adjustAreaWeights(area, weights, gap, basis, delta, false);
+
+    // The average weight stays one
+    for (auto &weight : weights) {
+        weight *= count;
+    }
+
+    // Only the top and the bottom of the stack have neighbors outside of it
+    return RectDelta{delta.east, delta.west, basis == count - 1 ? delta.south : 0, basis == 0 ? delta.north : 0};
+}
+}
@@ -0,0 +1,244 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <QRect>
+
+#include <cstddef>
+
+#include "engine/layout/layout_utils.hpp"
+#include "engine/layout/span.hpp"
+
+/**
+ * Building blocks of the layouts, that are composed at compile time, e.g.
+ * Rotate<HalfSplit<Stack, Stack>>. They mirror the layout parts of the TS
+ * backend and produce the same geometries.
+ *
+ * Every part provides:
+ *  - apply(area, weights, out), that writes the geometries of out.size()
+ *    windows into @p out. The weights of the windows may be empty, in which
+ *    case all the windows weigh the same;
+ *  - adjust(area, weights, basis, delta), that updates the part after the user
+ *    resized the @p basis window by the @p delta and returns the part of the
+ *    delta, that the enclosing part has to handle.
+ */
+namespace Bismuth::LayoutParts
+{
+/**
+ * Every window takes the whole area
+ */
+struct Fill {
+    void apply(QRect area, Span<const double> weights, Span<QRect> out) const;
+    RectDelta adjust(QRect area, Span<double> weights, std::size_t basis, RectDelta delta);
+};
+
+/**
+ * The windows are placed one on top of the other
+ */
+struct Stack {
+    int gap{};
+
+    void apply(QRect area, Span<const double> weights, Span<QRect> out) const;
+    RectDelta adjust(QRect area, Span<double> weights, std::size_t basis, RectDelta delta);
+};
+
+/**
+ * The first primarySize windows are placed by the Primary part and the rest of
+ * them by the Secondary part beside it.
+ *
+ *    | angle | direction  | primary |
+ *    | ----- | ---------- | ------- |
+ *    |     0 | horizontal | left    |
+ *    |    90 | vertical   | top     |
+ *    |   180 | horizontal | right   |
+ *    |   270 | vertical   | bottom  |
+ */
+template<typename Primary, typename Secondary>
+struct HalfSplit {
+    Primary primary{};
+    Secondary secondary{};
+
+    int angle{};
+    int gap{};
+    std::size_t primarySize{1};
+    double ratio{0.5}; ///< Share of the area taken by the primary part
+
+    void apply(QRect area, Span<const double> weights, Span<QRect> out) const
+    {
+        auto count = out.size();
+        if (count <= primarySize) {
+            primary.apply(area, weights, out);
+            return;
+        } else if (primarySize == 0) {
+            secondary.apply(area, weights, out);
+            return;
+        }
+
+        auto primaryRatio = reversed() ? 1 - ratio : ratio;
+        double halfWeights[] = {primaryRatio, 1 - primaryRatio};
+        QRect halves[2];
+        LayoutUtils::splitAreaWeighted(area, halfWeights, gap, horizontal(), halves);
+
+        primary.apply(reversed() ? halves[1] : halves[0], primaryPart(weights), out.first(primarySize));
+        secondary.apply(reversed() ? halves[0] : halves[1], secondaryPart(weights), out.subspan(primarySize));
+    }
+
+    RectDelta adjust(QRect area, Span<double> weights, std::size_t basis, RectDelta delta)
+    {
+        auto count = weights.size();
+        if (basis >= count) {
+            return delta;
+        }
+
+        if (count <= primarySize) {
+            return primary.adjust(area, weights, basis, delta);
+        } else if (primarySize == 0) {
+            return secondary.adjust(area, weights, basis, delta);
+        }
+
+        // Which part to adjust: 0 is the primary one, 1 is the secondary one
+        auto target = basis < primarySize ? 0 : 1;
+
+        if (target == 0) {
+            delta = primary.adjust(area, primaryPart(weights), basis, delta);
+        } else {
+            delta = secondary.adjust(area, secondaryPart(weights), basis - primarySize, delta);
+        }
+
+        ratio = LayoutUtils::adjustAreaHalfWeights(area, reversed() ? 1 - ratio : ratio, gap, reversed() ? 1 - target : target, delta, horizontal());
+        if (reversed()) {
+            ratio = 1 - ratio;
+        }
+
+        // The split line is handled here, the rest of the delta goes up
+        switch (angle) {
+        case 0:
+            (target == 0 ? delta.east : delta.west) = 0;
+            break;
+        case 90:
+            (target == 0 ? delta.south : delta.north) = 0;
+            break;
+        case 180:
+            (target == 0 ? delta.west : delta.east) = 0;
+            break;
+        case 270:
+            (target == 0 ? delta.north : delta.south) = 0;
+            break;
+        default:
+            break;
+        }
+        return delta;
+    }
+
+private:
+    bool horizontal() const
+    {
+        return angle == 0 || angle == 180;
+    }
+
+    bool reversed() const
+    {
+        return angle == 180 || angle == 270;
+    }
+
+    template<typename T>
+    Span<T> primaryPart(Span<T> weights) const
+    {
+        return weights.empty() ? weights : weights.first(primarySize);
+    }
+
+    template<typename T>
+    Span<T> secondaryPart(Span<T> weights) const
+    {
+        return weights.empty() ? weights : weights.subspan(primarySize);
+    }
+};
+
+/**
+ * The Inner part rotated by the angle: 0, 90, 180 or 270 degrees
+ */
+template<typename Inner>
+struct Rotate {
+    Inner inner{};
+    int angle{};
+
+    void apply(QRect area, Span<const double> weights, Span<QRect> out) const
+    {
+        auto innerArea = transposed() ? transpose(area) : area;
+
+        inner.apply(innerArea, weights, out);
+
+        for (auto &geometry : out) {
+            switch (angle) {
+            case 90:
+                geometry = transpose(geometry);
+                break;
+            case 180: {
+                // Mirror horizontally
+                auto newX = area.x() + area.width() - (geometry.x() - area.x() + geometry.width());
+                geometry.moveLeft(newX);
+                break;
+            }
+            case 270: {
+                // Mirror along the inner area and transpose
+                auto newY = innerArea.x() + innerArea.width() - (geometry.x() - innerArea.x() + geometry.width());
+                geometry = QRect(geometry.y(), newY, geometry.height(), geometry.width());
+                break;
+            }
+            default:
+                break;
+            }
+        }
+    }
+
+    RectDelta adjust(QRect area, Span<double> weights, std::size_t basis, RectDelta delta)
+    {
+        if (transposed()) {
+            area = transpose(area);
+        }
+        delta = rotated(delta);
+
+        delta = inner.adjust(area, weights, basis, delta);
+
+        return rotated(delta);
+    }
+
+    /**
+     * Rotate by another 90 degrees in the positive or the negative direction
+     */
+    void rotate(int amount)
+    {
+        angle = ((angle + amount) % 360 + 360) % 360;
+    }
+
+private:
+    bool transposed() const
+    {
+        return angle == 90 || angle == 270;
+    }
+
+    static QRect transpose(QRect rect)
+    {
+        return QRect(rect.y(), rect.x(), rect.height(), rect.width());
+    }
+
+    /**
+     * Turn the delta the same way the TS backend does. The same mapping is
+     * used both ways.
+     */
+    RectDelta rotated(RectDelta delta) const
+    {
+        switch (angle) {
+        case 90:
+            return RectDelta{delta.south, delta.north, delta.east, delta.west};
+        case 180:
+            return RectDelta{delta.west, delta.east, delta.south, delta.north};
+        case 270:
+            return RectDelta{delta.north, delta.south, delta.east, delta.west};
+        default:
+            return delta;
+        }
+    }
+};
+}
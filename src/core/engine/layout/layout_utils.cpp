@@ -0,0 +1,148 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include "layout_utils.hpp"
+
+#include <cmath>
+
+namespace Bismuth::LayoutUtils
+{
+namespace
+{
+/**
+ * Unlike std::clamp, allows @p max to be less than @p min. The same as clip() of the TS backend.
+ */
+int clip(int value, int min, int max)
+{
+    if (value < min) {
+        return min;
+    }
+    if (value > max) {
+        return max;
+    }
+    return value;
+}
+
+/**
+ * Splits a line into the weighted parts. Without weights all parts weigh one.
+ */
+struct LineSplit {
+    LineSplit(int length, Span<const double> weights, std::size_t count, int gap)
+        : m_weights(weights)
+        , m_gap(gap)
+        , m_actualLength(static_cast<double>(length - (static_cast<int>(count) - 1) * gap))
+    {
+        if (m_weights.empty()) {
+            m_weightSum = static_cast<double>(count);
+        } else {
+            for (auto weight : m_weights) {
+                m_weightSum += weight;
+            }
+        }
+    }
+
+    double weight(std::size_t index) const
+    {
+        return m_weights.empty() ? 1.0 : m_weights[index];
+    }
+
+    /**
+     * Offset of the part from the beginning of the line
+     * @param weightAcc the sum of the weights of all the previous parts
+     */
+    int offset(std::size_t index, double weightAcc) const
+    {
+        return static_cast<int>(std::floor((m_actualLength * weightAcc) / m_weightSum + static_cast<int>(index) * m_gap));
+    }
+
+    int length(std::size_t index) const
+    {
+        return static_cast<int>(std::floor((m_actualLength * weight(index)) / m_weightSum));
+    }
+
+private:
+    Span<const double> m_weights;
+    int m_gap;
+    double m_actualLength;
+    double m_weightSum{};
+};
+}
+
+void splitAreaWeighted(QRect area, Span<const double> weights, int gap, bool horizontal, Span<QRect> out)
+{
+    auto begin = horizontal ? area.x() : area.y();
+    auto length = horizontal ? area.width() : area.height();
+    auto split = LineSplit(length, weights, out.size(), gap);
+
+    auto weightAcc = 0.0;
+    for (auto i = std::size_t(0); i < out.size(); i++) {
+        auto partBegin = begin + split.offset(i, weightAcc);
+        auto partLength = split.length(i);
+        weightAcc += split.weight(i);
+
+        out[i] = horizontal ? QRect(partBegin, area.y(), partLength, area.height()) : QRect(area.x(), partBegin, area.width(), partLength);
+    }
+}
+
+void adjustAreaWeights(QRect area, Span<double> weights, int gap, std::size_t target, RectDelta delta, bool horizontal)
+{
+    constexpr auto minLength = 1;
+
+    auto length = horizontal ? area.width() : area.height();
+    auto deltaFw = horizontal ? delta.east : delta.south;
+    auto deltaBw = horizontal ? delta.west : delta.north;
+
+    auto count = weights.size();
+    auto split = LineSplit(length, weights, count, gap);
+
+    // Only the lengths matter for the weights, so the offsets are not computed
+    auto targetLength = split.length(target);
+    auto newTargetLength = targetLength;
+    auto previousLength = target > 0 ? split.length(target - 1) : 0;
+    auto nextLength = target + 1 < count ? split.length(target + 1) : 0;
+
+    // Apply the backward delta, limited to not squeeze the windows
+    if (target > 0 && deltaBw != 0) {
+        auto change = clip(deltaBw, minLength - targetLength, previousLength - minLength);
+        newTargetLength = targetLength + change;
+        previousLength -= change;
+    }
+
+    // Apply the forward delta. Like in the TS backend, it starts from the
+    // original length of the target.
+    if (target + 1 < count && deltaFw != 0) {
+        auto change = clip(deltaFw, minLength - targetLength, nextLength - minLength);
+        newTargetLength = targetLength + change;
+        nextLength -= change;
+    }
+
+    auto partLength = [&](std::size_t index) {
+        if (index == target) {
+            return newTargetLength;
+        } else if (index + 1 == target) {
+            return previousLength;
+        } else if (index == target + 1) {
+            return nextLength;
+        }
+        return split.length(index);
+    };
+
+    auto totalLength = 0;
+    for (auto i = std::size_t(0); i < count; i++) {
+        totalLength += partLength(i);
+    }
+
+    // The length of a part depends only on its own old weight, so the weights
+    // can be replaced one by one
+    for (auto i = std::size_t(0); i < count; i++) {
+        weights[i] = static_cast<double>(partLength(i)) / totalLength;
+    }
+}
+
+double adjustAreaHalfWeights(QRect area, double weight, int gap, std::size_t target, RectDelta delta, bool horizontal)
+{
+    double weights[] = {weight, 1 - weight};
+    adjustAreaWeights(area, weights, gap, target, delta, horizontal);
+    return weights[0];
+}
+}
@@ -0,0 +1,72 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <QRect>
+
+#include <cstddef>
+
+#include "engine/layout/span.hpp"
+
+namespace Bismuth
+{
+/**
+ * Change of the window size made by the user. Positive values grow the window
+ * in the corresponding direction.
+ */
+struct RectDelta {
+    int east{};
+    int west{};
+    int south{};
+    int north{};
+
+    bool operator==(const RectDelta &rhs) const
+    {
+        return east == rhs.east && west == rhs.west && south == rhs.south && north == rhs.north;
+    }
+
+    /**
+     * Change from the @p basis geometry to the @p target one, the same as
+     * RectDelta.fromRects of the TS backend
+     */
+    static RectDelta fromRects(QRect basis, QRect target)
+    {
+        auto dx = target.x() - basis.x();
+        auto dy = target.y() - basis.y();
+        auto dWidth = target.width() - basis.width();
+        auto dHeight = target.height() - basis.height();
+
+        return RectDelta{dWidth + dx, -dx, dHeight + dy, -dy};
+    }
+};
+}
+
+/**
+ * Helpers of the layouts. They round the same way as the LayoutUtils of the TS
+ * backend, so that both backends produce the same layouts. The results are
+ * written into the spans of the caller.
+ */
+namespace Bismuth::LayoutUtils
+{
+/**
+ * Split the @p area into the weighted parts with the @p gap between them. The
+ * parts are side by side, if @p horizontal, or one on top of the other
+ * otherwise. The number of the parts is the size of @p out.
+ * @param weights the weight of each part or nothing, if the parts are equal
+ */
+void splitAreaWeighted(QRect area, Span<const double> weights, int gap, bool horizontal, Span<QRect> out);
+
+/**
+ * Recalculate the @p weights of the parts of the @p area, when the @p target
+ * part is resized by the @p delta. The weights are normalized to sum up to one.
+ */
+void adjustAreaWeights(QRect area, Span<double> weights, int gap, std::size_t target, RectDelta delta, bool horizontal);
+
+/**
+ * Recalculate the weight of the first of the two parts of the @p area, when the
+ * @p target part is resized by the @p delta
+ * @returns the new weight of the first part
+ */
+double adjustAreaHalfWeights(QRect area, double weight, int gap, std::size_t target, RectDelta delta, bool horizontal);
+}
@@ -5,10 +5,18 @@
 
 namespace Bismuth
 {
-void Monocle::apply(QRect area, std::vector<Window> &windows) const
+QString Monocle::id() const
 {
+    return QStringLiteral("MonocleLayout");
+}
+
+void Monocle::apply(QRect area, WindowsView windows) const
+{
+    auto mode = m_config.monocleMaximize() ? Window::Mode::Maximized : Window::Mode::Tiled;
+
     for (auto &window : windows) {
         // Place the window on the all available area
+        window.setMode(mode);
         window.setGeometry(area);
     }
 }
@@ -10,6 +10,7 @@ namespace Bismuth
 struct Monocle : Layout {
     using Layout::Layout;
 
-    virtual void apply(QRect area, std::vector<Window> &windows) const override;
+    virtual QString id() const override;
+    virtual void apply(QRect area, WindowsView windows) const override;
 };
 }
@@ -0,0 +1,169 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include "quarter.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Bismuth
+{
+namespace
+{
+/**
+ * Shrink the @p rect by the gaps on its sides, the same as Rect.gap() of the TS backend
+ */
+QRect withGaps(QRect rect, int left, int right, int top, int bottom)
+{
+    return QRect(rect.x() + left, rect.y() + top, rect.width() - (left + right), rect.height() - (top + bottom));
+}
+
+/**
+ * The split of the line of the @p length moved by the @p delta
+ */
+double movedSplit(double split, int length, int delta)
+{
+    return (std::floor(length * split) + delta) / length;
+}
+
+/**
+ * Keep the @p split within the limits the same way as the TS backend does
+ */
+double clippedSplit(double split)
+{
+    if (split < 1 - Quarter::maxProportion) {
+        return 1 - Quarter::maxProportion;
+    }
+    if (split > Quarter::maxProportion) {
+        return Quarter::maxProportion;
+    }
+    return split;
+}
+}
+
+QString Quarter::id() const
+{
+    return QStringLiteral("QuarterLayout");
+}
+
+void Quarter::apply(QRect area, WindowsView windows) const
+{
+    tile(windows, geometries(area, windows.size()));
+
+    for (auto i = capacity; i < windows.size(); i++) {
+        windows[i].setMode(Window::Mode::Floating);
+    }
+}
+
+std::vector<QRect> Quarter::geometries(QRect area, std::size_t count) const
+{
+    auto result = std::vector<QRect>(std::min(count, capacity));
+    geometries(area, result);
+    return result;
+}
+
+void Quarter::geometries(QRect area, Span<QRect> out) const
+{
+    auto count = out.size();
+    if (count == 0) {
+        return;
+    } else if (count == 1) {
+        out[0] = area;
+        return;
+    }
+
+    auto gap1 = m_config.tileLayoutGap() / 2;
+    auto gap2 = m_config.tileLayoutGap() - gap1;
+
+    auto leftWidth = static_cast<int>(std::floor(area.width() * m_verticalSplit));
+    auto rightWidth = area.width() - leftWidth;
+    auto rightX = area.x() + leftWidth;
+    if (count == 2) {
+        out[0] = withGaps(QRect(area.x(), area.y(), leftWidth, area.height()), 0, gap1, 0, 0);
+        out[1] = withGaps(QRect(rightX, area.y(), rightWidth, area.height()), gap2, 0, 0, 0);
+        return;
+    }
+
+    auto rightTopHeight = static_cast<int>(std::floor(area.height() * m_rightHorizontalSplit));
+    auto rightBottomHeight = area.height() - rightTopHeight;
+    auto rightBottomY = area.y() + rightTopHeight;
+    out[1] = withGaps(QRect(rightX, area.y(), rightWidth, rightTopHeight), gap2, 0, 0, gap1);
+    out[2] = withGaps(QRect(rightX, rightBottomY, rightWidth, rightBottomHeight), gap2, 0, gap2, 0);
+    if (count == 3) {
+        out[0] = withGaps(QRect(area.x(), area.y(), leftWidth, area.height()), 0, gap1, 0, 0);
+        return;
+    }
+
+    auto leftTopHeight = static_cast<int>(std::floor(area.height() * m_leftHorizontalSplit));
+    auto leftBottomHeight = area.height() - leftTopHeight;
+    auto leftBottomY = area.y() + leftTopHeight;
+    out[0] = withGaps(QRect(area.x(), area.y(), leftWidth, leftTopHeight), 0, gap1, 0, gap1);
+    out[3] = withGaps(QRect(area.x(), leftBottomY, leftWidth, leftBottomHeight), 0, gap2, gap2, 0);
+}
+
+void Quarter::adjust(QRect area, Span<double> weights, std::size_t basis, RectDelta delta)
+{
+    auto count = weights.size();
+    if (count <= 1 || count > capacity || basis >= count) {
+        return;
+    }
+
+    if ((basis == 0 || basis == 3) && delta.east != 0) {
+        m_verticalSplit = movedSplit(m_verticalSplit, area.width(), delta.east);
+    } else if ((basis == 1 || basis == 2) && delta.west != 0) {
+        m_verticalSplit = movedSplit(m_verticalSplit, area.width(), -delta.west);
+    }
+
+    if (count == 4) {
+        if (basis == 0 && delta.south != 0) {
+            m_leftHorizontalSplit = movedSplit(m_leftHorizontalSplit, area.height(), delta.south);
+        }
+        if (basis == 3 && delta.north != 0) {
+            m_leftHorizontalSplit = movedSplit(m_leftHorizontalSplit, area.height(), -delta.north);
+        }
+    }
+
+    if (count >= 3) {
+        if (basis == 1 && delta.south != 0) {
+            m_rightHorizontalSplit = movedSplit(m_rightHorizontalSplit, area.height(), delta.south);
+        }
+        if (basis == 2 && delta.north != 0) {
+            m_rightHorizontalSplit = movedSplit(m_rightHorizontalSplit, area.height(), -delta.north);
+        }
+    }
+
+    m_verticalSplit = clippedSplit(m_verticalSplit);
+    m_leftHorizontalSplit = clippedSplit(m_leftHorizontalSplit);
+    m_rightHorizontalSplit = clippedSplit(m_rightHorizontalSplit);
+}
+
+double Quarter::verticalSplit() const
+{
+    return m_verticalSplit;
+}
+
+void Quarter::setVerticalSplit(double value)
+{
+    m_verticalSplit = value;
+}
+
+double Quarter::leftHorizontalSplit() const
+{
+    return m_leftHorizontalSplit;
+}
+
+void Quarter::setLeftHorizontalSplit(double value)
+{
+    m_leftHorizontalSplit = value;
+}
+
+double Quarter::rightHorizontalSplit() const
+{
+    return m_rightHorizontalSplit;
+}
+
+void Quarter::setRightHorizontalSplit(double value)
+{
+    m_rightHorizontalSplit = value;
+}
+}
@@ -0,0 +1,75 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <QRect>
+
+#include <cstddef>
+#include <vector>
+
+#include "engine/layout/layout_utils.hpp"
+#include "engine/layout/span.hpp"
+#include "layout.hpp"
+
+namespace Bismuth
+{
+/**
+ * Up to four windows in the quarters of the area. The windows after the
+ * fourth one float. Produces the same geometries as the QuarterLayout of the
+ * TS backend. Like there, its parameters are not kept between the sessions.
+ *
+ *    | 0 | 1 |
+ *    | 3 | 2 |
+ */
+struct Quarter : Layout {
+    static constexpr auto capacity = std::size_t(4);
+    static constexpr auto maxProportion = 0.8;
+
+    using Layout::Layout;
+
+    virtual QString id() const override;
+    virtual void apply(QRect area, WindowsView windows) const override;
+
+    /**
+     * Geometries of the tiled windows out of the @p count ones on the tiling
+     * @p area in the tiling order. There are no more than the capacity of them.
+     */
+    std::vector<QRect> geometries(QRect area, std::size_t count) const;
+
+    /**
+     * Write the geometries of out.size() windows into @p out, which holds no
+     * more than the capacity of them
+     */
+    void geometries(QRect area, Span<QRect> out) const;
+
+    /**
+     * Move the borders between the quarters, after the @p basis window was
+     * resized by the @p delta. Only the number of the @p weights matters.
+     */
+    virtual void adjust(QRect area, Span<double> weights, std::size_t basis, RectDelta delta) override;
+
+    /**
+     * Share of the area width taken by the left quarters
+     */
+    double verticalSplit() const;
+    void setVerticalSplit(double);
+
+    /**
+     * Share of the area height taken by the top left quarter
+     */
+    double leftHorizontalSplit() const;
+    void setLeftHorizontalSplit(double);
+
+    /**
+     * Share of the area height taken by the top right quarter
+     */
+    double rightHorizontalSplit() const;
+    void setRightHorizontalSplit(double);
+
+private:
+    double m_verticalSplit{0.5};
+    double m_leftHorizontalSplit{0.5};
+    double m_rightHorizontalSplit{0.5};
+};
+}
@@ -0,0 +1,96 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace Bismuth
+{
+/**
+ * Non-owning view of the contiguous elements, a stand-in for std::span, that
+ * is not there in C++17
+ */
+template<typename T>
+class Span
+{
+public:
+    Span() = default;
+
+    Span(T *data, std::size_t size)
+        : m_data(data)
+        , m_size(size)
+    {
+    }
+
+    /**
+     * View of the container with contiguous storage, e.g. std::vector, an
+     * array or a span of the non-const elements
+     */
+    template<typename Container, typename = std::enable_if_t<std::is_convertible_v<decltype(std::declval<Container &>().data()), T *>>>
+    Span(Container &&container)
+        : m_data(container.data())
+        , m_size(container.size())
+    {
+    }
+
+    template<std::size_t N>
+    Span(T (&array)[N])
+        : m_data(array)
+        , m_size(N)
+    {
+    }
+
+    T *data() const
+    {
+        return m_data;
+    }
+
+    std::size_t size() const
+    {
+        return m_size;
+    }
+
+    bool empty() const
+    {
+        return m_size == 0;
+    }
+
+    T &operator[](std::size_t index) const
+    {
+        return m_data[index];
+    }
+
+    T *begin() const
+    {
+        return m_data;
+    }
+
+    T *end() const
+    {
+        return m_data + m_size;
+    }
+
+    /**
+     * The first @p count elements
+     */
+    Span first(std::size_t count) const
+    {
+        return Span(m_data, count);
+    }
+
+    /**
+     * The elements starting from the @p offset
+     */
+    Span subspan(std::size_t offset) const
+    {
+        return Span(m_data + offset, m_size - offset);
+    }
+
+private:
+    T *m_data{};
+    std::size_t m_size{};
+};
+}
@@ -0,0 +1,106 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include "spiral.hpp"
+
+#include "engine/layout/layout_parts.hpp"
+#include "state/layout_state.hpp"
+
+namespace Bismuth
+{
+/**
+ * The split of the spiral at the depth, which places the window there and
+ * passes the rest of the area to the next level. The levels are created on
+ * the fly, so that the spiral has as many levels as there are windows.
+ */
+template<typename Ratios>
+struct Spiral::Level {
+    Ratios *ratios{};
+    int rotation{};
+    int gap{};
+    std::size_t depth{};
+
+    auto split() const
+    {
+        auto result = LayoutParts::HalfSplit<LayoutParts::Fill, Level>();
+        result.secondary = Level{ratios, rotation, gap, depth + 1};
+        result.angle = depth == 0 ? rotation : static_cast<int>(depth % 4) * 90;
+        result.gap = gap;
+        result.ratio = depth < ratios->size() ? (*ratios)[depth] : 0.5;
+        return result;
+    }
+
+    void apply(QRect area, Span<const double> weights, Span<QRect> out) const
+    {
+        split().apply(area, weights, out);
+    }
+
+    RectDelta adjust(QRect area, Span<double> weights, std::size_t basis, RectDelta delta)
+    {
+        auto adjustedSplit = split();
+        delta = adjustedSplit.adjust(area, weights, basis, delta);
+
+        if (depth >= ratios->size()) {
+            ratios->resize(depth + 1, 0.5);
+        }
+        (*ratios)[depth] = adjustedSplit.ratio;
+
+        return delta;
+    }
+};
+
+QString Spiral::id() const
+{
+    return QStringLiteral("SpiralLayout");
+}
+
+void Spiral::apply(QRect area, WindowsView windows) const
+{
+    tile(windows, geometries(area, windows.size()));
+}
+
+std::vector<QRect> Spiral::geometries(QRect area, std::size_t count) const
+{
+    auto result = std::vector<QRect>(count);
+    geometries(area, {}, result);
+    return result;
+}
+
+void Spiral::geometries(QRect area, Span<const double> weights, Span<QRect> out) const
+{
+    auto root = Level<const std::vector<double>>{&m_ratios, m_rotation, m_config.tileLayoutGap(), 0};
+    root.apply(area, weights, out);
+}
+
+void Spiral::adjust(QRect area, Span<double> weights, std::size_t basis, RectDelta delta)
+{
+    auto root = Level<std::vector<double>>{&m_ratios, m_rotation, m_config.tileLayoutGap(), 0};
+    root.adjust(area, weights, basis, delta);
+}
+
+void Spiral::saveState(LayoutState &state) const
+{
+    state.rotation = rotation();
+}
+
+void Spiral::loadState(const LayoutState &state)
+{
+    setRotation(state.rotation);
+}
+
+int Spiral::rotation() const
+{
+    return m_rotation;
+}
+
+void Spiral::setRotation(int value)
+{
+    // Keep the angle one of 0, 90, 180 or 270
+    m_rotation = ((value / 90 % 4) + 4) % 4 * 90;
+}
+
+double Spiral::ratio(std::size_t depth) const
+{
+    return depth < m_ratios.size() ? m_ratios[depth] : 0.5;
+}
+}
@@ -0,0 +1,77 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <QRect>
+
+#include <cstddef>
+#include <vector>
+
+#include "engine/layout/layout_utils.hpp"
+#include "engine/layout/span.hpp"
+#include "layout.hpp"
+
+namespace Bismuth
+{
+/**
+ * Every window takes a half of the area left by the previous ones, going
+ * around in a spiral. Produces the same geometries as the SpiralLayout of the
+ * TS backend.
+ */
+struct Spiral : Layout {
+    using Layout::Layout;
+
+    virtual QString id() const override;
+    virtual void apply(QRect area, WindowsView windows) const override;
+
+    /**
+     * Geometries of the @p count windows on the tiling @p area in the tiling order
+     */
+    std::vector<QRect> geometries(QRect area, std::size_t count) const;
+
+    /**
+     * Write the geometries of out.size() windows into @p out. The weights do
+     * not change anything, they are there for the uniformity with the other
+     * layouts.
+     */
+    void geometries(QRect area, Span<const double> weights, Span<QRect> out) const;
+
+    /**
+     * Update the ratios of the splits around the @p basis window, after it
+     * was resized by the @p delta
+     */
+    virtual void adjust(QRect area, Span<double> weights, std::size_t basis, RectDelta delta) override;
+
+    /**
+     * Only the rotation is kept
+     */
+    virtual void saveState(LayoutState &state) const override;
+    virtual void loadState(const LayoutState &state) override;
+
+    /**
+     * Rotation of the first split in degrees: 0, 90, 180 or 270. The deeper
+     * splits turn by 90 degrees each regardless of it, the same as in the TS
+     * backend.
+     */
+    int rotation() const;
+    void setRotation(int);
+
+    /**
+     * Share of the area taken by the window at the @p depth out of the area
+     * left for it and the windows after it
+     */
+    double ratio(std::size_t depth) const;
+
+private:
+    template<typename Ratios>
+    struct Level;
+
+    int m_rotation{};
+
+    /**
+     * Ratios of the splits, that were resized. The deeper ones are even.
+     */
+    std::vector<double> m_ratios{};
+};
+}
@@ -5,7 +5,12 @@
 
 namespace Bismuth
 {
-void Stacked::apply(QRect area, std::vector<Window> &windows) const
+QString Stacked::id() const
+{
+    return QStringLiteral("StackedLayout");
+}
+
+void Stacked::apply(QRect area, WindowsView windows) const
 {
 }
 }
@@ -0,0 +1,160 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include "three_column.hpp"
+
+#include <algorithm>
+
+namespace Bismuth
+{
+namespace
+{
+/**
+ * Weights of the windows of a group or nothing, if all the windows are equal
+ */
+template<typename T>
+Span<T> groupWeights(Span<T> weights, std::size_t offset, std::size_t size)
+{
+    return weights.empty() ? weights : weights.subspan(offset).first(size);
+}
+
+void scaleWeights(Span<double> weights)
+{
+    // The average weight stays one
+    for (auto &weight : weights) {
+        weight *= weights.size();
+    }
+}
+}
+
+QString ThreeColumn::id() const
+{
+    return QStringLiteral("ThreeColumnLayout");
+}
+
+void ThreeColumn::apply(QRect area, WindowsView windows) const
+{
+    tile(windows, geometries(area, windows.size()));
+}
+
+std::vector<QRect> ThreeColumn::geometries(QRect area, std::size_t count) const
+{
+    auto result = std::vector<QRect>(count);
+    geometries(area, {}, result);
+    return result;
+}
+
+void ThreeColumn::geometries(QRect area, Span<const double> weights, Span<QRect> out) const
+{
+    auto gap = m_config.tileLayoutGap();
+    auto count = out.size();
+    auto masterSize = static_cast<std::size_t>(m_masterCount);
+
+    if (count <= masterSize) {
+        // Only the master column
+        LayoutUtils::splitAreaWeighted(area, weights, gap, false, out);
+    } else if (count == masterSize + 1) {
+        // The master column and the right stack with a single window
+        double halfWeights[] = {m_masterRatio, 1 - m_masterRatio};
+        QRect halves[2];
+        LayoutUtils::splitAreaWeighted(area, halfWeights, gap, true, halves);
+
+        LayoutUtils::splitAreaWeighted(halves[0], groupWeights(weights, 0, masterSize), gap, false, out.first(masterSize));
+        out[count - 1] = halves[1];
+    } else {
+        // The left stack, the master column and the right stack
+        auto stackRatio = 1 - m_masterRatio;
+        double columnWeights[] = {stackRatio, m_masterRatio, stackRatio};
+        QRect columns[3];
+        LayoutUtils::splitAreaWeighted(area, columnWeights, gap, true, columns);
+
+        auto rightSize = rightStackSize(count);
+        auto leftOffset = masterSize + rightSize;
+        auto leftSize = count - leftOffset;
+
+        LayoutUtils::splitAreaWeighted(columns[0], groupWeights(weights, leftOffset, leftSize), gap, false, out.subspan(leftOffset));
+        LayoutUtils::splitAreaWeighted(columns[1], groupWeights(weights, 0, masterSize), gap, false, out.first(masterSize));
+        LayoutUtils::splitAreaWeighted(columns[2], groupWeights(weights, masterSize, rightSize), gap, false, out.subspan(masterSize).first(rightSize));
+    }
+}
+
+void ThreeColumn::adjust(QRect area, Span<double> weights, std::size_t basis, RectDelta delta)
+{
+    auto gap = m_config.tileLayoutGap();
+    auto count = weights.size();
+    auto masterSize = static_cast<std::size_t>(m_masterCount);
+
+    if (basis >= count) {
+        return;
+    }
+
+    if (count <= masterSize) {
+        LayoutUtils::adjustAreaWeights(area, weights, gap, basis, delta, false);
+        scaleWeights(weights);
+    } else if (count == masterSize + 1) {
+        auto isMaster = basis < masterSize;
+        m_masterRatio = LayoutUtils::adjustAreaHalfWeights(area, m_masterRatio, gap, isMaster ? 0 : 1, delta, true);
+
+        if (isMaster) {
+            auto masterWeights = weights.first(masterSize);
+            LayoutUtils::adjustAreaWeights(area, masterWeights, gap, basis, delta, false);
+            scaleWeights(masterWeights);
+        }
+    } else {
+        auto rightSize = rightStackSize(count);
+
+        // The columns are: 0 is the left stack, 1 is the master, 2 is the right stack
+        auto column = 0;
+        auto groupOffset = masterSize + rightSize;
+        auto groupSize = count - groupOffset;
+        if (basis < masterSize) {
+            column = 1;
+            groupOffset = 0;
+            groupSize = masterSize;
+        } else if (basis < masterSize + rightSize) {
+            column = 2;
+            groupOffset = masterSize;
+            groupSize = rightSize;
+        }
+
+        auto stackRatio = 1 - m_masterRatio;
+        double columnWeights[] = {stackRatio, m_masterRatio, stackRatio};
+        LayoutUtils::adjustAreaWeights(area, columnWeights, gap, column, delta, true);
+
+        // Both stacks stay of the same width
+        auto newMasterRatio = columnWeights[1];
+        auto newStackRatio = column == 0 ? columnWeights[0] : columnWeights[2];
+        m_masterRatio = newMasterRatio / (newMasterRatio + newStackRatio);
+
+        // Only the height matters here, so the whole area is fine
+        auto basisGroup = weights.subspan(groupOffset).first(groupSize);
+        LayoutUtils::adjustAreaWeights(area, basisGroup, gap, basis - groupOffset, delta, false);
+        scaleWeights(basisGroup);
+    }
+}
+
+int ThreeColumn::masterCount() const
+{
+    return m_masterCount;
+}
+
+void ThreeColumn::setMasterCount(int value)
+{
+    m_masterCount = std::clamp(value, minMasterCount, maxMasterCount);
+}
+
+double ThreeColumn::masterRatio() const
+{
+    return m_masterRatio;
+}
+
+void ThreeColumn::setMasterRatio(double value)
+{
+    m_masterRatio = value;
+}
+
+std::size_t ThreeColumn::rightStackSize(std::size_t count) const
+{
+    return (count - static_cast<std::size_t>(m_masterCount)) / 2;
+}
+}
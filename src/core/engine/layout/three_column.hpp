@@ -0,0 +1,73 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <QRect>
+
+#include <cstddef>
+#include <vector>
+
+#include "engine/layout/layout_utils.hpp"
+#include "engine/layout/span.hpp"
+#include "layout.hpp"
+
+namespace Bismuth
+{
+/**
+ * The master windows are in the middle column, the rest of them are split
+ * between the stacks on the left and on the right. Produces the same
+ * geometries as the ThreeColumnLayout of the TS backend. Like there, its
+ * parameters are not kept between the sessions.
+ */
+struct ThreeColumn : Layout {
+    static constexpr auto minMasterRatio = 0.2;
+    static constexpr auto maxMasterRatio = 0.75;
+    static constexpr auto minMasterCount = 1;
+    static constexpr auto maxMasterCount = 10;
+
+    using Layout::Layout;
+
+    virtual QString id() const override;
+    virtual void apply(QRect area, WindowsView windows) const override;
+
+    /**
+     * Geometries of the @p count windows on the tiling @p area in the tiling order
+     */
+    std::vector<QRect> geometries(QRect area, std::size_t count) const;
+
+    /**
+     * Write the geometries of out.size() windows into @p out
+     * @param weights the relative sizes of the windows or nothing, if they are equal
+     */
+    void geometries(QRect area, Span<const double> weights, Span<QRect> out) const;
+
+    /**
+     * Update the master ratio and the @p weights of the windows, after the
+     * @p basis window was resized by the @p delta
+     */
+    virtual void adjust(QRect area, Span<double> weights, std::size_t basis, RectDelta delta) override;
+
+    int masterCount() const;
+
+    /**
+     * Clipped to [minMasterCount, maxMasterCount]
+     */
+    void setMasterCount(int);
+
+    /**
+     * Share of the area width taken by the master column
+     */
+    double masterRatio() const;
+    void setMasterRatio(double);
+
+private:
+    /**
+     * Number of the windows in the right stack. The left one takes the rest.
+     */
+    std::size_t rightStackSize(std::size_t count) const;
+
+    int m_masterCount{1};
+    double m_masterRatio{0.6};
+};
+}
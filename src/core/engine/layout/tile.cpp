@@ -0,0 +1,96 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include "tile.hpp"
+
+#include <algorithm>
+
+#include "state/layout_state.hpp"
+
+namespace Bismuth
+{
+QString Tile::id() const
+{
+    return QStringLiteral("TileLayout");
+}
+
+void Tile::apply(QRect area, WindowsView windows) const
+{
+    tile(windows, geometries(area, windows.size()));
+}
+
+std::vector<QRect> Tile::geometries(QRect area, std::size_t count) const
+{
+    auto result = std::vector<QRect>(count);
+    geometries(area, {}, result);
+    return result;
+}
+
+void Tile::geometries(QRect area, Span<const double> weights, Span<QRect> out) const
+{
+    parts().apply(area, weights, out);
+}
+
+void Tile::adjust(QRect area, Span<double> weights, std::size_t basis, RectDelta delta)
+{
+    auto adjustedParts = parts();
+    adjustedParts.adjust(area, weights, basis, delta);
+    m_parts.inner.ratio = adjustedParts.inner.ratio;
+}
+
+void Tile::saveState(LayoutState &state) const
+{
+    state.rotation = rotation();
+    state.masterCount = masterCount();
+    state.masterRatio = masterRatio();
+}
+
+void Tile::loadState(const LayoutState &state)
+{
+    setRotation(state.rotation);
+    setMasterCount(state.masterCount);
+    setMasterRatio(state.masterRatio);
+}
+
+int Tile::masterCount() const
+{
+    return static_cast<int>(m_parts.inner.primarySize);
+}
+
+void Tile::setMasterCount(int value)
+{
+    m_parts.inner.primarySize = static_cast<std::size_t>(std::max(value, 0));
+}
+
+double Tile::masterRatio() const
+{
+    return m_parts.inner.ratio;
+}
+
+void Tile::setMasterRatio(double value)
+{
+    m_parts.inner.ratio = value;
+}
+
+int Tile::rotation() const
+{
+    return m_parts.angle;
+}
+
+void Tile::setRotation(int value)
+{
+    // Keep the angle one of 0, 90, 180 or 270
+    m_parts.angle = ((value / 90 % 4) + 4) % 4 * 90;
+}
+
+Tile::Parts Tile::parts() const
+{
+    auto gap = m_config.tileLayoutGap();
+
+    auto result = m_parts;
+    result.inner.gap = gap;
+    result.inner.primary.inner.gap = gap;
+    result.inner.secondary.gap = gap;
+    return result;
+}
+}
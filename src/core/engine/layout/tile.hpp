@@ -0,0 +1,78 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <QRect>
+
+#include <cstddef>
+#include <vector>
+
+#include "engine/layout/layout_parts.hpp"
+#include "engine/layout/layout_utils.hpp"
+#include "engine/layout/span.hpp"
+#include "layout.hpp"
+
+namespace Bismuth
+{
+/**
+ * Master and stack layout. The first windows are stacked in the master area on
+ * one side of the tiling area, the rest of them are stacked on the other side.
+ * Produces the same geometries as the TileLayout of the TS backend.
+ */
+struct Tile : Layout {
+    using Parts = LayoutParts::Rotate<LayoutParts::HalfSplit<LayoutParts::Rotate<LayoutParts::Stack>, LayoutParts::Stack>>;
+
+    using Layout::Layout;
+
+    virtual QString id() const override;
+    virtual void apply(QRect area, WindowsView windows) const override;
+
+    /**
+     * Geometries of the @p count windows on the tiling @p area in the tiling order
+     */
+    std::vector<QRect> geometries(QRect area, std::size_t count) const;
+
+    /**
+     * Write the geometries of out.size() windows into @p out
+     * @param weights the relative sizes of the windows or nothing, if they are equal
+     */
+    void geometries(QRect area, Span<const double> weights, Span<QRect> out) const;
+
+    /**
+     * Update the master ratio and the @p weights of the windows, after the
+     * @p basis window was resized by the @p delta
+     */
+    virtual void adjust(QRect area, Span<double> weights, std::size_t basis, RectDelta delta) override;
+
+    /**
+     * The rotation, the master count and the master ratio are kept
+     */
+    virtual void saveState(LayoutState &state) const override;
+    virtual void loadState(const LayoutState &state) override;
+
+    int masterCount() const;
+    void setMasterCount(int);
+
+    /**
+     * Share of the area width taken by the master area
+     */
+    double masterRatio() const;
+    void setMasterRatio(double);
+
+    /**
+     * Rotation angle in degrees: 0 puts the master area on the left, 90 on
+     * the top, 180 on the right and 270 on the bottom
+     */
+    int rotation() const;
+    void setRotation(int);
+
+private:
+    /**
+     * The parts with the gaps from the config, which might change any time
+     */
+    Parts parts() const;
+
+    Parts m_parts{};
+};
+}
@@ -0,0 +1,214 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include "neighbor_index.hpp"
+
+#include <algorithm>
+#include <optional>
+#include <unordered_set>
+#include <vector>
+
+namespace Bismuth
+{
+namespace
+{
+/**
+ * Tests if two ranges are overlapping. The same as overlap() of the TS backend.
+ */
+bool overlap(int min1, int max1, int min2, int max2)
+{
+    return std::max(0, std::min(max1, max2) - std::max(min1, min2)) > 0;
+}
+
+/**
+ * Walk the edges from the closest one, until they are too far from the
+ * closest candidate, and choose the most recently used candidate
+ * @param isCandidate whether the window could be the neighbor at all
+ * @param isBeyond whether the edge is too far from the edge of the closest candidate
+ */
+template<typename Iterator, typename IsCandidate, typename IsBeyond>
+Window *closestCandidate(Iterator begin,
+                         Iterator end,
+                         IsCandidate isCandidate,
+                         IsBeyond isBeyond,
+                         const NeighborIndex::RecencyFunction &recency)
+{
+    Window *result = nullptr;
+    auto closestEdge = std::optional<int>();
+
+    for (auto it = begin; it != end; ++it) {
+        auto [edge, window] = *it;
+
+        if (closestEdge.has_value() && isBeyond(edge, closestEdge.value())) {
+            break;
+        }
+
+        if (!isCandidate(*window)) {
+            continue;
+        }
+
+        if (!closestEdge.has_value()) {
+            closestEdge = edge;
+        }
+
+        if (!result || recency(*window) > recency(*result)) {
+            result = window;
+        }
+    }
+
+    return result;
+}
+}
+
+void NeighborIndex::commit(WindowsView windows)
+{
+    auto tiledWindows = std::unordered_set<const Window *>();
+
+    for (auto &window : windows) {
+        if (window.mode() != Window::Mode::Tiled) {
+            continue;
+        }
+        tiledWindows.insert(&window);
+
+        auto geometry = window.geometry();
+        auto it = m_geometries.find(&window);
+        if (it != m_geometries.end()) {
+            if (it->second == geometry) {
+                continue;
+            }
+            erase(window, it->second);
+        }
+        insert(window, geometry);
+    }
+
+    auto outdatedWindows = std::vector<const Window *>();
+    for (auto &[window, _] : m_geometries) {
+        if (tiledWindows.find(window) == tiledWindows.end()) {
+            outdatedWindows.push_back(window);
+        }
+    }
+
+    for (auto window : outdatedWindows) {
+        remove(*window);
+    }
+}
+
+void NeighborIndex::remove(const Window &window)
+{
+    auto it = m_geometries.find(&window);
+    if (it == m_geometries.end()) {
+        return;
+    }
+
+    erase(window, it->second);
+}
+
+Window *NeighborIndex::neighbor(QRect basis, Direction direction, const RecencyFunction &recency) const
+{
+    auto geometry = [this](const Window &window) {
+        return m_geometries.at(&window);
+    };
+
+    // The neighbor must share a part of the basis side, that faces it
+    auto overlapsHorizontally = [&](QRect rect) {
+        return overlap(basis.x(), basis.x() + basis.width(), rect.x(), rect.x() + rect.width());
+    };
+    auto overlapsVertically = [&](QRect rect) {
+        return overlap(basis.y(), basis.y() + basis.height(), rect.y(), rect.y() + rect.height());
+    };
+
+    auto furtherForward = [](int edge, int closestEdge) {
+        return edge >= closestEdge + edgeTolerance;
+    };
+    auto furtherBackward = [](int edge, int closestEdge) {
+        return edge <= closestEdge - edgeTolerance;
+    };
+
+    switch (direction) {
+    case Direction::Down:
+        return closestCandidate(
+            m_topEdges.upper_bound(basis.y()),
+            m_topEdges.end(),
+            [&](const Window &window) {
+                return overlapsHorizontally(geometry(window));
+            },
+            furtherForward,
+            recency);
+    case Direction::Right:
+        return closestCandidate(
+            m_leftEdges.upper_bound(basis.x()),
+            m_leftEdges.end(),
+            [&](const Window &window) {
+                return overlapsVertically(geometry(window));
+            },
+            furtherForward,
+            recency);
+    case Direction::Up:
+        // The bottom edges tell nothing about the top ones, so the walk starts from the lowest window
+        return closestCandidate(
+            m_bottomEdges.rbegin(),
+            m_bottomEdges.rend(),
+            [&](const Window &window) {
+                auto rect = geometry(window);
+                return rect.y() < basis.y() && overlapsHorizontally(rect);
+            },
+            furtherBackward,
+            recency);
+    case Direction::Left:
+        return closestCandidate(
+            m_rightEdges.rbegin(),
+            m_rightEdges.rend(),
+            [&](const Window &window) {
+                auto rect = geometry(window);
+                return rect.x() < basis.x() && overlapsVertically(rect);
+            },
+            furtherBackward,
+            recency);
+    }
+
+    return nullptr;
+}
+
+std::optional<QRect> NeighborIndex::geometry(const Window &window) const
+{
+    auto it = m_geometries.find(&window);
+    if (it == m_geometries.end()) {
+        return std::nullopt;
+    }
+
+    return it->second;
+}
+
+std::size_t NeighborIndex::size() const
+{
+    return m_geometries.size();
+}
+
+void NeighborIndex::insert(Window &window, QRect geometry)
+{
+    m_geometries[&window] = geometry;
+    m_leftEdges.emplace(geometry.x(), &window);
+    m_topEdges.emplace(geometry.y(), &window);
+    m_rightEdges.emplace(geometry.x() + geometry.width(), &window);
+    m_bottomEdges.emplace(geometry.y() + geometry.height(), &window);
+}
+
+void NeighborIndex::erase(const Window &window, QRect geometry)
+{
+    auto eraseEdge = [&window](Edges &edges, int edge) {
+        auto [begin, end] = edges.equal_range(edge);
+        auto it = std::find_if(begin, end, [&window](const Edges::value_type &entry) {
+            return entry.second == &window;
+        });
+        if (it != end) {
+            edges.erase(it);
+        }
+    };
+
+    eraseEdge(m_leftEdges, geometry.x());
+    eraseEdge(m_topEdges, geometry.y());
+    eraseEdge(m_rightEdges, geometry.x() + geometry.width());
+    eraseEdge(m_bottomEdges, geometry.y() + geometry.height());
+    m_geometries.erase(&window);
+}
+}
@@ -0,0 +1,82 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <QRect>
+#include <QtGlobal>
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <optional>
+#include <unordered_map>
+
+#include "engine/window.hpp"
+#include "engine/windows_view.hpp"
+
+namespace Bismuth
+{
+enum class Direction { Up, Down, Right, Left };
+
+/**
+ * Tiled windows of a surface, sorted by each of their edges. Finds the
+ * neighbor of a window in a direction the same way as the TS backend, but
+ * walks only from the closest edge outward instead of checking every window.
+ *
+ * Windows are referred to by pointers, so they must be removed from the index
+ * before they are destroyed.
+ */
+class NeighborIndex
+{
+public:
+    /**
+     * The bigger the value, the more recently the window was used
+     */
+    using RecencyFunction = std::function<quint64(const Window &)>;
+
+    /**
+     * Windows, which edges are closer than that to the closest one, are
+     * equally close. The same as in the TS backend.
+     */
+    static constexpr auto edgeTolerance = 5;
+
+    /**
+     * Index the tiled @p windows with their current geometries. Only the
+     * windows, that moved, are reindexed. The windows, that are not among
+     * the @p windows or not tiled anymore, are removed.
+     */
+    void commit(WindowsView windows);
+
+    void remove(const Window &window);
+
+    /**
+     * Find the closest window in the @p direction from the @p basis geometry,
+     * that overlaps it on the other axis. Of the equally close windows the
+     * most recently used one is chosen.
+     * @returns the neighbor or nullptr, if there is none
+     */
+    Window *neighbor(QRect basis, Direction direction, const RecencyFunction &recency) const;
+
+    /**
+     * @returns the geometry of the @p window at the last commit or nothing,
+     * if it is not in the index
+     */
+    std::optional<QRect> geometry(const Window &window) const;
+
+    std::size_t size() const;
+
+private:
+    /// Edges are ordered by their position, the windows with the same edges are in no particular order
+    using Edges = std::multimap<int, Window *>;
+
+    void insert(Window &window, QRect geometry);
+    void erase(const Window &window, QRect geometry);
+
+    std::unordered_map<const Window *, QRect> m_geometries{};
+    Edges m_leftEdges{};
+    Edges m_topEdges{};
+    Edges m_rightEdges{}; ///< x + width, as in the TS backend
+    Edges m_bottomEdges{}; ///< y + height, as in the TS backend
+};
+}
@@ -13,6 +13,11 @@ Surface::Surface(int desktop, int screen, const QString &activity)
 {
 }
 
+bool Surface::operator==(const Surface &rhs) const
+{
+    return m_desktop == rhs.m_desktop && m_screen == rhs.m_screen && m_activity == rhs.m_activity;
+}
+
 bool Surface::operator<(const Surface &rhs) const
 {
     if (m_screen < rhs.m_screen) {
@@ -11,6 +11,7 @@ namespace Bismuth
 struct Surface {
     Surface(int desktop, int screen, const QString &activity);
 
+    bool operator==(const Surface &) const;
     bool operator<(const Surface &) const;
 
     int desktop() const;
@@ -10,8 +10,9 @@
 namespace Bismuth
 {
 
-Window::Window(PlasmaApi::Client client, PlasmaApi::Workspace &workspace)
+Window::Window(PlasmaApi::ClientHandle client, PlasmaApi::Workspace &workspace)
     : m_client(client)
+    , m_snapshotCache(std::make_shared<ClientSnapshotCache>(client))
     , m_workspace(workspace)
 {
 }
@@ -33,12 +34,20 @@ void Window::activate()
 
 QRect Window::geometry() const
 {
-    return m_client.frameGeometry();
+    return snapshot().geometry;
 }
 
 void Window::setGeometry(QRect newGeometry)
 {
+    // Don't make KWin do the work again, if the window is already there
+    if (snapshot().geometry == newGeometry) {
+        return;
+    }
+
     m_client.setFrameGeometry(newGeometry);
+
+    // KWin might adjust the geometry, e.g. to respect the size constraints
+    m_snapshotCache->invalidateGeometry();
 }
 
 void Window::setMode(Mode value)
@@ -53,23 +62,25 @@ Window::Mode Window::mode() const
 
 bool Window::visibleOn(const Surface &surface)
 {
+    auto &client = snapshot();
+
     // All minimized windows are invisible by definition
-    if (m_client.minimized()) {
+    if (client.minimized) {
         return false;
     }
 
     // The window must be on the surface's desktop (or be on all desktops)
-    if (!m_client.onAllDesktops() && m_client.desktop() != surface.desktop()) {
+    if (!client.onAllDesktops && client.desktop != surface.desktop()) {
         return false;
     }
 
     // The window must be on the surface's screen
-    if (m_client.screen() != surface.screen()) {
+    if (client.screen != surface.screen()) {
         return false;
     }
 
     // The window must be on the surface's activity or on all activities
-    if (m_client.activities().size() != 0 && !m_client.activities().contains(surface.activity())) {
+    if (client.activities.size() != 0 && !client.activities.contains(surface.activity())) {
         return false;
     }
 
@@ -79,7 +90,7 @@ bool Window::visibleOn(const Surface &surface)
 std::vector<Surface> Window::surfaces() const
 {
     auto desktopsList = desktops();
-    auto screen = m_client.screen();
+    auto screen = snapshot().screen;
 
     auto activitiesList = activities();
 
@@ -100,12 +111,13 @@ std::vector<int> Window::desktops() const
     auto result = std::vector<int>();
     result.reserve(1);
 
-    if (m_client.onAllDesktops()) {
+    auto &client = snapshot();
+    if (client.onAllDesktops) {
         for (auto desktop = 1; desktop <= m_workspace.get().desktops(); desktop++) {
             result.push_back(desktop);
         }
     } else {
-        result.push_back(m_client.desktop());
+        result.push_back(client.desktop);
     }
 
     return result;
@@ -116,7 +128,8 @@ std::vector<QString> Window::activities() const
     auto result = std::vector<QString>();
     result.reserve(1);
 
-    auto activitiesList = m_client.activities().empty() ? m_workspace.get().activities() : m_client.activities();
+    auto &client = snapshot();
+    auto activitiesList = client.activities.empty() ? m_workspace.get().activities() : client.activities;
 
     for (auto activity : activitiesList) {
         result.push_back(activity);
@@ -130,4 +143,19 @@ QString Window::caption() const
     return m_client.caption();
 }
 
+const ClientSnapshot &Window::snapshot() const
+{
+    return m_snapshotCache->snapshot();
+}
+
+QMetaObject::Connection Window::onSurfacesChanged(std::function<void()> callback) const
+{
+    return QObject::connect(m_snapshotCache.get(), &ClientSnapshotCache::surfacesChanged, std::move(callback));
+}
+
+QMetaObject::Connection Window::onUserMoveResizeFinished(std::function<void()> callback) const
+{
+    return QObject::connect(m_snapshotCache.get(), &ClientSnapshotCache::userMoveResizeFinished, std::move(callback));
+}
+
 }
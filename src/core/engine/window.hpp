@@ -4,10 +4,12 @@
 #pragma once
 
 #include <functional>
+#include <memory>
 #include <vector>
 
+#include "engine/client_snapshot.hpp"
 #include "engine/surface.hpp"
-#include "plasma-api/client.hpp"
+#include "plasma-api/client_handle.hpp"
 #include "plasma-api/workspace.hpp"
 
 namespace Bismuth
@@ -21,7 +23,7 @@ struct Window {
         Tiled,
     };
 
-    Window(PlasmaApi::Client, PlasmaApi::Workspace &);
+    Window(PlasmaApi::ClientHandle, PlasmaApi::Workspace &);
 
     bool operator==(const Window &) const;
     bool operator<(const Window &rhs) const;
@@ -35,16 +37,36 @@ struct Window {
     Mode mode() const;
 
     bool visibleOn(const Surface &surface);
+
+    /**
+     * Surfaces the window is on, regardless of whether it is minimized
+     */
     std::vector<Surface> surfaces() const;
     std::vector<int> desktops() const;
     std::vector<QString> activities() const;
 
     QString caption() const;
 
+    /**
+     * Properties of the client, that are captured once and kept until the client changes
+     */
+    const ClientSnapshot &snapshot() const;
+
+    /**
+     * Call the @p callback, whenever the window might have moved to other surfaces
+     */
+    QMetaObject::Connection onSurfacesChanged(std::function<void()> callback) const;
+
+    /**
+     * Call the @p callback, whenever the user finishes moving or resizing the window
+     */
+    QMetaObject::Connection onUserMoveResizeFinished(std::function<void()> callback) const;
+
 private:
-    PlasmaApi::Client m_client;
+    PlasmaApi::ClientHandle m_client;
+    std::shared_ptr<ClientSnapshotCache> m_snapshotCache; ///< Shared by the copies of the window
     std::reference_wrapper<PlasmaApi::Workspace> m_workspace;
 
-    Mode m_mode;
+    Mode m_mode{Mode::Floating};
 };
 }
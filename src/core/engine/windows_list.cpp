@@ -3,7 +3,9 @@
 
 #include "windows_list.hpp"
 
-#include <functional>
+#include <algorithm>
+#include <iterator>
+#include <limits>
 
 #include "engine/surface.hpp"
 #include "logger.hpp"
@@ -11,45 +13,313 @@
 
 namespace Bismuth
 {
+namespace
+{
+/**
+ * Distance between the neighbors, when the ranks are spread. A window can be
+ * put between the same two windows 32 times, before the ranks run out.
+ */
+constexpr auto rankGap = std::uint64_t(1) << 32;
+}
 
 WindowsList::WindowsList(PlasmaApi::Workspace &workspace)
     : m_workspace(workspace)
 {
 }
 
-Window &WindowsList::add(PlasmaApi::Client client)
+WindowsList::~WindowsList()
 {
-    auto [it, _] = m_windowMap.insert_or_assign(client, Window(client, m_workspace));
-    return it->second;
+    // The windows might be still referenced elsewhere, so they must not call back
+    for (auto &[_, entry] : m_windows) {
+        QObject::disconnect(entry.surfacesChangedConnection);
+    }
+}
+
+Window &WindowsList::add(PlasmaApi::ClientHandle client)
+{
+    remove(client);
+
+    auto [it, _] = m_windows.try_emplace(client, Entry{Window(client, m_workspace)});
+    auto &entry = it->second;
+    m_entries[&entry.window] = &entry;
+
+    // The surfaces are not known yet, they get the window right after
+    place(entry, rankBefore(nullptr));
+
+    entry.surfacesChangedConnection = entry.window.onSurfacesChanged([this, client]() {
+        auto windowIt = m_windows.find(client);
+        if (windowIt != m_windows.end()) {
+            updateSurfaces(windowIt->second);
+        }
+    });
+    updateSurfaces(entry);
+
+    return entry.window;
 }
 
-void WindowsList::remove(PlasmaApi::Client client)
+void WindowsList::remove(PlasmaApi::ClientHandle client)
 {
-    m_windowMap.erase(client);
+    auto it = m_windows.find(client);
+    if (it == m_windows.end()) {
+        return;
+    }
+
+    QObject::disconnect(it->second.surfacesChangedConnection);
+    unplace(it->second);
+    removeFromSurfaces(it->second);
+    m_entries.erase(&it->second.window);
+    m_windows.erase(it);
 }
 
-std::optional<Window> WindowsList::activeWindow() const
+Window *WindowsList::find(PlasmaApi::ClientHandle client)
+{
+    auto it = m_windows.find(client);
+    return it != m_windows.end() ? &it->second.window : nullptr;
+}
+
+Window *WindowsList::activeWindow()
 {
     auto activeClient = m_workspace.activeClient();
 
     if (activeClient.has_value()) {
-        auto it = m_windowMap.find(activeClient.value());
-        if (it != m_windowMap.end()) {
-            return it->second;
+        auto it = m_windows.find(activeClient.value());
+        if (it != m_windows.end()) {
+            return &it->second.window;
+        }
+    }
+    return nullptr;
+}
+
+WindowsView WindowsList::visibleWindowsOn(const Surface &surface) const
+{
+    auto it = m_surfaceWindows.find(surface);
+    if (it == m_surfaceWindows.end()) {
+        return {};
+    }
+
+    auto &surfaceWindows = it->second;
+    if (surfaceWindows.viewOutdated) {
+        surfaceWindows.view.clear();
+        for (auto &[_, window] : surfaceWindows.windows) {
+            surfaceWindows.view.push_back(window);
+        }
+        surfaceWindows.viewOutdated = false;
+    }
+
+    return surfaceWindows.view;
+}
+
+Window *WindowsList::firstWindowOn(const Surface &surface)
+{
+    auto it = m_surfaceWindows.find(surface);
+    if (it == m_surfaceWindows.end() || it->second.windows.empty()) {
+        return nullptr;
+    }
+
+    return it->second.windows.begin()->second;
+}
+
+Window *WindowsList::nextWindowOn(const Surface &surface, const Window &window)
+{
+    auto windowEntry = entry(window);
+    auto it = m_surfaceWindows.find(surface);
+    if (!windowEntry || it == m_surfaceWindows.end()) {
+        return nullptr;
+    }
+
+    auto &windows = it->second.windows;
+    auto windowIt = windows.find(windowEntry->rank);
+    if (windowIt == windows.end()) {
+        return nullptr;
+    }
+
+    auto nextIt = std::next(windowIt);
+    return nextIt != windows.end() ? nextIt->second : windows.begin()->second;
+}
+
+Window *WindowsList::previousWindowOn(const Surface &surface, const Window &window)
+{
+    auto windowEntry = entry(window);
+    auto it = m_surfaceWindows.find(surface);
+    if (!windowEntry || it == m_surfaceWindows.end()) {
+        return nullptr;
+    }
+
+    auto &windows = it->second.windows;
+    auto windowIt = windows.find(windowEntry->rank);
+    if (windowIt == windows.end()) {
+        return nullptr;
+    }
+
+    return windowIt != windows.begin() ? std::prev(windowIt)->second : windows.rbegin()->second;
+}
+
+void WindowsList::swap(Window &first, Window &second)
+{
+    auto firstEntry = entry(first);
+    auto secondEntry = entry(second);
+    if (!firstEntry || !secondEntry || firstEntry == secondEntry) {
+        return;
+    }
+
+    auto firstRank = firstEntry->rank;
+    auto secondRank = secondEntry->rank;
+
+    unplace(*firstEntry);
+    unplace(*secondEntry);
+    place(*firstEntry, secondRank);
+    place(*secondEntry, firstRank);
+}
+
+void WindowsList::moveBefore(Window &window, const Window &target)
+{
+    auto windowEntry = entry(window);
+    auto targetEntry = entry(target);
+    if (!windowEntry || !targetEntry || windowEntry == targetEntry) {
+        return;
+    }
+
+    unplace(*windowEntry);
+    place(*windowEntry, rankBefore(targetEntry));
+}
+
+void WindowsList::moveAfter(Window &window, const Window &target)
+{
+    auto windowEntry = entry(window);
+    auto targetEntry = entry(target);
+    if (!windowEntry || !targetEntry || windowEntry == targetEntry) {
+        return;
+    }
+
+    unplace(*windowEntry);
+
+    auto nextIt = m_order.upper_bound(targetEntry->rank);
+    auto nextEntry = nextIt != m_order.end() ? nextIt->second : nullptr;
+    place(*windowEntry, rankBefore(nextEntry));
+}
+
+void WindowsList::pushToMaster(Window &window)
+{
+    auto windowEntry = entry(window);
+    if (!windowEntry) {
+        return;
+    }
+
+    unplace(*windowEntry);
+
+    auto firstEntry = m_order.empty() ? nullptr : m_order.begin()->second;
+    place(*windowEntry, rankBefore(firstEntry));
+}
+
+void WindowsList::updateSurfaces()
+{
+    for (auto &[_, entry] : m_windows) {
+        updateSurfaces(entry);
+    }
+}
+
+void WindowsList::updateSurfaces(Entry &entry)
+{
+    // All minimized windows are invisible by definition
+    auto surfaces = entry.window.snapshot().minimized ? std::vector<Surface>() : entry.window.surfaces();
+    std::sort(surfaces.begin(), surfaces.end());
+
+    if (surfaces == entry.surfaces) {
+        return;
+    }
+
+    removeFromSurfaces(entry);
+    for (auto &surface : surfaces) {
+        auto &surfaceWindows = m_surfaceWindows[surface];
+        surfaceWindows.windows.emplace(entry.rank, &entry.window);
+        surfaceWindows.viewOutdated = true;
+    }
+    entry.surfaces = std::move(surfaces);
+}
+
+void WindowsList::removeFromSurfaces(Entry &entry)
+{
+    for (auto &surface : entry.surfaces) {
+        auto &surfaceWindows = m_surfaceWindows[surface];
+        surfaceWindows.windows.erase(entry.rank);
+        surfaceWindows.viewOutdated = true;
+    }
+    entry.surfaces.clear();
+}
+
+WindowsList::Entry *WindowsList::entry(const Window &window)
+{
+    auto it = m_entries.find(&window);
+    return it != m_entries.end() ? it->second : nullptr;
+}
+
+void WindowsList::place(Entry &entry, Rank rank)
+{
+    entry.rank = rank;
+    m_order.emplace(rank, &entry);
+
+    for (auto &surface : entry.surfaces) {
+        auto &surfaceWindows = m_surfaceWindows[surface];
+        surfaceWindows.windows.emplace(rank, &entry.window);
+        surfaceWindows.viewOutdated = true;
+    }
+}
+
+void WindowsList::unplace(Entry &entry)
+{
+    m_order.erase(entry.rank);
+
+    for (auto &surface : entry.surfaces) {
+        auto &surfaceWindows = m_surfaceWindows[surface];
+        surfaceWindows.windows.erase(entry.rank);
+        surfaceWindows.viewOutdated = true;
+    }
+}
+
+WindowsList::Rank WindowsList::rankBefore(const Entry *next)
+{
+    while (true) {
+        auto nextIt = next ? m_order.find(next->rank) : m_order.end();
+        auto lower = nextIt == m_order.begin() ? Rank(0) : std::prev(nextIt)->first;
+
+        auto upper = std::numeric_limits<Rank>::max();
+        if (next) {
+            upper = next->rank;
+        } else if (lower < upper - 2 * rankGap) {
+            // At the end the window is a gap away from the last one, not halfway to the maximum
+            upper = lower + 2 * rankGap;
         }
+
+        if (upper - lower >= 2) {
+            return lower + (upper - lower) / 2;
+        }
+
+        // The ranks are far apart after that, so the next try succeeds
+        spreadRanks();
     }
-    return {};
 }
 
-std::vector<Window> WindowsList::visibleWindowsOn(const Surface &surface) const
+void WindowsList::spreadRanks()
 {
-    auto result = std::vector<Window>();
-    for (auto [_, window] : m_windowMap) {
-        if (window.visibleOn(surface)) {
-            result.push_back(window);
+    auto order = std::map<Rank, Entry *>();
+    auto rank = Rank(0);
+    for (auto &[_, entry] : m_order) {
+        rank += rankGap;
+        entry->rank = rank;
+        order.emplace_hint(order.end(), rank, entry);
+    }
+    m_order = std::move(order);
+
+    // The order stays the same, so the views are still valid
+    for (auto &[_, surfaceWindows] : m_surfaceWindows) {
+        surfaceWindows.windows.clear();
+    }
+    for (auto &[_, entry] : m_order) {
+        for (auto &surface : entry->surfaces) {
+            auto &windows = m_surfaceWindows[surface].windows;
+            windows.emplace_hint(windows.end(), entry->rank, &entry->window);
         }
     }
-    return result;
 }
 
 }
@@ -3,27 +3,133 @@
 
 #pragma once
 
-#include <optional>
+#include <QMetaObject>
+
+#include <cstdint>
+#include <map>
+#include <unordered_map>
+#include <vector>
 
 #include "engine/surface.hpp"
-#include "plasma-api/client.hpp"
+#include "engine/windows_view.hpp"
+#include "plasma-api/client_handle.hpp"
 #include "plasma-api/workspace.hpp"
 #include "window.hpp"
 
 namespace Bismuth
 {
+/**
+ * Managed windows in the tiling order. Like in the TS backend, there is a
+ * single order for all the windows, and each surface shows the windows
+ * visible on it in that order. The windows of each surface are updated as
+ * the windows move between surfaces.
+ */
 struct WindowsList {
     WindowsList(PlasmaApi::Workspace &);
+    ~WindowsList();
+
+    WindowsList(const WindowsList &) = delete;
+    WindowsList &operator=(const WindowsList &) = delete;
+
+    /**
+     * Add the window of the @p client to the end of the tiling order
+     */
+    Window &add(PlasmaApi::ClientHandle);
+    void remove(PlasmaApi::ClientHandle);
+
+    /**
+     * @returns the window of the @p client or nullptr, if it is not managed
+     */
+    Window *find(PlasmaApi::ClientHandle client);
+
+    /**
+     * @returns the active window or nullptr, if it is not managed
+     */
+    Window *activeWindow();
+
+    /**
+     * Windows visible on the @p surface in the tiling order
+     */
+    WindowsView visibleWindowsOn(const Surface &surface) const;
+
+    /**
+     * @returns the first window visible on the @p surface in the tiling order or nullptr
+     */
+    Window *firstWindowOn(const Surface &surface);
+
+    /**
+     * Step from the @p window to the next or the previous window visible on
+     * the @p surface in the tiling order, wrapping around at the ends
+     * @returns the window or nullptr, if the @p window is not visible on the @p surface
+     */
+    Window *nextWindowOn(const Surface &surface, const Window &window);
+    Window *previousWindowOn(const Surface &surface, const Window &window);
+
+    /**
+     * Swap the places of the windows in the tiling order
+     */
+    void swap(Window &first, Window &second);
 
-    Window &add(PlasmaApi::Client);
-    void remove(PlasmaApi::Client);
+    /**
+     * Put the @p window right before or right after the @p target in the tiling order
+     */
+    void moveBefore(Window &window, const Window &target);
+    void moveAfter(Window &window, const Window &target);
 
-    std::optional<Window> activeWindow() const;
+    /**
+     * Put the @p window first in the tiling order
+     */
+    void pushToMaster(Window &window);
 
-    std::vector<Window> visibleWindowsOn(const Surface &surface) const;
+    /**
+     * Find the surfaces of all the windows again. Needed, when the set of
+     * surfaces changes, e.g. a desktop is added.
+     */
+    void updateSurfaces();
 
 private:
-    std::map<PlasmaApi::Client, Window> m_windowMap{};
+    /// Ranks are spread apart, so that another one almost always fits between two neighbors
+    using Rank = std::uint64_t;
+
+    struct Entry {
+        Window window;
+        Rank rank{}; ///< Place in the tiling order
+        std::vector<Surface> surfaces{}; ///< Surfaces, where the window is visible
+        QMetaObject::Connection surfacesChangedConnection{};
+    };
+
+    struct SurfaceWindows {
+        std::map<Rank, Window *> windows{};
+
+        /// Contiguous copy of the windows for the views, made once the order changes
+        mutable std::vector<Window *> view{};
+        mutable bool viewOutdated{};
+    };
+
+    Entry *entry(const Window &window);
+
+    void updateSurfaces(Entry &);
+    void removeFromSurfaces(Entry &);
+
+    /**
+     * Put the @p entry into the order and into its surfaces with the @p rank
+     */
+    void place(Entry &entry, Rank rank);
+    void unplace(Entry &entry);
+
+    /**
+     * Find a free rank right before the @p next entry or at the end, if
+     * there is no @p next entry. Spreads all the ranks apart again, if they
+     * are too close.
+     */
+    Rank rankBefore(const Entry *next);
+    void spreadRanks();
+
+    /// Nodes are never relocated, so the surfaces refer to the windows by pointers
+    std::unordered_map<PlasmaApi::ClientHandle, Entry> m_windows{};
+    std::unordered_map<const Window *, Entry *> m_entries{};
+    std::map<Rank, Entry *> m_order{};
+    std::map<Surface, SurfaceWindows> m_surfaceWindows{};
 
     PlasmaApi::Workspace &m_workspace;
 };
@@ -0,0 +1,165 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+#include "engine/window.hpp"
+
+namespace Bismuth
+{
+/**
+ * Non-owning view of the windows, e.g. the ones visible on a surface. It is
+ * valid until the windows are added, removed, reordered or moved between the
+ * surfaces.
+ */
+class WindowsView
+{
+public:
+    class Iterator
+    {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = Window;
+        using difference_type = std::ptrdiff_t;
+        using pointer = Window *;
+        using reference = Window &;
+
+        Iterator() = default;
+        explicit Iterator(Window *const *ptr)
+            : m_ptr(ptr)
+        {
+        }
+
+        Window &operator*() const
+        {
+            return **m_ptr;
+        }
+
+        Window *operator->() const
+        {
+            return *m_ptr;
+        }
+
+        Window &operator[](difference_type offset) const
+        {
+            return *m_ptr[offset];
+        }
+
+        Iterator &operator++()
+        {
+            ++m_ptr;
+            return *this;
+        }
+
+        Iterator operator++(int)
+        {
+            auto result = *this;
+            ++m_ptr;
+            return result;
+        }
+
+        Iterator &operator--()
+        {
+            --m_ptr;
+            return *this;
+        }
+
+        Iterator operator--(int)
+        {
+            auto result = *this;
+            --m_ptr;
+            return result;
+        }
+
+        Iterator &operator+=(difference_type offset)
+        {
+            m_ptr += offset;
+            return *this;
+        }
+
+        Iterator &operator-=(difference_type offset)
+        {
+            m_ptr -= offset;
+            return *this;
+        }
+
+        Iterator operator+(difference_type offset) const
+        {
+            return Iterator(m_ptr + offset);
+        }
+
+        Iterator operator-(difference_type offset) const
+        {
+            return Iterator(m_ptr - offset);
+        }
+
+        difference_type operator-(const Iterator &rhs) const
+        {
+            return m_ptr - rhs.m_ptr;
+        }
+
+        bool operator==(const Iterator &rhs) const
+        {
+            return m_ptr == rhs.m_ptr;
+        }
+
+        bool operator!=(const Iterator &rhs) const
+        {
+            return m_ptr != rhs.m_ptr;
+        }
+
+        bool operator<(const Iterator &rhs) const
+        {
+            return m_ptr < rhs.m_ptr;
+        }
+
+    private:
+        Window *const *m_ptr{};
+    };
+
+    WindowsView() = default;
+    WindowsView(const std::vector<Window *> &windows)
+        : m_windows(windows.data())
+        , m_size(windows.size())
+    {
+    }
+
+    Iterator begin() const
+    {
+        return Iterator(m_windows);
+    }
+
+    Iterator end() const
+    {
+        return Iterator(m_windows + m_size);
+    }
+
+    std::size_t size() const
+    {
+        return m_size;
+    }
+
+    bool empty() const
+    {
+        return m_size == 0;
+    }
+
+    Window &operator[](std::size_t index) const
+    {
+        return *m_windows[index];
+    }
+
+    Window &front() const
+    {
+        return *m_windows[0];
+    }
+
+private:
+    Window *const *m_windows{};
+    std::size_t m_size{};
+};
+}
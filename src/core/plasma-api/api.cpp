@@ -15,6 +15,7 @@ Api::Api(QQmlEngine *engine)
     , m_workspace(engine->rootContext()->contextProperty(QStringLiteral("workspace")).value<QObject *>())
 {
     qRegisterMetaType<Client>();
+    qRegisterMetaType<ClientHandle>();
 };
 
 Workspace &Api::workspace()
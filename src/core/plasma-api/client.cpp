@@ -10,6 +10,9 @@ namespace PlasmaApi
 Client::Client(QObject *kwinImpl)
     : TopLevel(kwinImpl){};
 
+Client::Client(ClientHandle handle)
+    : TopLevel(handle.m_kwinImpl){};
+
 Client::Client(const Client &rhs)
     : TopLevel(rhs){};
 
@@ -23,4 +26,9 @@ bool Client::operator<(const Client &rhs) const
     return m_kwinImpl < rhs.m_kwinImpl;
 }
 
+ClientHandle Client::handle() const
+{
+    return ClientHandle(m_kwinImpl);
+}
+
 }
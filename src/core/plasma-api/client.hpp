@@ -6,8 +6,10 @@
 #include <QList>
 #include <QObject>
 #include <QRect>
+#include <QSize>
 #include <QString>
 
+#include "client_handle.hpp"
 #include "toplevel.hpp"
 #include "utils.hpp"
 
@@ -22,12 +24,18 @@ class Client : public TopLevel
 public:
     Client() = default;
     Client(QObject *kwinImpl);
+    explicit Client(ClientHandle);
     Client(const Client &);
     virtual ~Client() = default;
 
     bool operator==(const Client &rhs) const;
     bool operator<(const Client &rhs) const;
 
+    /**
+     * Lightweight reference to the same KWin client
+     */
+    ClientHandle handle() const;
+
     /**
      * The activities this client is on. If it's on all activities the property is empty.
      */
@@ -49,15 +57,15 @@ public:
     //  */
     // Q_PROPERTY(bool active READ active)
 
-    // /**
-    //  * Maximum allowed size for a window.
-    //  */
-    // Q_PROPERTY(QSize maxSize READ maxSize)
+    /**
+     * Maximum allowed size for a window.
+     */
+    BI_READONLY_PROPERTY(QSize, maxSize)
 
-    // /**
-    //  * Minimum allowed size for a window.
-    //  */
-    // Q_PROPERTY(QSize minSize READ minSize)
+    /**
+     * Minimum allowed size for a window.
+     */
+    BI_READONLY_PROPERTY(QSize, minSize)
 
     // /**
     //  * Whether the window is modal or not.
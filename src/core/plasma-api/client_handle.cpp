@@ -0,0 +1,54 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include "client_handle.hpp"
+
+#include <QMetaMethod>
+#include <QMetaProperty>
+
+#include <algorithm>
+
+namespace PlasmaApi
+{
+
+void ClientHandle::connectPropertyChanges(const std::vector<const char *> &properties, QObject *receiver, const char *slot) const
+{
+    auto implMeta = m_kwinImpl->metaObject();
+    auto receiverMeta = receiver->metaObject();
+    auto receiverSlot = receiverMeta->method(receiverMeta->indexOfSlot(QMetaObject::normalizedSignature(slot).constData()));
+
+    // Several properties may share the same notification signal
+    auto connectedSignals = std::vector<int>();
+    for (auto name : properties) {
+        auto property = implMeta->property(implMeta->indexOfProperty(name));
+        if (!property.hasNotifySignal()) {
+            continue;
+        }
+
+        auto signalIndex = property.notifySignalIndex();
+        if (std::find(connectedSignals.cbegin(), connectedSignals.cend(), signalIndex) != connectedSignals.cend()) {
+            continue;
+        }
+
+        QObject::connect(m_kwinImpl, property.notifySignal(), receiver, receiverSlot);
+        connectedSignals.push_back(signalIndex);
+    }
+}
+
+void ClientHandle::connectSignal(const char *signalName, QObject *receiver, const char *slot) const
+{
+    auto implMeta = m_kwinImpl->metaObject();
+    auto receiverMeta = receiver->metaObject();
+    auto receiverSlot = receiverMeta->method(receiverMeta->indexOfSlot(QMetaObject::normalizedSignature(slot).constData()));
+
+    // The arguments are KWin types, so the signal is found by its name only
+    for (auto i = 0; i < implMeta->methodCount(); i++) {
+        auto method = implMeta->method(i);
+        if (method.methodType() == QMetaMethod::Signal && method.name() == signalName) {
+            QObject::connect(m_kwinImpl, method, receiver, receiverSlot);
+            return;
+        }
+    }
+}
+
+}
@@ -0,0 +1,118 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QMetaType>
+#include <QObject>
+#include <QRect>
+#include <QSize>
+#include <QString>
+#include <QStringList>
+
+#include <functional>
+#include <type_traits>
+#include <vector>
+
+#include "utils.hpp"
+
+namespace PlasmaApi
+{
+/**
+ * Reference to a KWin client. Unlike Client, it is not a QObject, so copying
+ * it is copying a pointer. The identity of the handle is the identity of the
+ * KWin client.
+ *
+ * The accessors mirror the ones of Client.
+ */
+class ClientHandle
+{
+public:
+    ClientHandle() = default;
+    explicit ClientHandle(QObject *kwinImpl)
+        : m_kwinImpl(kwinImpl)
+    {
+    }
+
+    bool isNull() const
+    {
+        return m_kwinImpl == nullptr;
+    }
+
+    bool operator==(ClientHandle rhs) const
+    {
+        return m_kwinImpl == rhs.m_kwinImpl;
+    }
+
+    bool operator!=(ClientHandle rhs) const
+    {
+        return m_kwinImpl != rhs.m_kwinImpl;
+    }
+
+    bool operator<(ClientHandle rhs) const
+    {
+        return std::less<QObject *>()(m_kwinImpl, rhs.m_kwinImpl);
+    }
+
+    /**
+     * Invoke the @p slot of the @p receiver, whenever any of the @p properties
+     * of the KWin client changes. Properties without change notifications are
+     * skipped.
+     */
+    void connectPropertyChanges(const std::vector<const char *> &properties, QObject *receiver, const char *slot) const;
+
+    /**
+     * Invoke the @p slot of the @p receiver, whenever the KWin client emits
+     * the signal with the @p signalName. The arguments of the signal are
+     * dropped. The signal is skipped, if the client does not have it.
+     */
+    void connectSignal(const char *signalName, QObject *receiver, const char *slot) const;
+
+    BI_READONLY_PROPERTY(QStringList, activities)
+    BI_READONLY_PROPERTY(QString, caption)
+    BI_PROPERTY(QRect, frameGeometry, setFrameGeometry)
+    BI_READONLY_PROPERTY(QSize, maxSize)
+    BI_READONLY_PROPERTY(QSize, minSize)
+    BI_READONLY_PROPERTY(bool, specialWindow)
+    BI_PROPERTY(int, desktop, setDesktop)
+    BI_PROPERTY(bool, keepAbove, setKeepAbove)
+    BI_PROPERTY(bool, minimized, setMinimized)
+    BI_PROPERTY(bool, onAllDesktops, setOnAllDesktops)
+    BI_READONLY_PROPERTY(bool, dialog)
+    BI_READONLY_PROPERTY(QByteArray, resourceClass)
+    BI_READONLY_PROPERTY(QByteArray, resourceName)
+    BI_READONLY_PROPERTY(int, pid)
+    BI_READONLY_PROPERTY(int, screen)
+    BI_READONLY_PROPERTY(quint32, windowId)
+    BI_READONLY_PROPERTY(QByteArray, windowRole)
+
+private:
+    QObject *m_kwinImpl{};
+
+    friend uint qHash(ClientHandle handle, uint seed = 0)
+    {
+        return ::qHash(handle.m_kwinImpl, seed);
+    }
+
+    friend struct std::hash<ClientHandle>;
+    friend class Client;
+    friend class Workspace;
+};
+
+static_assert(std::is_trivially_copyable_v<ClientHandle>, "Client handles must be as cheap to pass around as pointers");
+}
+
+namespace std
+{
+template<>
+struct hash<PlasmaApi::ClientHandle> {
+    std::size_t operator()(PlasmaApi::ClientHandle handle) const noexcept
+    {
+        return std::hash<QObject *>()(handle.m_kwinImpl);
+    }
+};
+}
+
+Q_DECLARE_METATYPE(PlasmaApi::ClientHandle);
@@ -38,11 +38,15 @@ public:
      */
     BI_READONLY_PROPERTY(QByteArray, resourceClass)
 
-    // /**
-    //  * Window title
-    //  */
-    // Q_PROPERTY(QByteArray resourceName READ resourceName)
-    // QBYTEARRAY_PRIMITIVE_GET(resourceName)
+    /**
+     * Window instance name
+     */
+    BI_READONLY_PROPERTY(QByteArray, resourceName)
+
+    /**
+     * Id of the process owning the window
+     */
+    BI_READONLY_PROPERTY(int, pid)
 
     /**
      * On which screen toplevel is
@@ -60,19 +64,17 @@ public:
     //  */
     // Q_PROPERTY(bool utility READ utility)
     // BOOL_PRIMITIVE_GET(utility)
-    //
-    // /**
-    //  * Window id in KWin
-    //  */
-    // Q_PROPERTY(int windowId READ windowId)
-    // INT_PRIMITIVE_GET(windowId)
-    //
-    // /**
-    //  * Window role property
-    //  */
-    // Q_PROPERTY(QByteArray windowRole READ windowRole)
-    // QBYTEARRAY_PRIMITIVE_GET(windowRole)
-    //
+
+    /**
+     * Window id in KWin
+     */
+    BI_READONLY_PROPERTY(quint32, windowId)
+
+    /**
+     * Window role property
+     */
+    BI_READONLY_PROPERTY(QByteArray, windowRole)
+
     // /**
     //  * Client position
     //  */
@@ -3,21 +3,116 @@
 
 #pragma once
 
+#include <QMetaMethod>
+#include <QMetaProperty>
 #include <QObject>
 #include <QVariant>
 #include <iostream>
 
+#include <utility>
+#include <vector>
+
+namespace PlasmaApi
+{
+/**
+ * Method of the KWin implementation, that is resolved by its signature once
+ * per meta-object and then reused.
+ */
+class MethodCache
+{
+public:
+    /**
+     * @param signature method signature, that is normalized once here
+     */
+    explicit MethodCache(const char *signature)
+        : m_signature(QMetaObject::normalizedSignature(signature))
+    {
+    }
+
+    QMetaMethod method(const QMetaObject *implMeta)
+    {
+        // There is almost always a single KWin implementation, so the lookup is a single comparison
+        for (auto &entry : m_methods) {
+            if (entry.first == implMeta) {
+                return entry.second;
+            }
+        }
+
+        auto method = implMeta->method(implMeta->indexOfMethod(m_signature.constData()));
+        m_methods.emplace_back(implMeta, method);
+        return method;
+    }
+
+private:
+    QByteArray m_signature;
+    std::vector<std::pair<const QMetaObject *, QMetaMethod>> m_methods;
+};
+
+/**
+ * Property of the KWin implementation, that is resolved by its name once per
+ * meta-object and then reused.
+ */
+class PropertyCache
+{
+public:
+    /**
+     * @param name property name, that must outlive the cache, e.g. a string literal
+     */
+    explicit PropertyCache(const char *name)
+        : m_name(name)
+    {
+    }
+
+    QVariant read(const QObject *implObject)
+    {
+        auto property = this->property(implObject->metaObject());
+        // Dynamic properties are not in the meta-object
+        return property.isValid() ? property.read(implObject) : implObject->property(m_name);
+    }
+
+    void write(QObject *implObject, const QVariant &value)
+    {
+        auto property = this->property(implObject->metaObject());
+        if (property.isValid()) {
+            property.write(implObject, value);
+        } else {
+            implObject->setProperty(m_name, value);
+        }
+    }
+
+private:
+    QMetaProperty property(const QMetaObject *implMeta)
+    {
+        // Clients may have a few different implementations, but never many
+        for (auto &entry : m_properties) {
+            if (entry.first == implMeta) {
+                return entry.second;
+            }
+        }
+
+        auto property = implMeta->property(implMeta->indexOfProperty(m_name));
+        m_properties.emplace_back(implMeta, property);
+        return property;
+    }
+
+    const char *m_name;
+    std::vector<std::pair<const QMetaObject *, QMetaProperty>> m_properties;
+};
+}
+
 #define BI_PROPERTY(TYPE, NAME, SETTER_NAME)                                                                                                                   \
     Q_PROPERTY(TYPE NAME READ NAME WRITE SETTER_NAME);                                                                                                         \
                                                                                                                                                                \
     TYPE NAME() const                                                                                                                                          \
     {                                                                                                                                                          \
-        return m_kwinImpl->property(#NAME).value<TYPE>();                                                                                                      \
+        static auto propertyCache = PlasmaApi::PropertyCache(#NAME);                                                                                           \
+        return propertyCache.read(m_kwinImpl).value<TYPE>();                                                                                                   \
     }                                                                                                                                                          \
                                                                                                                                                                \
     void SETTER_NAME(const TYPE &value)                                                                                                                        \
     {                                                                                                                                                          \
-        m_kwinImpl->setProperty(#NAME, QVariant::fromValue(value));                                                                                            \
+        static auto propertyCache = PlasmaApi::PropertyCache(#NAME);                                                                                           \
+        propertyCache.write(m_kwinImpl, QVariant::fromValue(value));                                                                                           \
     }
 
 #define BI_READONLY_PROPERTY(TYPE, NAME)                                                                                                                       \
@@ -25,7 +120,8 @@
                                                                                                                                                                \
     TYPE NAME() const                                                                                                                                          \
     {                                                                                                                                                          \
-        return m_kwinImpl->property(#NAME).value<TYPE>();                                                                                                      \
+        static auto propertyCache = PlasmaApi::PropertyCache(#NAME);                                                                                           \
+        return propertyCache.read(m_kwinImpl).value<TYPE>();                                                                                                   \
     }
 
 /**
@@ -37,11 +133,10 @@
  */
 #define BI_METHOD_IMPL_WRAP(RET_TYPE, SIGNATURE, ...)                                                                                                          \
     {                                                                                                                                                          \
-        auto implMeta = m_kwinImpl->metaObject();                                                                                                              \
         /* Signature must not contain return value and cost status*/                                                                                           \
-        auto normSignature = QMetaObject::normalizedSignature(SIGNATURE);                                                                                      \
-        auto methodIndex = implMeta->indexOfMethod(normSignature);                                                                                             \
-        auto method = implMeta->method(methodIndex);                                                                                                           \
+        /* The method is resolved once per call site and KWin implementation */                                                                                \
+        static auto methodCache = PlasmaApi::MethodCache(SIGNATURE);                                                                                           \
+        auto method = methodCache.method(m_kwinImpl->metaObject());                                                                                            \
         auto result = RET_TYPE();                                                                                                                              \
         auto res = method.invoke(m_kwinImpl, Qt::DirectConnection, Q_RETURN_ARG(RET_TYPE, result), __VA_ARGS__);                                               \
         return result;                                                                                                                                         \
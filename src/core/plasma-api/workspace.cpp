@@ -3,6 +3,7 @@
 
 #include "workspace.hpp"
 
+#include <QMetaMethod>
 #include <QQmlContext>
 
 #include "logger.hpp"
@@ -26,13 +27,47 @@ Workspace::Workspace(const Workspace &rhs)
     wrapSignals();
 };
 
-std::optional<PlasmaApi::Client> Workspace::activeClient() const
+int Workspace::numScreens() const
+{
+    if (!m_topology.numScreens.has_value()) {
+        static auto propertyCache = PlasmaApi::PropertyCache("numScreens");
+        m_topology.numScreens = propertyCache.read(m_kwinImpl).value<int>();
+    }
+    return m_topology.numScreens.value();
+}
+
+QStringList Workspace::activities() const
+{
+    if (!m_topology.activities.has_value()) {
+        static auto propertyCache = PlasmaApi::PropertyCache("activities");
+        m_topology.activities = propertyCache.read(m_kwinImpl).value<QStringList>();
+    }
+    return m_topology.activities.value();
+}
+
+int Workspace::desktops() const
+{
+    if (!m_topology.desktops.has_value()) {
+        static auto propertyCache = PlasmaApi::PropertyCache("desktops");
+        m_topology.desktops = propertyCache.read(m_kwinImpl).value<int>();
+    }
+    return m_topology.desktops.value();
+}
+
+void Workspace::setDesktops(int desktops)
+{
+    static auto propertyCache = PlasmaApi::PropertyCache("desktops");
+    propertyCache.write(m_kwinImpl, QVariant::fromValue(desktops));
+    invalidateDesktops();
+}
+
+std::optional<PlasmaApi::ClientHandle> Workspace::activeClient() const
 {
     auto kwinClient = m_kwinImpl->property("activeClient").value<QObject *>();
-    return kwinClient ? PlasmaApi::Client(kwinClient) : std::optional<PlasmaApi::Client>();
+    return kwinClient ? PlasmaApi::ClientHandle(kwinClient) : std::optional<PlasmaApi::ClientHandle>();
 }
 
-void Workspace::setActiveClient(std::optional<PlasmaApi::Client> client)
+void Workspace::setActiveClient(std::optional<PlasmaApi::ClientHandle> client)
 {
     qDebug(Bi) << "omgwtf Workspace::setActiveClient";
     auto valueToSet = client.has_value() ? client->m_kwinImpl : nullptr;
@@ -41,6 +76,17 @@ void Workspace::setActiveClient(std::optional<PlasmaApi::Client> client)
 
 void Workspace::wrapSignals()
 {
+    // The cache must be up to date, when the wrapped signals are handled, so it goes first
+    auto invalidateOn = [this](const char *implSignalSignature, const char *slotSignature) {
+        connect(m_kwinImpl, QMetaObject::normalizedSignature(implSignalSignature), this, QMetaObject::normalizedSignature(slotSignature));
+    };
+
+    invalidateOn(SIGNAL(numberScreensChanged(int)), SLOT(invalidateScreens()));
+    invalidateOn(SIGNAL(screenResized(int)), SLOT(invalidateClientAreas()));
+    invalidateOn(SIGNAL(numberDesktopsChanged(uint)), SLOT(invalidateDesktops()));
+    invalidateOn(SIGNAL(activityAdded(const QString &)), SLOT(invalidateActivities()));
+    invalidateOn(SIGNAL(activityRemoved(const QString &)), SLOT(invalidateActivities()));
+
     auto wrapSimpleSignal = [this](const char *signalSignature) {
         auto signalsSignature = QMetaObject::normalizedSignature(signalSignature);
         connect(m_kwinImpl, signalsSignature, this, signalsSignature);
@@ -55,6 +101,9 @@ void Workspace::wrapSignals()
     wrapSimpleSignal(SIGNAL(numberScreensChanged(int)));
     wrapSimpleSignal(SIGNAL(screenResized(int)));
     wrapSimpleSignal(SIGNAL(currentActivityChanged(const QString &)));
+    wrapSimpleSignal(SIGNAL(numberDesktopsChanged(uint)));
+    wrapSimpleSignal(SIGNAL(activityAdded(const QString &)));
+    wrapSimpleSignal(SIGNAL(activityRemoved(const QString &)));
 
     wrapComplexSignal(SIGNAL(currentDesktopChanged(int, KWin::AbstractClient *)), SLOT(currentDesktopChangedTransformer(int, KWin::AbstractClient *)));
     wrapComplexSignal(SIGNAL(clientAdded(KWin::AbstractClient *)), SLOT(clientAddedTransformer(KWin::AbstractClient *)));
@@ -62,12 +111,29 @@ void Workspace::wrapSignals()
     wrapComplexSignal(SIGNAL(clientMinimized(KWin::AbstractClient *)), SLOT(clientMinimizedTransformer(KWin::AbstractClient *)));
     wrapComplexSignal(SIGNAL(clientUnminimized(KWin::AbstractClient *)), SLOT(clientUnminimizedTransformer(KWin::AbstractClient *)));
     wrapComplexSignal(SIGNAL(clientMaximizeSet(KWin::AbstractClient *, bool, bool)), SLOT(clientMaximizeSetTransformer(KWin::AbstractClient *, bool, bool)));
+    wrapComplexSignal(SIGNAL(clientActivated(KWin::AbstractClient *)), SLOT(clientActivatedTransformer(KWin::AbstractClient *)));
 };
 
 QRect Workspace::clientArea(ClientAreaOption option, int screen, int desktop)
 {
-    // qDebug(Bi) << "omgwtf Workspace::clientArea";
-    BI_METHOD_IMPL_WRAP(QRect, "clientArea(ClientAreaOption, int, int)", Q_ARG(ClientAreaOption, option), Q_ARG(int, screen), Q_ARG(int, desktop));
+    auto key = std::make_tuple(option, screen, desktop);
+    auto it = m_topology.clientAreas.find(key);
+    if (it != m_topology.clientAreas.end()) {
+        return it->second;
+    }
+
+    // The panels are needed only, once there is something to invalidate
+    if (!m_topology.docksWatched) {
+        watchExistingDocks();
+    }
+
+    auto apiCall = [&]() -> QRect {
+        BI_METHOD_IMPL_WRAP(QRect, "clientArea(ClientAreaOption, int, int)", Q_ARG(ClientAreaOption, option), Q_ARG(int, screen), Q_ARG(int, desktop));
+    };
+
+    auto area = apiCall();
+    m_topology.clientAreas.emplace(key, area);
+    return area;
 };
 
 // bool Workspace::setWindowHidden(QObject *client, bool isHidden)
@@ -128,7 +194,7 @@ bool Workspace::setWindowHidden(QObject *client, bool isHidden)
   return apiCallRes;
 };
 
-std::vector<PlasmaApi::Client> Workspace::clientList() const
+std::vector<PlasmaApi::ClientHandle> Workspace::clientList() const
 {
     qDebug(Bi) << "omgwtf Workspace::clientList";
     auto apiCall = [&]() -> QList<KWin::AbstractClient *> {
@@ -137,11 +203,11 @@ std::vector<PlasmaApi::Client> Workspace::clientList() const
 
     auto apiCallRes = apiCall();
 
-    auto result = std::vector<PlasmaApi::Client>();
+    auto result = std::vector<PlasmaApi::ClientHandle>();
     result.reserve(apiCallRes.size());
     for (auto clientPtr : apiCallRes) {
         if (clientPtr) {
-            result.push_back(Client(reinterpret_cast<QObject *>(clientPtr)));
+            result.push_back(ClientHandle(reinterpret_cast<QObject *>(clientPtr)));
         }
     }
 
@@ -151,38 +217,107 @@ std::vector<PlasmaApi::Client> Workspace::clientList() const
 void Workspace::currentDesktopChangedTransformer(int desktop, KWin::AbstractClient *kwinClient)
 {
     // Since we don't know the KWin internal implementation we have to use reinterpret_cast
-    auto clientWrapper = Client(reinterpret_cast<QObject *>(kwinClient));
-    Q_EMIT currentDesktopChanged(desktop, clientWrapper);
+    auto clientHandle = ClientHandle(reinterpret_cast<QObject *>(kwinClient));
+    Q_EMIT currentDesktopChanged(desktop, clientHandle);
 };
 
 void Workspace::clientAddedTransformer(KWin::AbstractClient *kwinClient)
 {
-    auto clientWrapper = Client(reinterpret_cast<QObject *>(kwinClient));
-    Q_EMIT clientAdded(clientWrapper);
+    watchDock(reinterpret_cast<QObject *>(kwinClient));
+
+    auto clientHandle = ClientHandle(reinterpret_cast<QObject *>(kwinClient));
+    Q_EMIT clientAdded(clientHandle);
 }
 
 void Workspace::clientRemovedTransformer(KWin::AbstractClient *kwinClient)
 {
-    auto clientWrapper = Client(reinterpret_cast<QObject *>(kwinClient));
-    Q_EMIT clientRemoved(clientWrapper);
+    auto kwinObject = reinterpret_cast<QObject *>(kwinClient);
+    if (kwinObject && kwinObject->property("dock").toBool()) {
+        invalidateClientAreas();
+    }
+
+    auto clientHandle = ClientHandle(kwinObject);
+    Q_EMIT clientRemoved(clientHandle);
 }
 
 void Workspace::clientMinimizedTransformer(KWin::AbstractClient *kwinClient)
 {
-    auto clientWrapper = Client(reinterpret_cast<QObject *>(kwinClient));
-    Q_EMIT clientMinimized(clientWrapper);
+    auto clientHandle = ClientHandle(reinterpret_cast<QObject *>(kwinClient));
+    Q_EMIT clientMinimized(clientHandle);
 }
 
 void Workspace::clientUnminimizedTransformer(KWin::AbstractClient *kwinClient)
 {
-    auto clientWrapper = Client(reinterpret_cast<QObject *>(kwinClient));
-    Q_EMIT clientUnminimized(clientWrapper);
+    auto clientHandle = ClientHandle(reinterpret_cast<QObject *>(kwinClient));
+    Q_EMIT clientUnminimized(clientHandle);
 }
 
 void Workspace::clientMaximizeSetTransformer(KWin::AbstractClient *kwinClient, bool h, bool v)
 {
-    auto clientWrapper = Client(reinterpret_cast<QObject *>(kwinClient));
-    Q_EMIT clientMaximizeSet(clientWrapper, h, v);
+    auto clientHandle = ClientHandle(reinterpret_cast<QObject *>(kwinClient));
+    Q_EMIT clientMaximizeSet(clientHandle, h, v);
+}
+
+void Workspace::clientActivatedTransformer(KWin::AbstractClient *kwinClient)
+{
+    // KWin reports the loss of the focus with the null client
+    if (!kwinClient) {
+        return;
+    }
+
+    auto clientHandle = ClientHandle(reinterpret_cast<QObject *>(kwinClient));
+    Q_EMIT clientActivated(clientHandle);
+}
+
+void Workspace::invalidateScreens()
+{
+    m_topology.numScreens.reset();
+    invalidateClientAreas();
+}
+
+void Workspace::invalidateDesktops()
+{
+    m_topology.desktops.reset();
+    invalidateClientAreas();
+}
+
+void Workspace::invalidateActivities()
+{
+    m_topology.activities.reset();
+}
+
+void Workspace::invalidateClientAreas()
+{
+    m_topology.clientAreas.clear();
+}
+
+void Workspace::watchDock(QObject *kwinClient)
+{
+    if (!kwinClient || !kwinClient->property("dock").toBool()) {
+        return;
+    }
+
+    // A new panel takes its space right away
+    invalidateClientAreas();
+
+    // The arguments of the signal differ between the KWin versions, so it is found by its name
+    auto meta = kwinClient->metaObject();
+    for (auto i = 0; i < meta->methodCount(); i++) {
+        auto method = meta->method(i);
+        if (method.methodType() == QMetaMethod::Signal && method.name() == "frameGeometryChanged") {
+            auto slot = metaObject()->method(metaObject()->indexOfSlot("invalidateClientAreas()"));
+            connect(kwinClient, method, this, slot, Qt::UniqueConnection);
+            break;
+        }
+    }
+}
+
+void Workspace::watchExistingDocks()
+{
+    m_topology.docksWatched = true;
+    for (auto &client : clientList()) {
+        watchDock(client.m_kwinImpl);
+    }
 }
 
 }
@@ -5,10 +5,15 @@
 
 #include <QObject>
 #include <QQmlEngine>
+#include <QRect>
+#include <QStringList>
 
+#include <map>
 #include <optional>
+#include <tuple>
 
 #include "plasma-api/client.hpp"
+#include "plasma-api/client_handle.hpp"
 
 #include "utils.hpp"
 
@@ -39,24 +44,35 @@ public:
     Workspace(QObject *implPtr);
     Workspace(const Workspace &);
 
-    BI_READONLY_PROPERTY(int, numScreens);
     BI_READONLY_PROPERTY(int, activeScreen);
-    BI_READONLY_PROPERTY(QStringList, activities);
 
     BI_PROPERTY(int, currentDesktop, setCurrentDesktop);
     BI_PROPERTY(QString, currentActivity, setCurrentActivity);
-    BI_PROPERTY(int, desktops, setDesktops);
 
-    Q_PROPERTY(std::optional<PlasmaApi::Client> activeClient READ activeClient WRITE setActiveClient);
+    /**
+     * Topology of the workspace. It is read from KWin once and then cached,
+     * until KWin reports, that it changed.
+     */
+    Q_PROPERTY(int numScreens READ numScreens);
+    Q_PROPERTY(QStringList activities READ activities);
+    Q_PROPERTY(int desktops READ desktops WRITE setDesktops);
+
+    int numScreens() const;
+    QStringList activities() const;
+    int desktops() const;
+    void setDesktops(int desktops);
 
-    std::optional<PlasmaApi::Client> activeClient() const;
-    void setActiveClient(std::optional<PlasmaApi::Client> client);
+    Q_PROPERTY(std::optional<PlasmaApi::ClientHandle> activeClient READ activeClient WRITE setActiveClient);
+
+    std::optional<PlasmaApi::ClientHandle> activeClient() const;
+    void setActiveClient(std::optional<PlasmaApi::ClientHandle> client);
 
     /**
      * Returns the geometry a Client can use with the specified option.
      * This method should be preferred over other methods providing screen sizes as the
      * various options take constraints such as struts set on panels into account.
      * This method is also multi screen aware, but there are also options to get full areas.
+     * The areas are cached, until the screens, the number of desktops or the panels change.
      * @param option The type of area which should be considered
      * @param screen The screen for which the area should be considered
      * @param desktop The desktop for which the area should be considered, in general there should not be a difference
@@ -68,7 +84,7 @@ public:
     Q_INVOKABLE bool setWindowHidden(QObject *client, bool isHidden);
     Q_INVOKABLE bool isWindowHidden(QObject *client);
 
-    Q_INVOKABLE std::vector<PlasmaApi::Client> clientList() const;
+    Q_INVOKABLE std::vector<PlasmaApi::ClientHandle> clientList() const;
 
 private Q_SLOTS:
     void currentDesktopChangedTransformer(int desktop, KWin::AbstractClient *kwinClient);
@@ -77,9 +93,15 @@ private Q_SLOTS:
     void clientMinimizedTransformer(KWin::AbstractClient *);
     void clientUnminimizedTransformer(KWin::AbstractClient *);
     void clientMaximizeSetTransformer(KWin::AbstractClient *, bool h, bool v);
+    void clientActivatedTransformer(KWin::AbstractClient *);
+
+    void invalidateScreens();
+    void invalidateDesktops();
+    void invalidateActivities();
+    void invalidateClientAreas();
 
 Q_SIGNALS:
-    void currentDesktopChanged(int desktop, PlasmaApi::Client kwinClient);
+    void currentDesktopChanged(int desktop, PlasmaApi::ClientHandle kwinClient);
 
     /**
      * Signal emitted when the number of screens changes.
@@ -95,26 +117,58 @@ Q_SIGNALS:
      */
     void screenResized(int screen);
 
+    /**
+     * Signal emitted, when the number of the desktops changes
+     * @param oldNumberOfDesktops The previous number of the desktops
+     */
+    void numberDesktopsChanged(uint oldNumberOfDesktops);
+
+    void activityAdded(const QString &id);
+
+    void activityRemoved(const QString &id);
+
     /**
      * Signal emitted whenever the current activity changed.
      * @param id id of the new activity
      */
     void currentActivityChanged(const QString &id);
 
-    void clientAdded(PlasmaApi::Client client);
+    void clientAdded(PlasmaApi::ClientHandle client);
 
-    void clientRemoved(PlasmaApi::Client client);
+    void clientRemoved(PlasmaApi::ClientHandle client);
 
-    void clientMinimized(PlasmaApi::Client client);
+    void clientMinimized(PlasmaApi::ClientHandle client);
 
-    void clientUnminimized(PlasmaApi::Client client);
+    void clientUnminimized(PlasmaApi::ClientHandle client);
 
-    void clientMaximizeSet(PlasmaApi::Client client, bool h, bool v);
+    void clientMaximizeSet(PlasmaApi::ClientHandle client, bool h, bool v);
+
+    /**
+     * Signal emitted, when a client gets the focus. Not emitted, when the
+     * focus is lost and no client has it.
+     */
+    void clientActivated(PlasmaApi::ClientHandle client);
 
 private:
+    struct Topology {
+        std::optional<int> numScreens{};
+        std::optional<int> desktops{};
+        std::optional<QStringList> activities{};
+        std::map<std::tuple<ClientAreaOption, int, int>, QRect> clientAreas{}; ///< By option, screen and desktop
+        bool docksWatched{};
+    };
+
     void wrapSignals();
 
+    /**
+     * Panels reserve the space of the screen edges, so the client areas
+     * change with them
+     */
+    void watchDock(QObject *kwinClient);
+    void watchExistingDocks();
+
     QObject *m_kwinImpl;
+    mutable Topology m_topology{};
 };
 
 }
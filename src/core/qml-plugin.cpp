@@ -48,6 +48,7 @@ void Core::init()
     m_controller = std::make_unique<Bismuth::Controller>(*m_plasmaApi, *m_engine, *m_config);
     m_tsProxy = std::make_unique<TSProxy>(m_qmlEngine, *m_controller, *m_plasmaApi, *m_config);
     m_controller->setProxy(m_tsProxy.get());
+    m_engine->setStateStore(m_tsProxy->stateStore());
 }
 
 TSProxy *Core::tsProxy() const
@@ -0,0 +1,47 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <QByteArray>
+#include <QtGlobal>
+
+#include <array>
+
+namespace Bismuth
+{
+namespace Detail
+{
+constexpr std::array<quint32, 256> crc32Table()
+{
+    auto table = std::array<quint32, 256>{};
+    for (quint32 i = 0; i < 256; i++) {
+        auto value = i;
+        for (auto bit = 0; bit < 8; bit++) {
+            value = (value & 1) ? 0xEDB88320u ^ (value >> 1) : value >> 1;
+        }
+        table[i] = value;
+    }
+    return table;
+}
+}
+
+/**
+ * CRC-32 checksum of the @p data. Used to detect torn and corrupted state files.
+ */
+inline quint32 crc32(const char *data, qint64 size)
+{
+    static constexpr auto table = Detail::crc32Table();
+
+    auto value = 0xFFFFFFFFu;
+    for (qint64 i = 0; i < size; i++) {
+        value = table[(value ^ static_cast<quint8>(data[i])) & 0xFFu] ^ (value >> 8);
+    }
+    return value ^ 0xFFFFFFFFu;
+}
+
+inline quint32 crc32(const QByteArray &data)
+{
+    return crc32(data.constData(), data.size());
+}
+}
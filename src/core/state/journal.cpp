@@ -0,0 +1,147 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include "journal.hpp"
+
+#include <QtEndian>
+
+#include "logger.hpp"
+#include "state/checksum.hpp"
+
+namespace Bismuth
+{
+namespace
+{
+// Each record is prefixed with its payload size and the payload checksum
+constexpr qint64 frameHeaderSize = 2 * sizeof(quint32);
+
+// Anything bigger is garbage, not a record
+constexpr quint32 maxRecordSize = 16 * 1024 * 1024;
+}
+
+QByteArray StateRecord::serialize() const
+{
+    auto result = QByteArray();
+    auto stream = QDataStream(&result, QIODevice::WriteOnly);
+    stream.setVersion(stateStreamVersion);
+    stream << static_cast<quint8>(kind) << key << value;
+    return result;
+}
+
+std::optional<StateRecord> StateRecord::deserialize(const QByteArray &data)
+{
+    auto stream = QDataStream(data);
+    stream.setVersion(stateStreamVersion);
+    auto kindValue = quint8();
+    auto result = StateRecord();
+
+    stream >> kindValue >> result.key >> result.value;
+    if (stream.status() != QDataStream::Ok) {
+        return {};
+    }
+
+    result.kind = static_cast<Kind>(kindValue);
+    return result;
+}
+
+Journal::Journal(const QString &path)
+    : m_file(path)
+{
+}
+
+std::vector<StateRecord> Journal::replay()
+{
+    m_file.close();
+
+    auto result = std::vector<StateRecord>();
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        openForAppend();
+        return result;
+    }
+
+    auto data = m_file.readAll();
+    m_file.close();
+
+    auto offset = qint64(0);
+    while (offset + frameHeaderSize <= data.size()) {
+        auto header = data.constData() + offset;
+        auto payloadSize = qFromLittleEndian<quint32>(header);
+        auto payloadChecksum = qFromLittleEndian<quint32>(header + sizeof(quint32));
+
+        if (payloadSize > maxRecordSize || offset + frameHeaderSize + payloadSize > data.size()) {
+            break;
+        }
+
+        auto payload = QByteArray::fromRawData(header + frameHeaderSize, payloadSize);
+        if (crc32(payload) != payloadChecksum) {
+            break;
+        }
+
+        auto record = StateRecord::deserialize(payload);
+        if (!record.has_value()) {
+            break;
+        }
+
+        result.push_back(std::move(record.value()));
+        offset += frameHeaderSize + payloadSize;
+    }
+
+    if (offset != data.size()) {
+        qWarning(Bi) << "Discarding the torn tail of the journal:" << data.size() - offset << "bytes";
+        QFile::resize(m_file.fileName(), offset);
+    }
+
+    openForAppend();
+    return result;
+}
+
+bool Journal::append(const std::vector<StateRecord> &records)
+{
+    if (!m_file.isOpen() && !openForAppend()) {
+        return false;
+    }
+
+    auto data = QByteArray();
+    for (auto &record : records) {
+        auto payload = record.serialize();
+
+        char header[frameHeaderSize];
+        qToLittleEndian<quint32>(payload.size(), header);
+        qToLittleEndian<quint32>(crc32(payload), header + sizeof(quint32));
+
+        data.append(header, frameHeaderSize);
+        data.append(payload);
+    }
+
+    if (m_file.write(data) != data.size() || !m_file.flush()) {
+        qWarning(Bi) << "Failed to append to the journal" << m_file.fileName() << m_file.errorString();
+        return false;
+    }
+
+    return true;
+}
+
+void Journal::clear()
+{
+    if (!m_file.isOpen() && !openForAppend()) {
+        return;
+    }
+
+    m_file.resize(0);
+}
+
+qint64 Journal::size() const
+{
+    return m_file.size();
+}
+
+bool Journal::openForAppend()
+{
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qWarning(Bi) << "Failed to open the journal" << m_file.fileName() << m_file.errorString();
+        return false;
+    }
+
+    return true;
+}
+}
@@ -0,0 +1,106 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <QByteArray>
+#include <QDataStream>
+#include <QFile>
+#include <QHash>
+#include <QString>
+
+#include <optional>
+#include <vector>
+
+namespace Bismuth
+{
+/// Serialization format of the persisted values. Must not depend on the Qt version KWin runs with.
+constexpr auto stateStreamVersion = QDataStream::Qt_5_15;
+
+/**
+ * Serialize the @p value in the format of the persisted values
+ */
+template<typename T>
+QByteArray toBytes(const T &value)
+{
+    auto result = QByteArray();
+    auto stream = QDataStream(&result, QIODevice::WriteOnly);
+    stream.setVersion(stateStreamVersion);
+    stream << value;
+    return result;
+}
+
+template<typename T>
+T fromBytes(const QByteArray &data)
+{
+    auto stream = QDataStream(data);
+    stream.setVersion(stateStreamVersion);
+    auto result = T();
+    stream >> result;
+    return result;
+}
+
+/**
+ * Single change of the persisted tiling state. Records carry the new value of
+ * the entry, not the difference, so replaying the same record twice is harmless.
+ */
+struct StateRecord {
+    enum class Kind : quint8 {
+        WindowState = 1,
+        SurfaceGroup,
+        LayoutState,
+        WindowList,
+        WindowStateRemoved, ///< The state of the closed window is forgotten. The value is empty.
+        WindowSeen, ///< The window was closed. The value is the sequence number of the closing.
+        WindowOrder,
+    };
+
+    Kind kind{};
+    QString key{};
+    QByteArray value{}; ///< Serialized value of the entry. The format depends on the kind.
+
+    QByteArray serialize() const;
+    static std::optional<StateRecord> deserialize(const QByteArray &);
+};
+
+inline uint qHash(StateRecord::Kind kind, uint seed = 0)
+{
+    return ::qHash(static_cast<quint8>(kind), seed);
+}
+
+/**
+ * Append-only log of the state changes. Each record is framed with its size and
+ * checksum, so a record torn by a crash is detected and discarded on replay.
+ */
+class Journal
+{
+public:
+    explicit Journal(const QString &path);
+
+    /**
+     * Read all the intact records. The torn tail, if any, is cut off the file,
+     * so that the new records are appended right after the last intact one.
+     */
+    std::vector<StateRecord> replay();
+
+    /**
+     * Append the @p records with a single write
+     */
+    bool append(const std::vector<StateRecord> &records);
+
+    /**
+     * Drop all the records. Used after the records are compacted into a snapshot.
+     */
+    void clear();
+
+    /**
+     * Size of the journal in bytes
+     */
+    qint64 size() const;
+
+private:
+    bool openForAppend();
+
+    QFile m_file;
+};
+}
@@ -0,0 +1,67 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include "layout_state.hpp"
+
+#include "state/journal.hpp"
+
+namespace Bismuth
+{
+bool LayoutState::operator==(const LayoutState &rhs) const
+{
+    return classId == rhs.classId && rotation == rhs.rotation && masterCount == rhs.masterCount && masterRatio == rhs.masterRatio;
+}
+
+bool LayoutState::operator!=(const LayoutState &rhs) const
+{
+    return !(*this == rhs);
+}
+
+QJsonObject LayoutState::toJson() const
+{
+    // The keys are the ones the legacy TS backend uses
+    auto result = QJsonObject();
+    if (!classId.isEmpty()) {
+        result.insert(QStringLiteral("classID"), classId);
+    }
+    result.insert(QStringLiteral("rotation"), rotation);
+    result.insert(QStringLiteral("numMasterTiles"), masterCount);
+    result.insert(QStringLiteral("masterRatio"), masterRatio);
+    return result;
+}
+
+LayoutState LayoutState::fromJson(const QJsonObject &json)
+{
+    auto result = LayoutState();
+    result.classId = json.value(QStringLiteral("classID")).toString();
+    result.rotation = json.value(QStringLiteral("rotation")).toInt(result.rotation);
+    result.masterCount = json.value(QStringLiteral("numMasterTiles")).toInt(result.masterCount);
+    result.masterRatio = json.value(QStringLiteral("masterRatio")).toDouble(result.masterRatio);
+    return result;
+}
+
+QByteArray LayoutState::serialize() const
+{
+    return toBytes(*this);
+}
+
+LayoutState LayoutState::deserialize(const QByteArray &data)
+{
+    return fromBytes<LayoutState>(data);
+}
+
+QDataStream &operator<<(QDataStream &stream, const LayoutState &state)
+{
+    return stream << state.classId << static_cast<qint32>(state.rotation) << static_cast<qint32>(state.masterCount) << state.masterRatio;
+}
+
+QDataStream &operator>>(QDataStream &stream, LayoutState &state)
+{
+    auto rotation = qint32();
+    auto masterCount = qint32();
+    stream >> state.classId >> rotation >> masterCount >> state.masterRatio;
+    state.rotation = rotation;
+    state.masterCount = masterCount;
+    return stream;
+}
+}
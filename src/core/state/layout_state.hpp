@@ -0,0 +1,34 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <QByteArray>
+#include <QDataStream>
+#include <QJsonObject>
+#include <QString>
+
+namespace Bismuth
+{
+/**
+ * Persisted parameters of a layout
+ */
+struct LayoutState {
+    QString classId{};
+    int rotation{}; ///< Rotation angle in degrees: 0, 90, 180 or 270
+    int masterCount{1};
+    double masterRatio{0.5}; ///< Share of the area taken by the master windows
+
+    bool operator==(const LayoutState &) const;
+    bool operator!=(const LayoutState &) const;
+
+    QJsonObject toJson() const;
+    static LayoutState fromJson(const QJsonObject &);
+
+    QByteArray serialize() const;
+    static LayoutState deserialize(const QByteArray &);
+};
+
+QDataStream &operator<<(QDataStream &, const LayoutState &);
+QDataStream &operator>>(QDataStream &, LayoutState &);
+}
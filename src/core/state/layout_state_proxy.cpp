@@ -0,0 +1,64 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include "layout_state_proxy.hpp"
+
+#include "state/state_store.hpp"
+
+namespace Bismuth
+{
+LayoutStateProxy::LayoutStateProxy(StateStore &store, const QString &layoutId, QObject *parent)
+    : QObject(parent)
+    , m_store(store)
+    , m_layoutId(layoutId)
+{
+}
+
+QString LayoutStateProxy::classId() const
+{
+    return m_store.layoutState(m_layoutId).classId;
+}
+
+void LayoutStateProxy::setClassId(const QString &classId)
+{
+    auto state = m_store.layoutState(m_layoutId);
+    state.classId = classId;
+    m_store.setLayoutState(m_layoutId, state);
+}
+
+int LayoutStateProxy::rotation() const
+{
+    return m_store.layoutState(m_layoutId).rotation;
+}
+
+void LayoutStateProxy::setRotation(int rotation)
+{
+    auto state = m_store.layoutState(m_layoutId);
+    state.rotation = rotation;
+    m_store.setLayoutState(m_layoutId, state);
+}
+
+int LayoutStateProxy::masterCount() const
+{
+    return m_store.layoutState(m_layoutId).masterCount;
+}
+
+void LayoutStateProxy::setMasterCount(int masterCount)
+{
+    auto state = m_store.layoutState(m_layoutId);
+    state.masterCount = masterCount;
+    m_store.setLayoutState(m_layoutId, state);
+}
+
+double LayoutStateProxy::masterRatio() const
+{
+    return m_store.layoutState(m_layoutId).masterRatio;
+}
+
+void LayoutStateProxy::setMasterRatio(double masterRatio)
+{
+    auto state = m_store.layoutState(m_layoutId);
+    state.masterRatio = masterRatio;
+    m_store.setLayoutState(m_layoutId, state);
+}
+}
@@ -0,0 +1,47 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <QObject>
+#include <QString>
+
+namespace Bismuth
+{
+class StateStore;
+
+/**
+ * Layout state of a surface for the legacy TS backend. Reads are answered
+ * from the state store in memory, writes reach the store only if the value
+ * actually changes.
+ *
+ * The property names are the ones the TS backend used in its JSON state.
+ */
+class LayoutStateProxy : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(QString classID READ classId WRITE setClassId)
+    Q_PROPERTY(int rotation READ rotation WRITE setRotation)
+    Q_PROPERTY(int numMasterTiles READ masterCount WRITE setMasterCount)
+    Q_PROPERTY(double masterRatio READ masterRatio WRITE setMasterRatio)
+
+public:
+    LayoutStateProxy(StateStore &store, const QString &layoutId, QObject *parent = nullptr);
+
+    QString classId() const;
+    void setClassId(const QString &);
+
+    int rotation() const;
+    void setRotation(int);
+
+    int masterCount() const;
+    void setMasterCount(int);
+
+    double masterRatio() const;
+    void setMasterRatio(double);
+
+private:
+    StateStore &m_store;
+    QString m_layoutId;
+};
+}
@@ -0,0 +1,160 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include "persistence_worker.hpp"
+
+#include <QSaveFile>
+
+#include "logger.hpp"
+
+namespace Bismuth
+{
+PersistenceWorker::PersistenceWorker(const QString &journalPath, const QString &snapshotPath)
+    : m_journal(journalPath)
+    , m_snapshotPath(snapshotPath)
+    , m_queue()
+    , m_wakeUp()
+    , m_thread()
+{
+}
+
+PersistenceWorker::~PersistenceWorker()
+{
+    if (!m_thread) {
+        return;
+    }
+
+    m_stopping.store(true);
+    m_wakeUp.release();
+    m_thread->wait();
+}
+
+std::vector<StateRecord> PersistenceWorker::replay()
+{
+    auto result = m_journal.replay();
+    m_journalSize.store(m_journal.size());
+    return result;
+}
+
+void PersistenceWorker::start()
+{
+    m_thread.reset(QThread::create([this]() {
+        run();
+    }));
+    m_thread->setObjectName(QStringLiteral("Bismuth State Writer"));
+    m_thread->start(QThread::LowPriority);
+}
+
+bool PersistenceWorker::submit(std::vector<StateRecord> &records)
+{
+    auto task = PersistenceTask();
+    task.kind = PersistenceTask::Kind::Append;
+    task.records = std::move(records);
+
+    if (!enqueue(std::move(task))) {
+        records = std::move(task.records);
+        return false;
+    }
+
+    records.clear();
+    return true;
+}
+
+bool PersistenceWorker::submitSnapshot(const QByteArray &snapshot)
+{
+    auto task = PersistenceTask();
+    task.kind = PersistenceTask::Kind::Snapshot;
+    task.snapshot = snapshot;
+    return enqueue(std::move(task));
+}
+
+void PersistenceWorker::flush()
+{
+    if (!m_thread) {
+        return;
+    }
+
+    auto done = QSemaphore();
+
+    auto task = PersistenceTask();
+    task.kind = PersistenceTask::Kind::Barrier;
+    task.done = &done;
+
+    // The queue only stays full, while the worker is busy emptying it
+    while (!enqueue(std::move(task))) {
+        QThread::yieldCurrentThread();
+    }
+
+    done.acquire();
+}
+
+qint64 PersistenceWorker::journalSize() const
+{
+    return m_journalSize.load(std::memory_order_relaxed);
+}
+
+bool PersistenceWorker::enqueue(PersistenceTask &&task)
+{
+    if (!m_queue.push(std::move(task))) {
+        return false;
+    }
+
+    m_wakeUp.release();
+    return true;
+}
+
+void PersistenceWorker::run()
+{
+    while (true) {
+        m_wakeUp.acquire();
+
+        // Read before draining: everything submitted before the stop request is then visible
+        auto stopping = m_stopping.load();
+
+        while (auto task = m_queue.pop()) {
+            process(task.value());
+        }
+
+        if (stopping) {
+            return;
+        }
+    }
+}
+
+void PersistenceWorker::process(PersistenceTask &task)
+{
+    switch (task.kind) {
+    case PersistenceTask::Kind::Append:
+        m_journal.append(task.records);
+        break;
+    case PersistenceTask::Kind::Snapshot:
+        writeSnapshot(task.snapshot);
+        break;
+    case PersistenceTask::Kind::Barrier:
+        task.done->release();
+        break;
+    }
+
+    m_journalSize.store(m_journal.size(), std::memory_order_relaxed);
+}
+
+void PersistenceWorker::writeSnapshot(const QByteArray &snapshot)
+{
+    auto file = QSaveFile(m_snapshotPath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning(Bi) << "Failed to open the state snapshot" << m_snapshotPath << file.errorString();
+        return;
+    }
+
+    file.write(snapshot);
+
+    // The old snapshot stays in place, until the new one is completely written
+    if (!file.commit()) {
+        qWarning(Bi) << "Failed to write the state snapshot" << m_snapshotPath << file.errorString();
+        return;
+    }
+
+    m_journal.clear();
+    qDebug(Bi) << "State snapshot is compacted, size:" << snapshot.size() << "bytes";
+}
+}
@@ -0,0 +1,100 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <QByteArray>
+#include <QSemaphore>
+#include <QString>
+#include <QThread>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "state/journal.hpp"
+#include "state/spsc_queue.hpp"
+
+namespace Bismuth
+{
+/**
+ * Unit of work for the persistence thread
+ */
+struct PersistenceTask {
+    enum class Kind {
+        Append, ///< Append the records to the journal
+        Snapshot, ///< Replace the snapshot and empty the journal
+        Barrier, ///< Signal, that all the previous tasks are done
+    };
+
+    Kind kind{};
+    std::vector<StateRecord> records{};
+    QByteArray snapshot{}; ///< Complete contents of the snapshot file
+    QSemaphore *done{};
+};
+
+/**
+ * Writes the state to disk on its own thread, so that KWin's main thread,
+ * which also drives compositing, never waits for the file system.
+ *
+ * Work is handed over through a lock-free queue by the single owner thread.
+ * The worker owns the journal and the snapshot files.
+ */
+class PersistenceWorker
+{
+public:
+    PersistenceWorker(const QString &journalPath, const QString &snapshotPath);
+
+    /**
+     * Finishes all the submitted tasks and stops the thread
+     */
+    ~PersistenceWorker();
+
+    /**
+     * Read the intact journal records. Must be called before start().
+     */
+    std::vector<StateRecord> replay();
+
+    void start();
+
+    /**
+     * Queue the @p records to be appended to the journal
+     * @returns false if the queue is full. The records are left untouched in this case.
+     */
+    bool submit(std::vector<StateRecord> &records);
+
+    /**
+     * Queue the replacement of the snapshot file with @p snapshot. The journal
+     * is emptied after the new snapshot is in place.
+     * @returns false if the queue is full
+     */
+    bool submitSnapshot(const QByteArray &snapshot);
+
+    /**
+     * Block until all the submitted tasks are done. Meant only for the
+     * shutdown and tests.
+     */
+    void flush();
+
+    /**
+     * Size of the journal in bytes after the last finished task
+     */
+    qint64 journalSize() const;
+
+private:
+    bool enqueue(PersistenceTask &&);
+    void run();
+    void process(PersistenceTask &);
+    void writeSnapshot(const QByteArray &snapshot);
+
+    Journal m_journal;
+    QString m_snapshotPath;
+
+    SpscQueue<PersistenceTask, 64> m_queue;
+    QSemaphore m_wakeUp;
+    std::atomic<bool> m_stopping{false};
+    std::atomic<qint64> m_journalSize{0};
+
+    std::unique_ptr<QThread> m_thread;
+};
+}
@@ -0,0 +1,95 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include "snapshot.hpp"
+
+#include <QtEndian>
+
+#include "logger.hpp"
+#include "state/checksum.hpp"
+
+namespace Bismuth
+{
+namespace
+{
+constexpr quint32 magic = 0x4d534942; // "BISM"
+constexpr qint64 headerSize = 4 * sizeof(quint32);
+}
+
+MappedSnapshot::MappedSnapshot(const QString &path)
+    : m_file(path)
+{
+    if (!m_file.exists()) {
+        return;
+    }
+
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        qWarning(Bi) << "Failed to open the state snapshot" << path << m_file.errorString();
+        return;
+    }
+
+    auto fileSize = m_file.size();
+    auto data = static_cast<const char *>(nullptr);
+
+    m_mappedData = fileSize > 0 ? m_file.map(0, fileSize) : nullptr;
+    if (m_mappedData) {
+        data = reinterpret_cast<const char *>(m_mappedData);
+    } else {
+        m_readData = m_file.readAll();
+        data = m_readData.constData();
+    }
+
+    if (fileSize < headerSize || qFromLittleEndian<quint32>(data) != magic) {
+        qWarning(Bi) << "State snapshot is damaged, ignoring it" << path;
+        return;
+    }
+
+    auto payloadSize = qFromLittleEndian<quint32>(data + 2 * sizeof(quint32));
+    auto payloadChecksum = qFromLittleEndian<quint32>(data + 3 * sizeof(quint32));
+    if (headerSize + payloadSize != fileSize || crc32(data + headerSize, payloadSize) != payloadChecksum) {
+        qWarning(Bi) << "State snapshot is damaged, ignoring it" << path;
+        return;
+    }
+
+    m_payload = QByteArray::fromRawData(data + headerSize, payloadSize);
+    m_fileVersion = qFromLittleEndian<quint32>(data + sizeof(quint32));
+    m_valid = true;
+}
+
+MappedSnapshot::~MappedSnapshot()
+{
+    if (m_mappedData) {
+        m_file.unmap(m_mappedData);
+    }
+}
+
+bool MappedSnapshot::isValid() const
+{
+    return m_valid;
+}
+
+quint32 MappedSnapshot::fileVersion() const
+{
+    return m_fileVersion;
+}
+
+QByteArray MappedSnapshot::payload() const
+{
+    return m_payload;
+}
+
+QByteArray MappedSnapshot::pack(const QByteArray &payload)
+{
+    char header[headerSize];
+    qToLittleEndian<quint32>(magic, header);
+    qToLittleEndian<quint32>(version, header + sizeof(quint32));
+    qToLittleEndian<quint32>(payload.size(), header + 2 * sizeof(quint32));
+    qToLittleEndian<quint32>(crc32(payload), header + 3 * sizeof(quint32));
+
+    auto result = QByteArray();
+    result.reserve(headerSize + payload.size());
+    result.append(header, headerSize);
+    result.append(payload);
+    return result;
+}
+}
@@ -0,0 +1,62 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+
+namespace Bismuth
+{
+/**
+ * Read-only view of the state snapshot file. The file is mapped into memory
+ * and its payload is validated against the checksum in the header, so it
+ * can be scanned right away without copying.
+ *
+ * The file starts with the magic number, the format version, the payload
+ * size and the payload checksum, all little-endian 32-bit integers.
+ */
+class MappedSnapshot
+{
+public:
+    /// Format version of the payload, that is written
+    static constexpr quint32 version = 1;
+
+    explicit MappedSnapshot(const QString &path);
+    ~MappedSnapshot();
+
+    MappedSnapshot(const MappedSnapshot &) = delete;
+    MappedSnapshot &operator=(const MappedSnapshot &) = delete;
+
+    /**
+     * @returns true if the snapshot exists and its checksum matches. The
+     * payload might be of another version, see fileVersion().
+     */
+    bool isValid() const;
+
+    /**
+     * Format version of the payload in the file
+     */
+    quint32 fileVersion() const;
+
+    /**
+     * Payload of the snapshot. Refers to the mapped file, so it must not
+     * outlive the snapshot object.
+     */
+    QByteArray payload() const;
+
+    /**
+     * Frame the @p payload with the header, so that it can be written as the snapshot file
+     */
+    static QByteArray pack(const QByteArray &payload);
+
+private:
+    QFile m_file;
+    uchar *m_mappedData{};
+    QByteArray m_readData{}; ///< Contents of the file, if it could not be mapped
+    QByteArray m_payload{};
+    quint32 m_fileVersion{};
+    bool m_valid{};
+};
+}
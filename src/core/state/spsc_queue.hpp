@@ -0,0 +1,63 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <optional>
+
+namespace Bismuth
+{
+/**
+ * Bounded lock-free queue for exactly one producer thread and exactly one
+ * consumer thread
+ */
+template<typename T, std::size_t Capacity>
+class SpscQueue
+{
+    static_assert(Capacity >= 2, "One slot is always kept free to tell a full queue from an empty one");
+
+public:
+    /**
+     * Called only from the producer thread
+     * @returns false if the queue is full. The @p value is left untouched in this case.
+     */
+    bool push(T &&value)
+    {
+        auto tail = m_tail.load(std::memory_order_relaxed);
+        auto next = (tail + 1) % Capacity;
+        if (next == m_head.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        m_slots[tail] = std::move(value);
+        m_tail.store(next, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Called only from the consumer thread
+     */
+    std::optional<T> pop()
+    {
+        auto head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire)) {
+            return {};
+        }
+
+        auto result = std::optional<T>(std::move(m_slots[head]));
+        m_slots[head] = T();
+        m_head.store((head + 1) % Capacity, std::memory_order_release);
+        return result;
+    }
+
+private:
+    std::array<T, Capacity> m_slots{};
+
+    // Keep the indices on separate cache lines, so the threads do not fight over them
+    alignas(64) std::atomic<std::size_t> m_head{0};
+    alignas(64) std::atomic<std::size_t> m_tail{0};
+};
+}
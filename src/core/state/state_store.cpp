@@ -0,0 +1,734 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include "state_store.hpp"
+
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QVector>
+
+#include <algorithm>
+#include <chrono>
+
+#include "logger.hpp"
+#include "state/snapshot.hpp"
+#include "state/window_fingerprint.hpp"
+
+using namespace std::chrono_literals;
+
+namespace Bismuth
+{
+namespace
+{
+// How long to wait for more changes before writing them to disk
+constexpr auto writeDelay = 500ms;
+
+// How big the journal may grow before it is compacted into the snapshot
+constexpr qint64 compactionThreshold = 256 * 1024;
+
+// How many closed windows keep their state in case they come back
+constexpr std::size_t closedWindowsRetained = 64;
+
+// How many forgotten entries the snapshot may have before it is compacted
+constexpr int deadEntriesThreshold = 128;
+
+// KWin has at most 25 virtual desktops, the rest are surely corrupted keys
+constexpr int maxDesktops = 25;
+constexpr int maxScreens = 32;
+
+/**
+ * Surface groups are kept in a table, which is as big as the highest surface,
+ * so the surfaces from the files are checked before they reach it
+ */
+bool isValidSurface(int desktop, int screen)
+{
+    return desktop >= 1 && desktop <= maxDesktops && screen >= 0 && screen < maxScreens;
+}
+
+QString surfaceKey(int desktop, int screen)
+{
+    return QStringLiteral("%1:%2").arg(desktop).arg(screen);
+}
+
+bool parseSurfaceKey(const QString &key, int &desktop, int &screen)
+{
+    auto surfaceId = key.split(QLatin1Char(':'));
+    if (surfaceId.size() != 2) {
+        return false;
+    }
+
+    desktop = surfaceId.at(0).toInt();
+    screen = surfaceId.at(1).toInt();
+    return isValidSurface(desktop, screen);
+}
+
+QJsonObject readJsonFile(const QString &path)
+{
+    auto file = QFile(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return {};
+    }
+
+    return QJsonDocument::fromJson(file.readAll()).object();
+}
+}
+
+bool WindowState::operator==(const WindowState &rhs) const
+{
+    return group == rhs.group && minimized == rhs.minimized && floatGeometry == rhs.floatGeometry;
+}
+
+bool WindowState::operator!=(const WindowState &rhs) const
+{
+    return !(*this == rhs);
+}
+
+QJsonObject WindowState::toJson() const
+{
+    auto result = QJsonObject();
+    result.insert(QStringLiteral("group"), group);
+    result.insert(QStringLiteral("minimized"), minimized);
+
+    if (!floatGeometry.isNull()) {
+        auto geometry = QJsonObject();
+        geometry.insert(QStringLiteral("x"), floatGeometry.x());
+        geometry.insert(QStringLiteral("y"), floatGeometry.y());
+        geometry.insert(QStringLiteral("width"), floatGeometry.width());
+        geometry.insert(QStringLiteral("height"), floatGeometry.height());
+        result.insert(QStringLiteral("floatGeometry"), geometry);
+    }
+
+    return result;
+}
+
+WindowState WindowState::fromJson(const QJsonObject &json)
+{
+    auto result = WindowState();
+    result.group = json.value(QStringLiteral("group")).toInt();
+    result.minimized = json.value(QStringLiteral("minimized")).toBool();
+
+    if (json.contains(QStringLiteral("floatGeometry"))) {
+        auto geometry = json.value(QStringLiteral("floatGeometry")).toObject();
+        result.floatGeometry = QRect(geometry.value(QStringLiteral("x")).toInt(),
+                                     geometry.value(QStringLiteral("y")).toInt(),
+                                     geometry.value(QStringLiteral("width")).toInt(),
+                                     geometry.value(QStringLiteral("height")).toInt());
+    }
+
+    return result;
+}
+
+QByteArray WindowState::serialize() const
+{
+    return toBytes(*this);
+}
+
+WindowState WindowState::deserialize(const QByteArray &data)
+{
+    return fromBytes<WindowState>(data);
+}
+
+QDataStream &operator<<(QDataStream &stream, const WindowState &state)
+{
+    return stream << static_cast<qint32>(state.group) << state.minimized << state.floatGeometry;
+}
+
+QDataStream &operator>>(QDataStream &stream, WindowState &state)
+{
+    auto group = qint32();
+    stream >> group >> state.minimized >> state.floatGeometry;
+    state.group = group;
+    return stream;
+}
+
+StateStore::StateStore(const QString &directory, QObject *parent)
+    : QObject(parent)
+    , m_snapshotPath(QDir(directory).filePath(QStringLiteral("kwin-bismuth-state.snapshot")))
+    , m_legacyPaths({
+          QDir(directory).filePath(QStringLiteral("kwin-bismuth-windowstates.json")),
+          QDir(directory).filePath(QStringLiteral("kwin-bismuth-surfacegroups.json")),
+          QDir(directory).filePath(QStringLiteral("kwin-bismuth-layoutstates.json")),
+          QDir(directory).filePath(QStringLiteral("kwin-bismuth-windowlist.json")),
+      })
+    , m_worker(QDir(directory).filePath(QStringLiteral("kwin-bismuth-state.journal")), m_snapshotPath)
+    , m_writeTimer()
+    , m_legacyWatcher()
+{
+    m_writeTimer.setSingleShot(true);
+    m_writeTimer.setInterval(writeDelay);
+    connect(&m_writeTimer, &QTimer::timeout, this, &StateStore::onWriteTimeout);
+    connect(&m_legacyWatcher, &QFileSystemWatcher::fileChanged, this, &StateStore::onLegacyFileChanged);
+
+    load();
+}
+
+StateStore::~StateStore()
+{
+    flush();
+
+    // The next start then reads just the snapshot instead of replaying the journal
+    if (!m_hasSnapshot || m_worker.journalSize() > 0) {
+        compact();
+        m_worker.flush();
+    }
+}
+
+WindowState StateStore::windowState(const QString &windowId) const
+{
+    return m_windowStates.value(windowId);
+}
+
+void StateStore::setWindowState(const QString &windowId, const WindowState &state)
+{
+    auto it = m_windowStates.find(windowId);
+    if (it != m_windowStates.end() && *it == state) {
+        return;
+    }
+
+    m_windowStates.insert(windowId, state);
+    record(StateRecord::Kind::WindowState, windowId, state.serialize());
+}
+
+int StateStore::windowGroup(const QString &windowId) const
+{
+    return m_windowStates.value(windowId).group;
+}
+
+void StateStore::setWindowGroup(const QString &windowId, int group)
+{
+    auto state = windowState(windowId);
+    state.group = group;
+    setWindowState(windowId, state);
+}
+
+bool StateStore::windowMinimized(const QString &windowId) const
+{
+    return m_windowStates.value(windowId).minimized;
+}
+
+void StateStore::setWindowMinimized(const QString &windowId, bool minimized)
+{
+    auto state = windowState(windowId);
+    state.minimized = minimized;
+    setWindowState(windowId, state);
+}
+
+QRect StateStore::windowFloatGeometry(const QString &windowId) const
+{
+    return m_windowStates.value(windowId).floatGeometry;
+}
+
+void StateStore::setWindowFloatGeometry(const QString &windowId, const QRect &geometry)
+{
+    auto state = windowState(windowId);
+    state.floatGeometry = geometry;
+    setWindowState(windowId, state);
+}
+
+void StateStore::setLiveWindows(const QStringList &windowIds)
+{
+    m_liveWindows = QSet<QString>(windowIds.cbegin(), windowIds.cend());
+    m_liveWindowsOnLastWrite = m_liveWindows.size();
+
+    m_closedWindows.clear();
+    for (auto it = m_windowStates.cbegin(); it != m_windowStates.cend(); it++) {
+        if (!m_liveWindows.contains(it.key())) {
+            m_closedWindows.push_back(it.key());
+        }
+    }
+
+    // The windows, that were never seen closing, e.g. the imported ones, go first
+    std::sort(m_closedWindows.begin(), m_closedWindows.end(), [this](const QString &lhs, const QString &rhs) {
+        return qMakePair(m_lastSeen.value(lhs), lhs) < qMakePair(m_lastSeen.value(rhs), rhs);
+    });
+
+    scheduleWrite();
+}
+
+void StateStore::windowAdded(const QString &windowId)
+{
+    m_liveWindows.insert(windowId);
+
+    auto it = std::find(m_closedWindows.begin(), m_closedWindows.end(), windowId);
+    if (it != m_closedWindows.end()) {
+        m_closedWindows.erase(it);
+    }
+}
+
+void StateStore::windowRemoved(const QString &windowId)
+{
+    m_liveWindows.remove(windowId);
+
+    if (m_windowStates.contains(windowId)) {
+        m_closedWindows.push_back(windowId);
+
+        m_lastSeen.insert(windowId, ++m_lastSeenClock);
+        record(StateRecord::Kind::WindowSeen, windowId, toBytes(m_lastSeenClock));
+
+        // Not collected right away: KWin removes all the windows, when it
+        // quits, and they must be restored after it starts again.
+        scheduleWrite();
+    }
+}
+
+void StateStore::collectGarbage()
+{
+    auto evictedCount = 0;
+    while (m_closedWindows.size() > closedWindowsRetained) {
+        auto windowId = m_closedWindows.front();
+        m_closedWindows.pop_front();
+
+        m_lastSeen.remove(windowId);
+        m_pendingRecords.remove({StateRecord::Kind::WindowSeen, windowId});
+
+        if (m_windowStates.remove(windowId) > 0) {
+            record(StateRecord::Kind::WindowStateRemoved, windowId, {});
+            evictedCount++;
+        }
+    }
+
+    if (evictedCount == 0) {
+        return;
+    }
+
+    m_deadEntries += evictedCount;
+    qDebug(Bi) << "Forgot the states of" << evictedCount << "closed windows," << m_windowStates.size() << "window states left";
+}
+
+int StateStore::surfaceGroup(int desktop, int screen) const
+{
+    auto index = surfaceIndex(desktop, screen);
+    return index >= 0 ? m_surfaceGroups[index] : 0;
+}
+
+void StateStore::setSurfaceGroup(int desktop, int screen, int group)
+{
+    if (!isValidSurface(desktop, screen)) {
+        qWarning(Bi) << "Ignoring the group of the invalid surface" << desktop << screen;
+        return;
+    }
+
+    if (surfaceGroup(desktop, screen) == group) {
+        return;
+    }
+
+    record(StateRecord::Kind::SurfaceGroup, surfaceKey(desktop, screen), toBytes(static_cast<qint32>(group)));
+    assignSurfaceGroup(desktop, screen, group);
+}
+
+LayoutState StateStore::layoutState(const QString &layoutId) const
+{
+    return m_layoutStates.value(layoutId);
+}
+
+void StateStore::setLayoutState(const QString &layoutId, const LayoutState &state)
+{
+    auto it = m_layoutStates.find(layoutId);
+    if (it != m_layoutStates.end() && *it == state) {
+        return;
+    }
+
+    m_layoutStates.insert(layoutId, state);
+    record(StateRecord::Kind::LayoutState, layoutId, state.serialize());
+}
+
+QStringList StateStore::windowList() const
+{
+    return m_windowList;
+}
+
+void StateStore::setWindowList(const QStringList &windowIds)
+{
+    if (m_windowList == windowIds) {
+        return;
+    }
+
+    m_windowList = windowIds;
+    record(StateRecord::Kind::WindowList, {}, toBytes(windowIds));
+}
+
+QStringList StateStore::windowOrder() const
+{
+    return m_windowOrder;
+}
+
+void StateStore::setWindowOrder(const QStringList &fingerprints)
+{
+    if (m_windowOrder == fingerprints) {
+        return;
+    }
+
+    m_windowOrder = fingerprints;
+    record(StateRecord::Kind::WindowOrder, {}, toBytes(fingerprints));
+}
+
+void StateStore::flush()
+{
+    submitPendingRecords();
+    m_worker.flush();
+}
+
+void StateStore::compact()
+{
+    // The journal must end with the values, that go into the snapshot.
+    // Otherwise, a crash right after the snapshot is replaced would replay the
+    // older values on top of it.
+    submitPendingRecords();
+
+    if (!m_pendingRecords.isEmpty() || !m_worker.submitSnapshot(MappedSnapshot::pack(snapshotPayload()))) {
+        qDebug(Bi) << "State writer is busy, postponing the compaction";
+        return;
+    }
+
+    m_deadEntries = 0;
+    m_hasSnapshot = true;
+}
+
+void StateStore::beginTransaction()
+{
+    m_transactionDepth++;
+}
+
+void StateStore::commitTransaction()
+{
+    if (m_transactionDepth == 0) {
+        qWarning(Bi) << "Committing the state transaction, that was not started";
+        return;
+    }
+
+    if (--m_transactionDepth > 0) {
+        return;
+    }
+
+    // The whole burst goes to the journal with a single write
+    submitPendingRecords();
+}
+
+void StateStore::onWriteTimeout()
+{
+    // The timer might be started before the transaction. The changes are written on commit then.
+    if (m_transactionDepth > 0) {
+        return;
+    }
+
+    // KWin removes the windows one by one, when it quits. Their states
+    // must be there, when it starts again.
+    auto windowsGoingAway = m_liveWindows.size() < m_liveWindowsOnLastWrite;
+    m_liveWindowsOnLastWrite = m_liveWindows.size();
+    if (!windowsGoingAway) {
+        collectGarbage();
+    }
+
+    submitPendingRecords();
+
+    if (m_worker.journalSize() > compactionThreshold || m_deadEntries > deadEntriesThreshold) {
+        compact();
+    }
+}
+
+void StateStore::onLegacyFileChanged(const QString &path)
+{
+    // Editors and other tools tend to replace the file, which removes it from the watch list
+    if (QFile::exists(path) && !m_legacyWatcher.files().contains(path)) {
+        m_legacyWatcher.addPath(path);
+    }
+
+    qDebug(Bi) << "Legacy state file was changed externally, importing" << path;
+
+    // Changes, that are not yet on disk, are newer than anything in the file
+    auto newerRecords = m_pendingRecords;
+
+    // The legacy files are not read on startup, once the snapshot exists, so
+    // the imported state is journaled like any other change
+    auto transaction = StateTransaction(*this);
+    for (auto &importedRecord : legacyFileRecords(path)) {
+        apply(importedRecord);
+        record(importedRecord.kind, importedRecord.key, importedRecord.value);
+    }
+
+    for (auto &newerRecord : qAsConst(newerRecords)) {
+        apply(newerRecord);
+        record(newerRecord.kind, newerRecord.key, newerRecord.value);
+    }
+}
+
+void StateStore::load()
+{
+    m_hasSnapshot = loadSnapshot();
+
+    auto importedLegacyState = false;
+    if (!m_hasSnapshot) {
+        for (auto &path : qAsConst(m_legacyPaths)) {
+            for (auto &importedRecord : legacyFileRecords(path)) {
+                apply(importedRecord);
+                importedLegacyState = true;
+            }
+        }
+    }
+
+    for (auto &journalRecord : m_worker.replay()) {
+        apply(journalRecord);
+    }
+
+    for (auto lastSeen : qAsConst(m_lastSeen)) {
+        m_lastSeenClock = std::max(m_lastSeenClock, lastSeen);
+    }
+
+    m_worker.start();
+
+    // Otherwise, the stale legacy files would be imported on every start, until the journal is big enough
+    if (importedLegacyState) {
+        compact();
+    }
+
+    qDebug(Bi) << "Loaded" << m_windowStates.size() << "window states, snapshot size:" << QFileInfo(m_snapshotPath).size()
+               << "bytes, journal size:" << m_worker.journalSize() << "bytes";
+
+    for (auto &path : qAsConst(m_legacyPaths)) {
+        if (QFile::exists(path)) {
+            m_legacyWatcher.addPath(path);
+        }
+    }
+}
+
+std::vector<StateRecord> StateStore::jsonRecords(const QJsonObject &root) const
+{
+    auto result = std::vector<StateRecord>();
+
+    auto statesJson = root.value(QStringLiteral("WindowStates")).toObject();
+    for (auto it = statesJson.constBegin(); it != statesJson.constEnd(); it++) {
+        auto state = WindowState::fromJson(it.value().toObject());
+        result.push_back({StateRecord::Kind::WindowState, it.key(), state.serialize()});
+    }
+
+    auto surfacesJson = root.value(QStringLiteral("Surfaces")).toObject();
+    for (auto it = surfacesJson.constBegin(); it != surfacesJson.constEnd(); it++) {
+        auto desktop = 0;
+        auto screen = 0;
+        if (parseSurfaceKey(it.key(), desktop, screen)) {
+            auto group = static_cast<qint32>(it.value().toObject().value(QStringLiteral("group")).toInt());
+            result.push_back({StateRecord::Kind::SurfaceGroup, surfaceKey(desktop, screen), toBytes(group)});
+        }
+    }
+
+    auto layoutStatesJson = root.value(QStringLiteral("LayoutStates")).toObject();
+    for (auto it = layoutStatesJson.constBegin(); it != layoutStatesJson.constEnd(); it++) {
+        auto state = LayoutState::fromJson(it.value().toObject());
+        result.push_back({StateRecord::Kind::LayoutState, it.key(), state.serialize()});
+    }
+
+    if (root.contains(QStringLiteral("WindowList"))) {
+        auto windowList = QStringList();
+        for (auto windowId : root.value(QStringLiteral("WindowList")).toArray()) {
+            windowList.append(windowId.toVariant().toString());
+        }
+        result.push_back({StateRecord::Kind::WindowList, {}, toBytes(windowList)});
+    }
+
+    return result;
+}
+
+bool StateStore::loadSnapshot()
+{
+    auto snapshot = MappedSnapshot(m_snapshotPath);
+    if (!snapshot.isValid()) {
+        return false;
+    }
+
+    // The journal was emptied, when the snapshot was written, so the snapshot
+    // is the only copy of the state. There are no older formats to convert
+    // yet, so the snapshot of another version is kept for the version, that
+    // can read it, e.g. after a downgrade.
+    if (snapshot.fileVersion() != MappedSnapshot::version) {
+        keepSnapshot(snapshot.fileVersion());
+        return false;
+    }
+
+    auto stream = QDataStream(snapshot.payload());
+    stream.setVersion(stateStreamVersion);
+
+    auto windowList = QStringList();
+    auto windowOrder = QStringList();
+    auto windowStates = QHash<QString, WindowState>();
+    auto layoutStates = QHash<QString, LayoutState>();
+    auto screensPerDesktop = qint32();
+    auto surfaceGroups = QVector<qint32>();
+    auto lastSeen = QHash<QString, qint64>();
+
+    stream >> windowList >> windowOrder >> windowStates >> layoutStates >> screensPerDesktop >> surfaceGroups >> lastSeen;
+    if (stream.status() != QDataStream::Ok || screensPerDesktop < 0 || screensPerDesktop > maxScreens
+        || (screensPerDesktop == 0 && !surfaceGroups.empty()) || (screensPerDesktop > 0 && surfaceGroups.size() % screensPerDesktop != 0)
+        || surfaceGroups.size() > maxDesktops * screensPerDesktop) {
+        qWarning(Bi) << "State snapshot has invalid contents, ignoring it";
+        return false;
+    }
+
+    m_windowList = std::move(windowList);
+    m_windowOrder = std::move(windowOrder);
+    m_windowStates = std::move(windowStates);
+    m_layoutStates = std::move(layoutStates);
+    m_screensPerDesktop = screensPerDesktop;
+    m_surfaceGroups.assign(surfaceGroups.cbegin(), surfaceGroups.cend());
+    m_lastSeen = std::move(lastSeen);
+    return true;
+}
+
+void StateStore::keepSnapshot(quint32 fileVersion) const
+{
+    auto keptPath = QStringLiteral("%1.v%2").arg(m_snapshotPath).arg(fileVersion);
+    qWarning(Bi) << "State snapshot has unsupported version" << fileVersion << "keeping it as" << keptPath;
+
+    // The newer snapshot of the same version replaces the older one
+    QFile::remove(keptPath);
+    if (!QFile::copy(m_snapshotPath, keptPath)) {
+        qWarning(Bi) << "Failed to keep the state snapshot of version" << fileVersion;
+    }
+}
+
+QByteArray StateStore::snapshotPayload() const
+{
+    auto result = QByteArray();
+    auto stream = QDataStream(&result, QIODevice::WriteOnly);
+    stream.setVersion(stateStreamVersion);
+
+    stream << m_windowList << m_windowOrder << m_windowStates << m_layoutStates << static_cast<qint32>(m_screensPerDesktop)
+           << QVector<qint32>(m_surfaceGroups.cbegin(), m_surfaceGroups.cend()) << m_lastSeen;
+    return result;
+}
+
+std::vector<StateRecord> StateStore::legacyFileRecords(const QString &path) const
+{
+    if (!QFile::exists(path)) {
+        return {};
+    }
+
+    return jsonRecords(readJsonFile(path));
+}
+
+void StateStore::apply(const StateRecord &stateRecord)
+{
+    switch (stateRecord.kind) {
+    case StateRecord::Kind::WindowState:
+        m_windowStates.insert(stateRecord.key, WindowState::deserialize(stateRecord.value));
+        break;
+    case StateRecord::Kind::SurfaceGroup: {
+        auto desktop = 0;
+        auto screen = 0;
+        if (parseSurfaceKey(stateRecord.key, desktop, screen)) {
+            assignSurfaceGroup(desktop, screen, fromBytes<qint32>(stateRecord.value));
+        }
+        break;
+    }
+    case StateRecord::Kind::LayoutState:
+        m_layoutStates.insert(stateRecord.key, LayoutState::deserialize(stateRecord.value));
+        break;
+    case StateRecord::Kind::WindowList: {
+        auto windowList = fromBytes<QStringList>(stateRecord.value);
+
+        // The fingerprints were saved as the window list before they got their own record
+        if (!windowList.isEmpty() && isWindowFingerprint(windowList.first())) {
+            m_windowOrder = std::move(windowList);
+        } else {
+            m_windowList = std::move(windowList);
+        }
+        break;
+    }
+    case StateRecord::Kind::WindowOrder:
+        m_windowOrder = fromBytes<QStringList>(stateRecord.value);
+        break;
+    case StateRecord::Kind::WindowStateRemoved:
+        m_windowStates.remove(stateRecord.key);
+        m_lastSeen.remove(stateRecord.key);
+        break;
+    case StateRecord::Kind::WindowSeen:
+        m_lastSeen.insert(stateRecord.key, fromBytes<qint64>(stateRecord.value));
+        break;
+    default:
+        qWarning(Bi) << "Skipping the state record of unknown kind" << static_cast<int>(stateRecord.kind);
+        break;
+    }
+}
+
+void StateStore::record(StateRecord::Kind kind, const QString &key, const QByteArray &value)
+{
+    // Removal shares the slot with the state, so that only the latest of them is written
+    auto slotKind = kind == StateRecord::Kind::WindowStateRemoved ? StateRecord::Kind::WindowState : kind;
+    m_pendingRecords.insert({slotKind, key}, {kind, key, value});
+
+    scheduleWrite();
+}
+
+void StateStore::scheduleWrite()
+{
+    if (m_transactionDepth == 0 && !m_writeTimer.isActive()) {
+        m_writeTimer.start();
+    }
+}
+
+void StateStore::submitPendingRecords()
+{
+    m_writeTimer.stop();
+
+    if (m_pendingRecords.isEmpty()) {
+        return;
+    }
+
+    auto records = std::vector<StateRecord>(m_pendingRecords.cbegin(), m_pendingRecords.cend());
+    if (m_worker.submit(records)) {
+        m_pendingRecords.clear();
+    } else {
+        // Try again later, the newer changes will be coalesced with these ones meanwhile
+        m_writeTimer.start();
+    }
+}
+
+void StateStore::assignSurfaceGroup(int desktop, int screen, int group)
+{
+    if (surfaceGroup(desktop, screen) == group) {
+        return;
+    }
+
+    growSurfaceGroups(desktop, screen);
+    m_surfaceGroups[surfaceIndex(desktop, screen)] = group;
+
+    Q_EMIT surfaceGroupChanged(desktop, screen, group);
+}
+
+int StateStore::surfaceIndex(int desktop, int screen) const
+{
+    if (desktop < 1 || screen < 0 || screen >= m_screensPerDesktop) {
+        return -1;
+    }
+
+    auto index = (desktop - 1) * m_screensPerDesktop + screen;
+    return index < static_cast<int>(m_surfaceGroups.size()) ? index : -1;
+}
+
+void StateStore::growSurfaceGroups(int desktop, int screen)
+{
+    // More screens, than the table fits: change the row width
+    if (screen >= m_screensPerDesktop) {
+        auto newScreensPerDesktop = screen + 1;
+        auto numDesktops = m_screensPerDesktop > 0 ? static_cast<int>(m_surfaceGroups.size()) / m_screensPerDesktop : 0;
+
+        auto newSurfaceGroups = std::vector<int>(numDesktops * newScreensPerDesktop, 0);
+        for (auto row = 0; row < numDesktops; row++) {
+            for (auto column = 0; column < m_screensPerDesktop; column++) {
+                newSurfaceGroups[row * newScreensPerDesktop + column] = m_surfaceGroups[row * m_screensPerDesktop + column];
+            }
+        }
+
+        m_surfaceGroups = std::move(newSurfaceGroups);
+        m_screensPerDesktop = newScreensPerDesktop;
+    }
+
+    auto requiredSize = static_cast<size_t>(desktop * m_screensPerDesktop);
+    if (m_surfaceGroups.size() < requiredSize) {
+        m_surfaceGroups.resize(requiredSize, 0);
+    }
+}
+}
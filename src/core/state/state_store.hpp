@@ -0,0 +1,254 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <QDataStream>
+#include <QFileSystemWatcher>
+#include <QHash>
+#include <QJsonObject>
+#include <QObject>
+#include <QPair>
+#include <QRect>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+#include <QVector>
+
+#include <deque>
+#include <vector>
+
+#include "state/journal.hpp"
+#include "state/layout_state.hpp"
+#include "state/persistence_worker.hpp"
+
+namespace Bismuth
+{
+/**
+ * Persisted state of a single window
+ */
+struct WindowState {
+    int group{}; ///< Group of the window. Zero means, that the group is not assigned yet.
+    bool minimized{};
+    QRect floatGeometry{}; ///< Geometry of the window, when it floats. Null means, that it is not known yet.
+
+    bool operator==(const WindowState &) const;
+    bool operator!=(const WindowState &) const;
+
+    QJsonObject toJson() const;
+    static WindowState fromJson(const QJsonObject &);
+
+    QByteArray serialize() const;
+    static WindowState deserialize(const QByteArray &);
+};
+
+QDataStream &operator<<(QDataStream &, const WindowState &);
+QDataStream &operator>>(QDataStream &, WindowState &);
+
+/**
+ * Resident copy of the tiling state, that the legacy TS backend keeps between
+ * KWin restarts. All reads are answered from memory.
+ *
+ * The whole state is kept in a versioned binary snapshot, that is loaded with a
+ * single scan of the mapped file.
+ *
+ * Changes are appended to a journal as small records shortly after they are
+ * made, so the cost of a change does not depend on the size of the state.
+ * Repeated changes of the same entry are coalesced, until they are handed over
+ * to the persistence thread. Once the journal grows big enough, it is
+ * compacted into a snapshot, which is replaced atomically. On startup the
+ * snapshot is loaded and the journal is replayed on top of it.
+ */
+class StateStore : public QObject
+{
+    Q_OBJECT
+public:
+    /**
+     * @param directory the directory where the state files are located
+     */
+    explicit StateStore(const QString &directory, QObject *parent = nullptr);
+    ~StateStore() override;
+
+    /**
+     * @returns the state of the window or the default state, if the window is unknown
+     */
+    WindowState windowState(const QString &windowId) const;
+    void setWindowState(const QString &windowId, const WindowState &state);
+
+    int windowGroup(const QString &windowId) const;
+    void setWindowGroup(const QString &windowId, int group);
+
+    bool windowMinimized(const QString &windowId) const;
+    void setWindowMinimized(const QString &windowId, bool minimized);
+
+    QRect windowFloatGeometry(const QString &windowId) const;
+    void setWindowFloatGeometry(const QString &windowId, const QRect &geometry);
+
+    /**
+     * Start tracking the windows, that are open right now. The states of all
+     * the other windows are treated as the ones of the closed windows, in
+     * the order, they were closed in.
+     */
+    void setLiveWindows(const QStringList &windowIds);
+    void windowAdded(const QString &windowId);
+    void windowRemoved(const QString &windowId);
+
+    /**
+     * Forget the states of the closed windows, except for the most recently
+     * closed ones, that are kept in case the window comes back. Done on
+     * write, unless the windows are going away, e.g. KWin is quitting.
+     */
+    void collectGarbage();
+
+    /**
+     * @returns the group shown on the @p screen of the @p desktop or zero, if
+     * none was assigned yet
+     */
+    int surfaceGroup(int desktop, int screen) const;
+    void setSurfaceGroup(int desktop, int screen, int group);
+
+    LayoutState layoutState(const QString &layoutId) const;
+    void setLayoutState(const QString &layoutId, const LayoutState &state);
+
+    /**
+     * Ids of the managed windows in the tiling order
+     */
+    QStringList windowList() const;
+    void setWindowList(const QStringList &windowIds);
+
+    /**
+     * Fingerprints of the managed windows in the tiling order. Unlike the
+     * window ids, they survive KWin restarts.
+     */
+    QStringList windowOrder() const;
+    void setWindowOrder(const QStringList &fingerprints);
+
+    /**
+     * Write all the changes to disk and wait until they are there. Blocks the
+     * calling thread, so it is meant only for the shutdown and tests.
+     */
+    void flush();
+
+    /**
+     * Schedule writing the whole state into a new snapshot and emptying the journal
+     */
+    void compact();
+
+    /**
+     * Hold the changes back until the matching commitTransaction(), so that a
+     * burst of changes made by a single action is persisted at once.
+     * Transactions may be nested, only the outermost one is committed.
+     */
+    void beginTransaction();
+    void commitTransaction();
+
+Q_SIGNALS:
+    /**
+     * Emitted, when the group shown on the surface changes
+     */
+    void surfaceGroupChanged(int desktop, int screen, int group);
+
+private Q_SLOTS:
+    void onWriteTimeout();
+    void onLegacyFileChanged(const QString &path);
+
+private:
+    void load();
+
+    /**
+     * Records, that bring the state to the one in the JSON of the previous versions
+     */
+    std::vector<StateRecord> jsonRecords(const QJsonObject &root) const;
+
+    /**
+     * Load the state from the binary snapshot
+     * @returns false if there is no snapshot, it is damaged or of another version
+     */
+    bool loadSnapshot();
+
+    /**
+     * Copy the snapshot of another format @p fileVersion aside, before it is
+     * replaced by the next compaction
+     */
+    void keepSnapshot(quint32 fileVersion) const;
+
+    QByteArray snapshotPayload() const;
+
+    /**
+     * Read the state from the JSON file used by the previous versions
+     */
+    std::vector<StateRecord> legacyFileRecords(const QString &path) const;
+
+    void apply(const StateRecord &);
+    void record(StateRecord::Kind, const QString &key, const QByteArray &value);
+    void scheduleWrite();
+
+    /**
+     * Hand the pending records over to the persistence thread without waiting for them
+     */
+    void submitPendingRecords();
+
+    void assignSurfaceGroup(int desktop, int screen, int group);
+
+    /**
+     * Index of the surface in the surface groups table or -1 if the surface is
+     * not in the table
+     */
+    int surfaceIndex(int desktop, int screen) const;
+    void growSurfaceGroups(int desktop, int screen);
+
+    QHash<QString, WindowState> m_windowStates{};
+    std::vector<int> m_surfaceGroups{}; ///< Groups of the surfaces as a desktops × screens table
+    int m_screensPerDesktop{};
+    QHash<QString, LayoutState> m_layoutStates{};
+    QStringList m_windowList{};
+    QStringList m_windowOrder{};
+
+    QSet<QString> m_liveWindows{};
+    int m_liveWindowsOnLastWrite{}; ///< Fewer live windows now mean, that the windows are going away
+    std::deque<QString> m_closedWindows{}; ///< Closed windows with the known state, the most recently closed last
+
+    /// When the windows were closed for the last time. A sequence number, that survives restarts.
+    QHash<QString, qint64> m_lastSeen{};
+    qint64 m_lastSeenClock{};
+    int m_deadEntries{}; ///< Forgotten entries, that are still in the snapshot
+
+    QString m_snapshotPath;
+    bool m_hasSnapshot{}; ///< Whether the state on disk starts with the snapshot, that was loaded or written
+    QStringList m_legacyPaths;
+    PersistenceWorker m_worker;
+
+    /// Latest changes of the entries, that are not yet handed over to the worker
+    QHash<QPair<StateRecord::Kind, QString>, StateRecord> m_pendingRecords{};
+
+    int m_transactionDepth{};
+
+    QTimer m_writeTimer;
+    QFileSystemWatcher m_legacyWatcher;
+};
+
+/**
+ * Keeps the transaction of the store open for the lifetime of the object
+ */
+class StateTransaction
+{
+public:
+    explicit StateTransaction(StateStore &store)
+        : m_store(store)
+    {
+        m_store.beginTransaction();
+    }
+
+    ~StateTransaction()
+    {
+        m_store.commitTransaction();
+    }
+
+    StateTransaction(const StateTransaction &) = delete;
+    StateTransaction &operator=(const StateTransaction &) = delete;
+
+private:
+    StateStore &m_store;
+};
+}
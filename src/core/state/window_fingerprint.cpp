@@ -0,0 +1,160 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include "window_fingerprint.hpp"
+
+#include <QHash>
+#include <QRegularExpression>
+
+#include <algorithm>
+#include <utility>
+
+namespace Bismuth
+{
+namespace
+{
+// Separates the fields of the fingerprint. Never appears in window properties.
+constexpr auto fieldSeparator = QChar(0x1f);
+}
+
+QString normalizedCaption(const QString &caption)
+{
+    // KWin appends " <2>" and so on to the captions of the same windows
+    static const auto duplicateSuffix = QRegularExpression(QStringLiteral("\\s*<\\d+>$"));
+    // Applications separate the document name from their own name
+    static const auto documentSeparator = QRegularExpression(QStringLiteral("\\s+[-\u2013\u2014|]\\s+"));
+    static const auto digits = QRegularExpression(QStringLiteral("\\d+"));
+
+    auto result = caption;
+    result.remove(duplicateSuffix);
+
+    auto lastSeparator = result.lastIndexOf(documentSeparator);
+    if (lastSeparator >= 0) {
+        result = result.mid(lastSeparator).remove(documentSeparator);
+    }
+
+    result.remove(digits);
+    result.remove(QLatin1Char('*'));
+    return result.simplified().toLower();
+}
+
+bool isWindowFingerprint(const QString &value)
+{
+    return value.contains(fieldSeparator);
+}
+
+namespace
+{
+/**
+ * Part of the fingerprint, that depends only on the window itself
+ */
+QString fingerprintBase(const WindowIdentity &window)
+{
+    return window.resourceClass + fieldSeparator + window.resourceName + fieldSeparator + window.windowRole + fieldSeparator
+        + normalizedCaption(window.caption);
+}
+
+/**
+ * Append the ordinals to the @p bases of the windows, that look the same. The
+ * ordinals follow the @p startOrder of the windows: their pids and window ids.
+ */
+QStringList withOrdinals(QStringList bases, const std::vector<std::pair<int, quint32>> &startOrder)
+{
+    // Windows, that look the same, are grouped to get their ordinals
+    auto similarWindows = QHash<QString, std::vector<int>>();
+    similarWindows.reserve(bases.size());
+
+    for (auto index = 0; index < bases.size(); index++) {
+        similarWindows[bases[index]].push_back(index);
+    }
+
+    for (auto &indices : similarWindows) {
+        std::sort(indices.begin(), indices.end(), [&startOrder](int lhs, int rhs) {
+            return startOrder[lhs] < startOrder[rhs];
+        });
+
+        for (auto ordinal = 0; ordinal < static_cast<int>(indices.size()); ordinal++) {
+            auto &fingerprint = bases[indices[ordinal]];
+            fingerprint += fieldSeparator + QString::number(ordinal);
+        }
+    }
+
+    return bases;
+}
+}
+
+QStringList windowFingerprints(const std::vector<WindowIdentity> &windows)
+{
+    auto bases = QStringList();
+    bases.reserve(windows.size());
+
+    auto startOrder = std::vector<std::pair<int, quint32>>();
+    startOrder.reserve(windows.size());
+
+    for (auto &window : windows) {
+        bases.append(fingerprintBase(window));
+        startOrder.emplace_back(window.pid, window.windowId);
+    }
+
+    return withOrdinals(std::move(bases), startOrder);
+}
+
+QStringList WindowFingerprintCache::fingerprints(const std::vector<quint32> &windowIds, const std::function<WindowIdentity(int index)> &identity)
+{
+    auto bases = QStringList();
+    bases.reserve(windowIds.size());
+
+    auto startOrder = std::vector<std::pair<int, quint32>>();
+    startOrder.reserve(windowIds.size());
+
+    for (auto index = 0; index < static_cast<int>(windowIds.size()); index++) {
+        auto it = m_entries.find(windowIds[index]);
+        if (it == m_entries.end()) {
+            auto window = identity(index);
+
+            auto entry = Entry();
+            entry.base = fingerprintBase(window);
+            entry.pid = window.pid;
+            it = m_entries.insert(windowIds[index], entry);
+        }
+
+        bases.append(it->base);
+        startOrder.emplace_back(it->pid, windowIds[index]);
+    }
+
+    return withOrdinals(std::move(bases), startOrder);
+}
+
+void WindowFingerprintCache::invalidate(quint32 windowId)
+{
+    m_entries.remove(windowId);
+}
+
+WindowRestoreResult restoreWindowOrder(const QStringList &savedOrder, const QStringList &fingerprints)
+{
+    auto index = QHash<QString, int>();
+    index.reserve(fingerprints.size());
+    for (auto i = 0; i < fingerprints.size(); i++) {
+        index.insert(fingerprints[i], i);
+    }
+
+    auto result = WindowRestoreResult();
+    result.order.reserve(std::min(savedOrder.size(), fingerprints.size()));
+
+    for (auto &fingerprint : savedOrder) {
+        auto it = index.find(fingerprint);
+        if (it == index.end()) {
+            result.misses++;
+            continue;
+        }
+
+        result.order.push_back(it.value());
+        result.hits++;
+
+        // The same window must not be restored twice
+        index.erase(it);
+    }
+
+    return result;
+}
+}
@@ -0,0 +1,83 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+
+#include <functional>
+#include <vector>
+
+namespace Bismuth
+{
+/**
+ * Properties of a window, that survive the restart of KWin
+ */
+struct WindowIdentity {
+    QString resourceClass{};
+    QString resourceName{};
+    QString windowRole{};
+    QString caption{};
+    int pid{};
+    quint32 windowId{}; ///< Only breaks the ties between the windows of the same process
+};
+
+/**
+ * Strip the parts of the caption, that change while the window lives: the
+ * document name, counters and modification markers. Usually the application
+ * name is left.
+ */
+QString normalizedCaption(const QString &caption);
+
+/**
+ * @returns true if the @p value is a window fingerprint and not, e.g., a window id
+ */
+bool isWindowFingerprint(const QString &value);
+
+/**
+ * Compute the stable fingerprints of the @p windows. Windows, that look the
+ * same, are told apart by the order, in which their processes were started.
+ * @returns fingerprints in the same order as the windows
+ */
+QStringList windowFingerprints(const std::vector<WindowIdentity> &windows);
+
+/**
+ * Keeps the part of the fingerprints, that depends only on the window itself.
+ * The properties of a window are read and its caption is normalized again
+ * only after the window was invalidated, e.g. when its caption changed.
+ */
+class WindowFingerprintCache
+{
+public:
+    /**
+     * Compute the fingerprints of the windows with the @p windowIds, like
+     * windowFingerprints() does. The @p identity of the window at the given
+     * index is only asked for, when the window is not in the cache.
+     */
+    QStringList fingerprints(const std::vector<quint32> &windowIds, const std::function<WindowIdentity(int index)> &identity);
+
+    void invalidate(quint32 windowId);
+
+private:
+    struct Entry {
+        QString base{};
+        int pid{};
+    };
+
+    QHash<quint32, Entry> m_entries{};
+};
+
+struct WindowRestoreResult {
+    std::vector<int> order{}; ///< Indices of the matched windows in the saved order
+    int hits{};
+    int misses{};
+};
+
+/**
+ * Match the @p savedOrder of fingerprints against the @p fingerprints of the
+ * present windows in a single pass
+ */
+WindowRestoreResult restoreWindowOrder(const QStringList &savedOrder, const QStringList &fingerprints);
+}
@@ -7,15 +7,51 @@
 #include <KLocalizedString>
 #include <QAction>
 #include <QKeySequence>
-#include <QFile>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonValue>
 #include <QJsonArray>
+#include <QElapsedTimer>
+
+#include <algorithm>
 
 #include "controller.hpp"
 #include "logger.hpp"
 #include "plasma-api/api.hpp"
+#include "plasma-api/client_handle.hpp"
+#include "state/window_fingerprint.hpp"
+
+namespace
+{
+PlasmaApi::ClientHandle clientHandle(const QVariant &kwinClient)
+{
+    return PlasmaApi::ClientHandle(kwinClient.value<QObject *>());
+}
+
+Bismuth::WindowIdentity windowIdentity(PlasmaApi::ClientHandle client)
+{
+    auto identity = Bismuth::WindowIdentity();
+    identity.resourceClass = QString::fromUtf8(client.resourceClass());
+    identity.resourceName = QString::fromUtf8(client.resourceName());
+    identity.windowRole = QString::fromUtf8(client.windowRole());
+    identity.caption = client.caption();
+    identity.pid = client.pid();
+    identity.windowId = client.windowId();
+    return identity;
+}
+
+std::vector<quint32> windowIds(const QVariantList &kwinClients)
+{
+    auto result = std::vector<quint32>();
+    result.reserve(kwinClients.size());
+
+    for (auto &kwinClient : kwinClients) {
+        result.push_back(clientHandle(kwinClient).windowId());
+    }
+
+    return result;
+}
+}
 
 TSProxy::TSProxy(QQmlEngine *engine, Bismuth::Controller &controller, PlasmaApi::Api &plasmaApi, Bismuth::Config &config)
     : QObject()
@@ -23,7 +59,33 @@ TSProxy::TSProxy(QQmlEngine *engine, Bismuth::Controller &controller, PlasmaApi:
     , m_config(config)
     , m_controller(controller)
     , m_plasmaApi(plasmaApi)
+    , m_stateStore(QStringLiteral("/tmp"))
+    , m_layoutStates()
+    , m_fingerprints()
+    , m_savedWindowOrder()
+    , m_windowOrderOutdated(false)
+    , m_pendingWindowOrder()
+    , m_transactionDepth(0)
 {
+    connect(&m_stateStore, &Bismuth::StateStore::surfaceGroupChanged, this, &TSProxy::surfaceGroupChanged);
+
+    // Let the store know, which window states are still needed
+    auto &workspace = m_plasmaApi.workspace();
+    connect(&workspace, &PlasmaApi::Workspace::clientAdded, this, [this](PlasmaApi::ClientHandle client) {
+        m_stateStore.windowAdded(QString::number(client.windowId()));
+        client.connectPropertyChanges({"caption"}, this, "onClientCaptionChanged()");
+    });
+    connect(&workspace, &PlasmaApi::Workspace::clientRemoved, this, [this](PlasmaApi::ClientHandle client) {
+        m_stateStore.windowRemoved(QString::number(client.windowId()));
+        m_fingerprints.invalidate(client.windowId());
+    });
+
+    auto liveWindowIds = QStringList();
+    for (auto &client : workspace.clientList()) {
+        liveWindowIds.append(QString::number(client.windowId()));
+        client.connectPropertyChanges({"caption"}, this, "onClientCaptionChanged()");
+    }
+    m_stateStore.setLiveWindows(liveWindowIds);
 }
 
 QJSValue TSProxy::jsConfig()
@@ -127,233 +189,166 @@ QJSValue TSProxy::workspace()
 
 QString TSProxy::getLayoutState(QString stateId)
 {
-    QString fileText;
-    QFile file;
-    file.setFileName("/tmp/kwin-bismuth-layoutstates.json");
-    file.open(QIODevice::ReadOnly | QIODevice::Text);
-    fileText = file.readAll();
-    file.close();
-
-    QJsonDocument doc = QJsonDocument::fromJson(fileText.toUtf8());
-    QJsonObject root = doc.object();
-    QJsonObject states = root["LayoutStates"].toObject();
-
-    QJsonDocument state = QJsonDocument(states[stateId].toObject());
-    QString json = state.toJson();
-    // qWarning() << "got json layoutState: " << json;
-
-    if (json.isEmpty()) {
-      return "{}";
-    }
-    return json;
+    return QJsonDocument(m_stateStore.layoutState(stateId).toJson()).toJson();
 }
 
 void TSProxy::putLayoutState(QString stateId, QString state)
 {
-    QString fileText;
-    QFile file;
-    file.setFileName("/tmp/kwin-bismuth-layoutstates.json");
-    file.open(QIODevice::ReadOnly | QIODevice::Text);
-    fileText = file.readAll();
-    file.close();
-
-    QJsonDocument doc = QJsonDocument::fromJson(fileText.toUtf8());
-    QJsonObject root = doc.object();
-
-    QJsonDocument newDoc = QJsonDocument::fromJson(state.toUtf8());
-    QJsonObject newObj = newDoc.object();
-
-    QJsonObject states = root["LayoutStates"].toObject();
-
-    states[stateId] = newObj;
-
-    root["LayoutStates"] = states;
+    auto stateJson = QJsonDocument::fromJson(state.toUtf8()).object();
+    m_stateStore.setLayoutState(stateId, Bismuth::LayoutState::fromJson(stateJson));
+}
 
-    QJsonDocument writeDoc = QJsonDocument(root);
+QObject *TSProxy::layoutState(const QString &layoutId)
+{
+    auto &layoutState = m_layoutStates[layoutId];
+    if (!layoutState) {
+        layoutState = new Bismuth::LayoutStateProxy(m_stateStore, layoutId, this);
+        QQmlEngine::setObjectOwnership(layoutState, QQmlEngine::CppOwnership);
+    }
 
-    file.open(QIODevice::WriteOnly | QIODevice::Text);
-    // file.seek(0);
-    file.write(writeDoc.toJson());
-    file.close();
+    return layoutState;
 }
 
 QString TSProxy::getWindowState(QString windowId)
 {
-    QString fileText;
-    QFile file;
-    file.setFileName("/tmp/kwin-bismuth-windowstates.json");
-    file.open(QIODevice::ReadOnly | QIODevice::Text);
-    fileText = file.readAll();
-    file.close();
-
-    // qWarning() << fileText;
-    QJsonDocument doc = QJsonDocument::fromJson(fileText.toUtf8());
-    QJsonObject states = doc.object()["WindowStates"].toObject();
-
-    // QJsonValue value = obj.value(windowId);
-
-    // qWarning() << value;
-    // QJsonObject item = value.toObject();
-    // qWarning() << tr("QJsonObject of description: ") << item;
-
-    // /* in case of string value get value and convert into string*/
-    // qWarning() << tr("QJsonObject[appName] of description: ") << item["description"];
-    // QJsonValue subobj = item["description"];
-    // qWarning() << subobj.toString();
-
-    // /* in case of array get array and convert into string*/
-    // qWarning() << tr("QJsonObject[appName] of value: ") << item["imp"];
-    // QJsonArray test = item["imp"].toArray();
-    // qWarning() << test[1].toString();
-
-    // qWarning() << "returning " << obj[windowId].toInt();
-    // return obj[windowId].toInt();
-
-
-    QJsonDocument newState = QJsonDocument(states[windowId].toObject());
-    QString json = newState.toJson();
-    // qWarning() << "got json windowState: " << json;
-
-    if (json.isEmpty()) {
-      return "{}";
-    }
-    return json;
+    return QJsonDocument(m_stateStore.windowState(windowId).toJson()).toJson();
 }
 
 void TSProxy::putWindowState(QString windowId, QString state)
 {
-    QString fileText;
-    QFile file;
-    file.setFileName("/tmp/kwin-bismuth-windowstates.json");
-    file.open(QIODevice::ReadOnly | QIODevice::Text);
-    fileText = file.readAll();
-    file.close();
-
-    QJsonDocument doc = QJsonDocument::fromJson(fileText.toUtf8());
-    QJsonObject root = doc.object();
-    QJsonObject states = root["WindowStates"].toObject();
-
-    // QJsonValue value = obj.value(windowId);
-
-    // if (obj[windowId].toInt() == groupId) {
-    //   file.close();
-    //   return;
-    // }
-
-    // qWarning() << fileText;
-    // qWarning() << obj[windowId];
+    auto stateJson = QJsonDocument::fromJson(state.toUtf8()).object();
+    m_stateStore.setWindowState(windowId, Bismuth::WindowState::fromJson(stateJson));
+}
 
-    // qWarning() << "changing group from " << obj[windowId].toInt() << " to " << groupId;
-    // value.fromVariant(groupId);
-    // obj["group"] = groupId;
+int TSProxy::windowGroup(const QString &windowId)
+{
+    return m_stateStore.windowGroup(windowId);
+}
 
-    states[windowId] = QJsonDocument::fromJson(state.toUtf8()).object();
-    root["WindowStates"] = states;
+void TSProxy::setWindowGroup(const QString &windowId, int group)
+{
+    m_stateStore.setWindowGroup(windowId, group);
+}
 
+bool TSProxy::windowMinimized(const QString &windowId)
+{
+    return m_stateStore.windowMinimized(windowId);
+}
 
-    // doc.fromVariant(value.toObject());
-    // QJsonDocument newDoc = QJsonDocument(obj);
+void TSProxy::setWindowMinimized(const QString &windowId, bool minimized)
+{
+    m_stateStore.setWindowMinimized(windowId, minimized);
+}
 
-    // qWarning() << "json: " << newDoc.toJson();
+QRect TSProxy::windowFloatGeometry(const QString &windowId)
+{
+    return m_stateStore.windowFloatGeometry(windowId);
+}
 
-    file.open(QIODevice::WriteOnly | QIODevice::Text);
-    file.write(QJsonDocument(root).toJson());
-    file.close();
+void TSProxy::setWindowFloatGeometry(const QString &windowId, int x, int y, int width, int height)
+{
+    m_stateStore.setWindowFloatGeometry(windowId, QRect(x, y, width, height));
 }
 
 QString TSProxy::getWindowList()
 {
-    QString fileText;
-    QFile file;
-    file.setFileName("/tmp/kwin-bismuth-windowlist.json");
-    file.open(QIODevice::ReadOnly | QIODevice::Text);
-    fileText = file.readAll();
-    file.close();
-
-    QJsonDocument doc = QJsonDocument::fromJson(fileText.toUtf8());
-    QJsonObject root = doc.object();
-    // QJsonObject list = root["WindowList"].toObject();
+    return QJsonDocument(QJsonArray::fromStringList(m_stateStore.windowList())).toJson();
+}
 
-    QJsonArray list = QJsonArray(root["WindowList"].toArray());
-    QJsonDocument listDoc = QJsonDocument(list);
-    QString json = listDoc.toJson();
-    // qWarning() << "got json list: " << json;
+void TSProxy::putWindowList(const QString list)
+{
+    auto windowIds = QStringList();
+    for (auto windowId : QJsonDocument::fromJson(list.toUtf8()).array()) {
+        windowIds.append(windowId.toString());
+    }
 
-    // if (json.isEmpty() || !root["WindowList"].toArray().count()) {
-    //   return "[]";
-    // }
-    return json;
+    m_stateStore.setWindowList(windowIds);
 }
 
-void TSProxy::putWindowList(const QString list)
+void TSProxy::saveWindowOrder(const QVariantList &clients)
 {
-    QString fileText;
-    QFile file;
-    file.setFileName("/tmp/kwin-bismuth-windowlist.json");
-    file.open(QIODevice::ReadOnly | QIODevice::Text);
-    fileText = file.readAll();
-    file.close();
+    if (m_transactionDepth > 0) {
+        m_pendingWindowOrder = clients;
+        return;
+    }
 
-    QJsonDocument doc = QJsonDocument::fromJson(fileText.toUtf8());
-    QJsonObject root = doc.object();
+    writeWindowOrder(clients);
+}
 
-    QJsonDocument newDoc = QJsonDocument::fromJson(list.toUtf8());
-    QJsonArray newList = newDoc.array();
+void TSProxy::writeWindowOrder(const QVariantList &clients)
+{
+    auto order = windowIds(clients);
+    if (order == m_savedWindowOrder && !m_windowOrderOutdated) {
+        return;
+    }
 
-    // QJsonArray list = root["WindowList"].toArray();
-    // QJsonArray list = QJsonArray(newObj.toArray());
+    auto fingerprints = m_fingerprints.fingerprints(order, [&clients](int index) {
+        return windowIdentity(clientHandle(clients[index]));
+    });
+    m_stateStore.setWindowOrder(fingerprints);
 
-    // root[stateId] = newObj;
+    m_savedWindowOrder = std::move(order);
+    m_windowOrderOutdated = false;
+}
 
-    root["WindowList"] = newList;
+void TSProxy::onClientCaptionChanged()
+{
+    auto windowId = PlasmaApi::ClientHandle(sender()).windowId();
+    m_fingerprints.invalidate(windowId);
 
-    file.open(QIODevice::WriteOnly | QIODevice::Text);
-    file.write(QJsonDocument(root).toJson());
-    file.close();
+    // The fingerprint of the window may have changed, even if the order did not
+    if (std::find(m_savedWindowOrder.cbegin(), m_savedWindowOrder.cend(), windowId) != m_savedWindowOrder.cend()) {
+        m_windowOrderOutdated = true;
+    }
 }
 
-int TSProxy::getSurfaceGroup(int desktop, int screen)
+QVariantList TSProxy::restoreWindowOrder(const QVariantList &clients)
 {
-    QString fileText;
-    QFile file;
-    file.setFileName("/tmp/kwin-bismuth-surfacegroups.json");
-    file.open(QIODevice::ReadOnly | QIODevice::Text);
-    fileText = file.readAll();
-    file.close();
+    auto timer = QElapsedTimer();
+    timer.start();
+
+    auto fingerprints = m_fingerprints.fingerprints(windowIds(clients), [&clients](int index) {
+        return windowIdentity(clientHandle(clients[index]));
+    });
+    auto restored = Bismuth::restoreWindowOrder(m_stateStore.windowOrder(), fingerprints);
+
+    auto result = QVariantList();
+    result.reserve(restored.order.size());
+    for (auto index : restored.order) {
+        result.append(index);
+    }
 
-    QJsonDocument doc = QJsonDocument::fromJson(fileText.toUtf8());
-    QJsonObject root = doc.object();
-    QJsonObject surfs = root["Surfaces"].toObject();
+    auto total = restored.hits + restored.misses;
+    qDebug(Bi) << "Restored the order of" << restored.hits << "windows, hit ratio:" << (total > 0 ? double(restored.hits) / total : 1.0)
+               << "misses:" << restored.misses << "time:" << timer.nsecsElapsed() / 1000 << "us";
 
-    QString id = QString("%1:%2").arg(desktop).arg(screen);
+    return result;
+}
 
-    return surfs[id].toObject()["group"].toInt();
+int TSProxy::getSurfaceGroup(int desktop, int screen)
+{
+    return m_stateStore.surfaceGroup(desktop, screen);
 }
 
 void TSProxy::setSurfaceGroup(int desktop, int screen, int groupID)
 {
-    QString fileText;
-    QFile file;
-    file.setFileName("/tmp/kwin-bismuth-surfacegroups.json");
-    file.open(QIODevice::ReadOnly | QIODevice::Text);
-    fileText = file.readAll();
-    file.close();
-
-    QJsonDocument doc = QJsonDocument::fromJson(fileText.toUtf8());
-    QJsonObject root = doc.object();
-    QJsonObject surfs = root["Surfaces"].toObject();
-
-    QString id = QString("%1:%2").arg(desktop).arg(screen);
+    m_stateStore.setSurfaceGroup(desktop, screen, groupID);
+}
 
-    QJsonObject surf = surfs[id].toObject();
-    surf["group"] = groupID;
+void TSProxy::beginTransaction()
+{
+    m_transactionDepth++;
+    m_stateStore.beginTransaction();
+}
 
-    surfs[id] = surf;
-    root["Surfaces"] = surfs;
+void TSProxy::commitTransaction()
+{
+    if (m_transactionDepth > 0 && --m_transactionDepth == 0 && m_pendingWindowOrder.has_value()) {
+        writeWindowOrder(m_pendingWindowOrder.value());
+        m_pendingWindowOrder.reset();
+    }
 
-    file.open(QIODevice::WriteOnly | QIODevice::Text);
-    file.write(QJsonDocument(root).toJson());
-    file.close();
+    m_stateStore.commitTransaction();
 }
 
 void TSProxy::registerShortcut(const QJSValue &tsAction)
@@ -385,3 +380,8 @@ QJSValue TSProxy::jsController()
 {
     return m_jsController;
 }
+
+Bismuth::StateStore &TSProxy::stateStore()
+{
+    return m_stateStore;
+}
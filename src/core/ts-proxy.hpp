@@ -3,13 +3,20 @@
 
 #pragma once
 
+#include <QHash>
 #include <QJSValue>
 #include <QObject>
 #include <QQmlEngine>
 
+#include <optional>
+#include <vector>
+
 #include "config.hpp"
 #include "controller.hpp"
 #include "plasma-api/api.hpp"
+#include "state/layout_state_proxy.hpp"
+#include "state/state_store.hpp"
+#include "state/window_fingerprint.hpp"
 
 /**
  * Proxy object for the legacy TS backend.
@@ -28,15 +35,56 @@ public:
     Q_INVOKABLE QString getWindowState(const QString);
     Q_INVOKABLE void putWindowState(const QString, const QString);
 
+    /**
+     * Field-level accessors of the window state. Unlike the JSON variants
+     * above they don't serialize the whole state on each access.
+     */
+    Q_INVOKABLE int windowGroup(const QString &windowId);
+    Q_INVOKABLE void setWindowGroup(const QString &windowId, int group);
+    Q_INVOKABLE bool windowMinimized(const QString &windowId);
+    Q_INVOKABLE void setWindowMinimized(const QString &windowId, bool minimized);
+
+    /**
+     * @returns the saved floating geometry of the window or a null rect, if there is none
+     */
+    Q_INVOKABLE QRect windowFloatGeometry(const QString &windowId);
+    Q_INVOKABLE void setWindowFloatGeometry(const QString &windowId, int x, int y, int width, int height);
+
     Q_INVOKABLE QString getLayoutState(const QString);
     Q_INVOKABLE void putLayoutState(const QString, const QString);
 
+    /**
+     * Returns the typed layout state of the surface. Unlike the JSON variants
+     * above, accessing it does not serialize anything.
+     */
+    Q_INVOKABLE QObject *layoutState(const QString &layoutId);
+
     Q_INVOKABLE QString getWindowList();
     Q_INVOKABLE void putWindowList(const QString);
 
+    /**
+     * Save the tiling order of the KWin @p clients. Windows are identified by
+     * fingerprints, that survive KWin restarts, unlike window ids. Inside of
+     * a transaction only the last order is saved, when it is committed.
+     */
+    Q_INVOKABLE void saveWindowOrder(const QVariantList &clients);
+
+    /**
+     * @returns indices of the KWin @p clients in the saved tiling order.
+     * Clients, that are not in the saved order, are left out.
+     */
+    Q_INVOKABLE QVariantList restoreWindowOrder(const QVariantList &clients);
+
     Q_INVOKABLE int getSurfaceGroup(int desktop, int screen);
     Q_INVOKABLE void setSurfaceGroup(int desktop, int screen, int groupID);
 
+    /**
+     * State changes made between these calls are persisted at once, instead
+     * of one by one. Transactions may be nested.
+     */
+    Q_INVOKABLE void beginTransaction();
+    Q_INVOKABLE void commitTransaction();
+
     /**
      * Returns the workspace instance
      */
@@ -56,10 +104,36 @@ public:
     Q_INVOKABLE void setJsController(const QJSValue &);
     QJSValue jsController();
 
+    /**
+     * Store of the state, that is kept between the sessions. The native
+     * engine keeps its layouts there as well.
+     */
+    Bismuth::StateStore &stateStore();
+
+Q_SIGNALS:
+    /**
+     * Emitted, when the group shown on the surface changes. Allows the
+     * legacy backend to keep its caches without asking for the groups again.
+     */
+    void surfaceGroupChanged(int desktop, int screen, int group);
+
+private Q_SLOTS:
+    void onClientCaptionChanged();
+
 private:
+    void writeWindowOrder(const QVariantList &clients);
+
     QQmlEngine *m_engine;
     Bismuth::Config &m_config;
     Bismuth::Controller &m_controller;
     PlasmaApi::Api &m_plasmaApi;
     QJSValue m_jsController;
+    Bismuth::StateStore m_stateStore;
+    QHash<QString, Bismuth::LayoutStateProxy *> m_layoutStates;
+
+    Bismuth::WindowFingerprintCache m_fingerprints;
+    std::vector<quint32> m_savedWindowOrder;          ///< Window ids in the last saved order
+    bool m_windowOrderOutdated;                       ///< The fingerprints changed since the last save
+    std::optional<QVariantList> m_pendingWindowOrder; ///< Saved at the end of the transaction
+    int m_transactionDepth;
 };
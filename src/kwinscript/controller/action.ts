@@ -63,15 +63,18 @@ abstract class ActionImpl implements Action {
   public execute(): void {
     this.log.log(`Executing action: ${this.key}`);
 
-    const currentLayout = this.engine.currentLayoutOnCurrentSurface();
-    if (currentLayout.executeAction) {
-      currentLayout.executeAction(this.engine, this);
-    } else {
-      this.executeWithoutLayoutOverride();
-    }
-
-    // TODO: Maybe it worth moving this into engine?
-    this.engine.arrange(this.engine.currentSurface);
+    // All the state changes of the action are persisted at once
+    this.engine.transaction(() => {
+      const currentLayout = this.engine.currentLayoutOnCurrentSurface();
+      if (currentLayout.executeAction) {
+        currentLayout.executeAction(this.engine, this);
+      } else {
+        this.executeWithoutLayoutOverride();
+      }
+
+      // TODO: Maybe it worth moving this into engine?
+      this.engine.arrange(this.engine.currentSurface);
+    });
   }
 
   /**
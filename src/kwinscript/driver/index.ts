@@ -4,7 +4,11 @@
 // SPDX-License-Identifier: MIT
 
 import { DriverSurface } from "./surface";
-import { DriverSurfaceImpl } from "./surface";
+import {
+  DriverSurfaceImpl,
+  DriverSurfaceRegistry,
+  SurfaceGroupCache,
+} from "./surface";
 import { DriverWindow, DriverWindowImpl } from "./window";
 
 import { Controller } from "../controller";
@@ -106,14 +110,10 @@ export class DriverImpl implements Driver {
     // );
     const desktop = this.proxy.workspace().currentDesktop;
     const screen = this.proxy.workspace().activeScreen;
-    return new DriverSurfaceImpl(
+    return this.surfaces.get(
       screen,
       this.proxy.workspace().currentActivity,
-      desktop,
-      this.qml.activityInfo,
-      this.config,
-      this.proxy,
-      this.log
+      desktop
     );
   }
 
@@ -166,22 +166,14 @@ export class DriverImpl implements Driver {
     // for (let screen = 0; screen < this.proxy.workspace().numScreens; screen++) {
     for (let screen = 0; screen < this.proxy.workspace().numScreens; screen++) {
       // this.log.log(`for ${screen} making ${this.groupMap[screen]}`);
-      screensArr.push(
-        new DriverSurfaceImpl(
-          screen,
-          activity,
-          desktop,
-          this.qml.activityInfo,
-          this.config,
-          this.proxy,
-          this.log
-        )
-      );
+      screensArr.push(this.surfaces.get(screen, activity, desktop));
     }
     return screensArr;
   }
 
   private controller: Controller;
+  private surfaceGroups: SurfaceGroupCache;
+  private surfaces: DriverSurfaceRegistry;
   private windowMap: WrapperMap<KWin.Client, EngineWindow>;
   private entered: boolean;
 
@@ -244,6 +236,15 @@ export class DriverImpl implements Driver {
     }
 
     this.controller = controller;
+    this.surfaceGroups = new SurfaceGroupCache(this.proxy);
+    this.surfaces = new DriverSurfaceRegistry(
+      kwinApi.workspace,
+      qmlObjects.activityInfo,
+      this.config,
+      this.proxy,
+      this.surfaceGroups,
+      this.log
+    );
     this.windowMap = new WrapperMap(
       (client: KWin.Client) => DriverWindowImpl.generateID(client),
       (client: KWin.Client) => {
@@ -262,6 +263,7 @@ export class DriverImpl implements Driver {
             this.config,
             this.log,
             this.proxy,
+            this.surfaces,
             this.controller.screens()[client.screen].group
           ),
           this.config,
@@ -573,6 +575,8 @@ export class DriverImpl implements Driver {
         this.log.log(`Callback was already deleted. Ignoring it.`);
       }
     }
+    this.surfaces.drop();
+    this.surfaceGroups.drop();
   }
 
   /**
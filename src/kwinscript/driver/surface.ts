@@ -39,6 +39,213 @@ export interface DriverSurface {
   next(): DriverSurface | null;
 }
 
+/**
+ * JS-side copy of the surface groups kept by the core. The copy is updated by
+ * the core's change notifications, so reading a group does not leave the
+ * script.
+ */
+export class SurfaceGroupCache {
+  private groups: { [key: string]: number };
+  private readonly onGroupChanged: (
+    desktop: number,
+    screen: number,
+    groupID: number
+  ) => void;
+
+  constructor(private proxy: TSProxy) {
+    this.groups = {};
+    this.onGroupChanged = (
+      desktop: number,
+      screen: number,
+      groupID: number
+    ): void => {
+      this.groups[SurfaceGroupCache.key(desktop, screen)] = groupID;
+    };
+    this.proxy.surfaceGroupChanged.connect(this.onGroupChanged);
+  }
+
+  public get(desktop: number, screen: number): number {
+    const key = SurfaceGroupCache.key(desktop, screen);
+    let groupID = this.groups[key];
+    if (groupID === undefined) {
+      groupID = this.groups[key] = this.proxy.getSurfaceGroup(desktop, screen);
+    }
+    return groupID;
+  }
+
+  public set(desktop: number, screen: number, groupID: number): void {
+    // The cache is updated by the change notification
+    this.proxy.setSurfaceGroup(desktop, screen, groupID);
+  }
+
+  /**
+   * Stop listening to the core
+   */
+  public drop(): void {
+    this.proxy.surfaceGroupChanged.disconnect(this.onGroupChanged);
+  }
+
+  private static key(desktop: number, screen: number): string {
+    return `${desktop}:${screen}`;
+  }
+}
+
+/**
+ * Interned surfaces of the driver, one per screen, activity and desktop. A
+ * surface reads its working area from KWin, when it is made, so the surfaces
+ * are reused, until the screens, the desktops, the activities or the panels
+ * change.
+ */
+export class DriverSurfaceRegistry {
+  private surfaces: { [key: string]: DriverSurfaceImpl };
+  private hits: number;
+  private misses: number;
+  private readonly onTopologyChanged: () => void;
+  private readonly topologySignals: QSignal[];
+  private readonly onClientAdded: (client: KWin.Client) => void;
+  private readonly onClientRemoved: (client: KWin.Client) => void;
+  private docks: KWin.Client[];
+
+  constructor(
+    private workspace: KWin.WorkspaceWrapper,
+    private activityInfo: Plasma.TaskManager.ActivityInfo,
+    private config: Config,
+    private proxy: TSProxy,
+    private surfaceGroups: SurfaceGroupCache,
+    private log: Log
+  ) {
+    this.surfaces = {};
+    this.hits = 0;
+    this.misses = 0;
+
+    // Not connected through the driver, so that the surfaces are dropped
+    // even while the driver handles another signal
+    this.onTopologyChanged = (): void => this.invalidate();
+    this.topologySignals = [
+      workspace.numberScreensChanged,
+      workspace.screenResized,
+      workspace.numberDesktopsChanged,
+      workspace.activityAdded,
+      workspace.activityRemoved,
+    ];
+    for (const signal of this.topologySignals) {
+      signal.connect(this.onTopologyChanged);
+    }
+
+    // The panels take the space of the working areas, like in the Workspace
+    // of the core
+    this.docks = [];
+    this.onClientAdded = (client: KWin.Client): void => this.watchDock(client);
+    this.onClientRemoved = (client: KWin.Client): void => {
+      const index = this.docks.indexOf(client);
+      if (index >= 0) {
+        this.docks.splice(index, 1);
+        this.invalidate();
+      }
+    };
+    workspace.clientAdded.connect(this.onClientAdded);
+    workspace.clientRemoved.connect(this.onClientRemoved);
+    for (const client of workspace.clientList()) {
+      this.watchDock(client);
+    }
+  }
+
+  public get(
+    screen: number,
+    activity: string,
+    desktop: number
+  ): DriverSurfaceImpl {
+    const key = DriverSurfaceRegistry.key(screen, activity, desktop);
+    let surface = this.surfaces[key];
+    if (surface === undefined) {
+      this.misses++;
+      surface = this.surfaces[key] = new DriverSurfaceImpl(
+        screen,
+        activity,
+        desktop,
+        this.activityInfo,
+        this.config,
+        this.proxy,
+        this.surfaceGroups,
+        this.log,
+        this
+      );
+    } else {
+      this.hits++;
+    }
+    return surface;
+  }
+
+  /**
+   * Forget all the surfaces, so that they are made again with the new
+   * working areas
+   */
+  public invalidate(): void {
+    this.log.log(`Surfaces invalidated. ${this.stats()}`);
+    this.surfaces = {};
+  }
+
+  /**
+   * Stop listening to KWin
+   */
+  public drop(): void {
+    this.log.log(`Surfaces dropped. ${this.stats()}`);
+    for (const signal of this.topologySignals) {
+      try {
+        signal.disconnect(this.onTopologyChanged);
+      } catch (e: any) {
+        // The workspace is already deleted
+      }
+    }
+
+    try {
+      this.workspace.clientAdded.disconnect(this.onClientAdded);
+      this.workspace.clientRemoved.disconnect(this.onClientRemoved);
+    } catch (e: any) {
+      // The workspace is already deleted
+    }
+
+    for (const dock of this.docks) {
+      try {
+        dock.frameGeometryChanged.disconnect(this.onTopologyChanged);
+      } catch (e: any) {
+        // The panel is already deleted
+      }
+    }
+    this.docks = [];
+  }
+
+  /**
+   * Drop the surfaces, whenever the panel of the @p client is added, moved
+   * or resized. The other clients are ignored.
+   */
+  private watchDock(client: KWin.Client): void {
+    if (!client || !client.dock || this.docks.indexOf(client) >= 0) {
+      return;
+    }
+
+    // A new panel takes its space right away
+    this.invalidate();
+
+    this.docks.push(client);
+    client.frameGeometryChanged.connect(this.onTopologyChanged);
+  }
+
+  private stats(): string {
+    const lookups = this.hits + this.misses;
+    const hitRate = lookups > 0 ? Math.round((100 * this.hits) / lookups) : 0;
+    return `Surface lookups: ${lookups}, hits: ${this.hits}, misses: ${this.misses}, hit rate: ${hitRate}%`;
+  }
+
+  private static key(
+    screen: number,
+    activity: string,
+    desktop: number
+  ): string {
+    return `${screen}@${activity}#${desktop}`;
+  }
+}
+
 export class DriverSurfaceImpl implements DriverSurface {
   public readonly id: string;
   public readonly ignore: boolean;
@@ -51,7 +258,9 @@ export class DriverSurfaceImpl implements DriverSurface {
     private activityInfo: Plasma.TaskManager.ActivityInfo,
     private config: Config,
     private proxy: TSProxy,
-    private log: Log
+    private surfaceGroups: SurfaceGroupCache,
+    private log: Log,
+    private surfaces: DriverSurfaceRegistry
   ) {
     this.id = this.generateId();
 
@@ -77,15 +286,7 @@ export class DriverSurfaceImpl implements DriverSurface {
       return null;
     }
 
-    return new DriverSurfaceImpl(
-      this.screen,
-      this.activity,
-      this.desktop + 1,
-      this.activityInfo,
-      this.config,
-      this.proxy,
-      this.log
-    );
+    return this.surfaces.get(this.screen, this.activity, this.desktop + 1);
   }
 
   public set screen(screen: number) {
@@ -97,7 +298,7 @@ export class DriverSurfaceImpl implements DriverSurface {
   }
 
   public get group(): number {
-    let g = this.proxy.getSurfaceGroup(this.desktop, this.screen);
+    let g = this.surfaceGroups.get(this.desktop, this.screen);
     if (!g) {
       const customScreenOrder = [4, 1, 3, 2, 5, 6, 7, 8, 9];
       g = (this.desktop - 1) * 5 + customScreenOrder[this.screen];
@@ -109,7 +310,7 @@ export class DriverSurfaceImpl implements DriverSurface {
 
   public set group(groupID: number) {
     this.log.log(`setSurfaceGroup: ${this.desktop}:${this.screen} ${groupID}`);
-    this.proxy.setSurfaceGroup(this.desktop, this.screen, groupID);
+    this.surfaceGroups.set(this.desktop, this.screen, groupID);
   }
 
   public toString(): string {
@@ -3,14 +3,18 @@
 //
 // SPDX-License-Identifier: MIT
 
-import { DriverSurface, DriverSurfaceImpl } from "./surface";
+import {
+  DriverSurface,
+  DriverSurfaceImpl,
+  DriverSurfaceRegistry,
+} from "./surface";
 
 import { Rect } from "../util/rect";
 import { clip, matchWords } from "../util/func";
 import { Config } from "../config";
 import { Log } from "../util/log";
 import { TSProxy } from "../extern/proxy";
-import { EngineWindow, WindowConfig } from "../engine/window";
+import { EngineWindow } from "../engine/window";
 
 /**
  * Hijack kwin's desktop module to gain the ability to hide and show windows
@@ -110,6 +114,12 @@ export interface DriverWindow {
 
 export class DriverWindowImpl implements DriverWindow {
   public readonly id: string;
+
+  /**
+   * Key of the window in the persisted window states
+   */
+  public readonly stateId: string;
+
   private _screen: number | null;
 
   public get fullScreen(): boolean {
@@ -173,17 +183,7 @@ export class DriverWindowImpl implements DriverWindow {
 
   public set minimized(min: boolean) {
     this.client.minimized = min;
-
-    const state = JSON.parse(
-      this.proxy.getWindowState(this.client.windowId.toString())
-    ) as WindowConfig;
-
-    state.minimized = min;
-
-    this.proxy.putWindowState(
-      this.client.windowId.toString(),
-      JSON.stringify(state)
-    );
+    this.proxy.setWindowMinimized(this.stateId, min);
   }
 
   public get shaded(): boolean {
@@ -217,15 +217,7 @@ export class DriverWindowImpl implements DriverWindow {
       return null;
     }
 
-    return new DriverSurfaceImpl(
-      this.screen,
-      activity,
-      desktop,
-      this.qml.activityInfo,
-      this.config,
-      this.proxy,
-      this.log
-    );
+    return this.surfaces.get(this.screen, activity, desktop);
   }
 
   public set surface(surf: DriverSurface | null) {
@@ -272,26 +264,12 @@ export class DriverWindowImpl implements DriverWindow {
     //   return this.surface.group;
     // }
 
-    const state = JSON.parse(
-      this.proxy.getWindowState(this.client.windowId.toString())
-    ) as WindowConfig;
-    const g = state.group;
-    // this.log.log(`got window group ${g}`);
-    return g;
+    return this.proxy.windowGroup(this.stateId);
     // return this._group;
   }
 
   public set group(groupId: number) {
-    const state = JSON.parse(
-      this.proxy.getWindowState(this.client.windowId.toString())
-    ) as WindowConfig;
-
-    state.group = groupId;
-
-    this.proxy.putWindowState(
-      this.client.windowId.toString(),
-      JSON.stringify(state)
-    );
+    this.proxy.setWindowGroup(this.stateId, groupId);
   }
 
   public get hidden(): boolean {
@@ -336,6 +314,9 @@ export class DriverWindowImpl implements DriverWindow {
    * @param qml root qml object of the script
    * @param config
    * @param log
+   * @param proxy
+   * @param surfaces surfaces of the driver, shared by all the windows
+   * @param _group the group to use, if the window has none yet
    */
   constructor(
     public readonly client: KWin.Client,
@@ -343,9 +324,11 @@ export class DriverWindowImpl implements DriverWindow {
     private config: Config,
     private log: Log,
     private proxy: TSProxy,
+    private surfaces: DriverSurfaceRegistry,
     private _group: number
   ) {
     this.id = DriverWindowImpl.generateID(client);
+    this.stateId = client.windowId.toString();
     this.maximized = false;
     this.noBorderManaged = false;
     this.noBorderOriginal = client.noBorder;
@@ -58,6 +58,11 @@ export interface Engine {
 
   saveWindows(): void;
 
+  /**
+   * Run the function, persisting all the state changes it makes at once
+   */
+  transaction(fn: () => void): void;
+
   /**
    * Adjust layout based on the change in size of a tile.
    *
@@ -529,24 +534,21 @@ export class EngineImpl implements Engine {
   }
 
   public restoreWindows(windows: EngineWindow[]): void {
-    const cachedList = this.proxy.getWindowList();
-    const list = JSON.parse(cachedList) as string[];
-    for (const id of list) {
-      for (const window of windows) {
-        if (
-          (window.window as DriverWindowImpl).client.windowId.toString() ==
-            id &&
-          !window.shouldIgnore
-        ) {
-          this.log.log(`restoring window position for: ${window}`);
-          window.state = WindowState.Undecided;
-          this.windows.push(window);
-          break;
-        }
+    const clients = windows.map(
+      (window) => (window.window as DriverWindowImpl).client
+    );
+    const restored = new Set<EngineWindow>();
+    for (const index of this.proxy.restoreWindowOrder(clients)) {
+      const window = windows[index];
+      if (!window.shouldIgnore) {
+        this.log.log(`restoring window position for: ${window}`);
+        window.state = WindowState.Undecided;
+        this.windows.push(window);
+        restored.add(window);
       }
     }
     for (const window of windows) {
-      if (!this.windows.contains(window) && !window.shouldIgnore) {
+      if (!restored.has(window) && !window.shouldIgnore) {
         window.state = WindowState.Undecided;
         this.windows.push(window);
       }
@@ -554,11 +556,19 @@ export class EngineImpl implements Engine {
   }
 
   public saveWindows(): void {
-    const list: string[] = [];
-    for (const window of (this.windows as WindowStoreImpl).list) {
-      list.push((window.window as DriverWindowImpl).client.windowId.toString());
+    const clients = (this.windows as WindowStoreImpl).list.map(
+      (window) => (window.window as DriverWindowImpl).client
+    );
+    this.proxy.saveWindowOrder(clients);
+  }
+
+  public transaction(fn: () => void): void {
+    this.proxy.beginTransaction();
+    try {
+      fn();
+    } finally {
+      this.proxy.commitTransaction();
     }
-    this.proxy.putWindowList(JSON.stringify(list));
   }
 
   /**
@@ -42,7 +42,8 @@ export default class SpiralLayout implements WindowsLayout {
   ) {
     this.config = config;
 
-    this.state = new LayoutState(this.proxy, uid, this.classID);
+    this.state = this.proxy.layoutState(uid);
+    this.state.classID = this.classID;
 
     this.depth = 1;
     this.parts = new HalfSplitLayoutPart(
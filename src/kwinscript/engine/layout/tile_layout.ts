@@ -72,7 +72,8 @@ export default class TileLayout implements WindowsLayout {
     public readonly uid: string
   ) {
     this.config = config;
-    this.state = new LayoutState(this.proxy, uid, this.classID);
+    this.state = this.proxy.layoutState(uid);
+    this.state.classID = this.classID;
 
     this.parts = new RotateLayoutPart(
       new HalfSplitLayoutPart(
@@ -89,6 +90,7 @@ export default class TileLayout implements WindowsLayout {
 
     this.parts.angle = this.state.rotation;
     this.numMaster = this.state.numMasterTiles;
+    this.masterRatio = this.state.masterRatio;
   }
 
   public adjust(
@@ -98,6 +100,7 @@ export default class TileLayout implements WindowsLayout {
     delta: RectDelta
   ): void {
     this.parts.adjust(area, tiles, basis, delta);
+    this.state.masterRatio = this.masterRatio;
   }
 
   public apply(
@@ -126,12 +129,14 @@ export default class TileLayout implements WindowsLayout {
         TileLayout.MIN_MASTER_RATIO,
         TileLayout.MAX_MASTER_RATIO
       );
+      this.state.masterRatio = this.masterRatio;
     } else if (action instanceof IncreaseLayoutMasterAreaSize) {
       this.masterRatio = clip(
         slide(this.masterRatio, +0.05),
         TileLayout.MIN_MASTER_RATIO,
         TileLayout.MAX_MASTER_RATIO
       );
+      this.state.masterRatio = this.masterRatio;
     } else if (action instanceof IncreaseMasterAreaWindowCount) {
       // TODO: define arbitrary constant
       if (this.numMaster < 10) {
@@ -5,7 +5,7 @@
 
 import FloatingLayout from "./layout/floating_layout";
 
-import { LayoutState, State, WindowsLayout } from "./layout";
+import { LayoutState, WindowsLayout } from "./layout";
 
 import { DriverSurface } from "../driver/surface";
 
@@ -38,7 +38,7 @@ export class LayoutStoreEntry {
     this.currentIndex = 0;
     this.layouts = {};
 
-    const state = JSON.parse(this.proxy.getLayoutState(this.uid)) as State;
+    const state = this.proxy.layoutState(this.uid);
 
     if (state.classID) {
       this.currentID = state.classID;
@@ -85,7 +85,6 @@ export class LayoutStoreEntry {
   private loadLayout(ID: string): WindowsLayout {
     let layout = this.layouts[ID];
     if (!layout) {
-      // const state = JSON.parse(this.proxy.getLayoutState(this.surfId)) as State;
       const state = null;
       if (state) {
         // layout = this.layouts[ID] = this.createLayoutFromId(state.class);
@@ -239,7 +239,25 @@ export class EngineWindowImpl implements EngineWindow {
     return this.window.shaded;
   }
 
-  public floatGeometry: Rect;
+  /**
+   * Geometry of the window, when it floats. Persisted, so that it survives
+   * KWin restarts.
+   */
+  public get floatGeometry(): Rect {
+    return this._floatGeometry;
+  }
+
+  public set floatGeometry(value: Rect) {
+    this._floatGeometry = value;
+    this.proxy.setWindowFloatGeometry(
+      (this.window as DriverWindowImpl).stateId,
+      value.x,
+      value.y,
+      value.width,
+      value.height
+    );
+  }
+
   public geometry: Rect;
   public timestamp: number;
 
@@ -341,6 +359,7 @@ export class EngineWindowImpl implements EngineWindow {
     return this.window.isDialog;
   }
 
+  private _floatGeometry: Rect;
   private internalState: WindowState;
   private internalStatePreviouslyAskedToChangeTo: WindowState;
   private shouldCommitFloat: boolean;
@@ -362,7 +381,13 @@ export class EngineWindowImpl implements EngineWindow {
     // this._group = window.surface.currentGroup;
     // this.log.log(`made on ${this._group} ${this}`);
 
-    this.floatGeometry = window.geometry;
+    const savedFloatGeometry = this.proxy.windowFloatGeometry(
+      (window as DriverWindowImpl).stateId
+    );
+    this._floatGeometry =
+      savedFloatGeometry.width > 0 && savedFloatGeometry.height > 0
+        ? Rect.fromQRect(savedFloatGeometry)
+        : window.geometry;
     this.geometry = window.geometry;
     this.timestamp = 0;
 
@@ -370,12 +395,9 @@ export class EngineWindowImpl implements EngineWindow {
     this.shouldCommitFloat = this.shouldFloat;
     this.weightMap = {};
 
-    const w = JSON.parse(
-      this.proxy.getWindowState(
-        (this.window as DriverWindowImpl).client.windowId.toString()
-      )
-    ) as WindowConfig;
-    if (w.minimized) {
+    if (
+      this.proxy.windowMinimized((this.window as DriverWindowImpl).stateId)
+    ) {
       this.log.log(`found minimized window ${this}`);
       this.minimized = true;
       this.state = WindowState.NativeMinimized;
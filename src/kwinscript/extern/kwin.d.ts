@@ -218,6 +218,12 @@ declare namespace KWin {
      */
     readonly specialWindow: boolean;
 
+    /**
+     * Whether the window is a dock, e.g. a panel, that takes the space of the
+     * screen from the other windows
+     */
+    readonly dock: boolean;
+
     /**
      * Whether the windows is transient to an other windows, i.e. it is a sub window belonging to
      * a main window
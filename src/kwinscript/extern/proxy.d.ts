@@ -3,6 +3,7 @@
 
 import { Config } from "../config";
 import { Action } from "../controller/action";
+import { LayoutState } from "../engine/layout";
 
 export interface TSProxy {
   workspace(): KWin.WorkspaceWrapper;
@@ -11,11 +12,47 @@ export interface TSProxy {
   log(value: any): void;
   getWindowState(windowId: string): string;
   putWindowState(windowId: string, state: string): void;
+  windowGroup(windowId: string): number;
+  setWindowGroup(windowId: string, group: number): void;
+  windowMinimized(windowId: string): boolean;
+  setWindowMinimized(windowId: string, minimized: boolean): void;
+  windowFloatGeometry(windowId: string): QRect;
+  setWindowFloatGeometry(
+    windowId: string,
+    x: number,
+    y: number,
+    width: number,
+    height: number
+  ): void;
   getLayoutState(layoutId: string): string;
   putLayoutState(layoutId: string, state: string): void;
-  // layoutState(stateId: string): LayoutState;
+  layoutState(layoutId: string): LayoutState;
   getWindowList(): string;
   putWindowList(list: string): void;
+
+  /**
+   * Save the tiling order of the clients. Unlike window ids, it survives
+   * KWin restarts.
+   */
+  saveWindowOrder(clients: KWin.Client[]): void;
+
+  /**
+   * Returns indices of the clients in the saved tiling order. Clients, that
+   * are not in the saved order, are left out.
+   */
+  restoreWindowOrder(clients: KWin.Client[]): number[];
   getSurfaceGroup(desktop: number, screen: number): number;
   setSurfaceGroup(desktop: number, screen: number, groupID: number): void;
+
+  /**
+   * State changes made between these calls are persisted at once. The calls
+   * may be nested.
+   */
+  beginTransaction(): void;
+  commitTransaction(): void;
+
+  /**
+   * Emitted with (desktop, screen, groupID), when the group of the surface changes
+   */
+  surfaceGroupChanged: QSignal;
 }
@@ -0,0 +1,239 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include <doctest/doctest.h>
+
+#include <QCoreApplication>
+#include <QObject>
+#include <QQmlContext>
+#include <QQmlEngine>
+
+#include <memory>
+#include <vector>
+
+#include "config.mock.hpp"
+#include "engine/arrange_scheduler.hpp"
+#include "engine/engine.hpp"
+#include "engine/surface.hpp"
+#include "plasma-api/api.hpp"
+#include "plasma-api/client_handle.hpp"
+#include "plasma-api/workspace.hpp"
+
+#include "plasma-api/client.mock.hpp"
+#include "plasma-api/workspace.mock.hpp"
+
+TEST_CASE("Arrange Scheduler")
+{
+    auto arranged = std::vector<Bismuth::Surface>();
+    auto scheduler = Bismuth::ArrangeScheduler([&](const Bismuth::Surface &surface) {
+        arranged.push_back(surface);
+    });
+
+    auto surface1 = Bismuth::Surface(1, 0, QStringLiteral("abc"));
+    auto surface2 = Bismuth::Surface(1, 1, QStringLiteral("abc"));
+
+    SUBCASE("Repeated requests are coalesced")
+    {
+        for (auto i = 0; i < 10; i++) {
+            scheduler.schedule(surface1);
+        }
+        scheduler.schedule(std::vector<Bismuth::Surface>({surface1, surface2}));
+
+        CHECK(arranged.empty());
+        CHECK(scheduler.hasPendingArranges());
+
+        QCoreApplication::processEvents();
+
+        CHECK(arranged.size() == 2);
+        CHECK(scheduler.requestedArranges() == 12);
+        CHECK(scheduler.executedArranges() == 2);
+        CHECK(!scheduler.hasPendingArranges());
+    }
+
+    SUBCASE("Hidden surfaces are arranged, once shown")
+    {
+        auto currentScreens = 1;
+        scheduler.setVisibilityFilter([&](const Bismuth::Surface &surface) {
+            return surface.screen() < currentScreens;
+        });
+
+        scheduler.schedule(std::vector<Bismuth::Surface>({surface1, surface2}));
+        scheduler.schedule(surface2);
+        QCoreApplication::processEvents();
+
+        CHECK(arranged.size() == 1);
+        CHECK(scheduler.deferredArranges() == 1);
+        CHECK(scheduler.isStale(surface2));
+
+        // Still hidden
+        scheduler.scheduleStale();
+        QCoreApplication::processEvents();
+        CHECK(arranged.size() == 1);
+        CHECK(scheduler.deferredArranges() == 1);
+
+        currentScreens = 2;
+        scheduler.scheduleStale();
+        QCoreApplication::processEvents();
+
+        CHECK(arranged.size() == 2);
+        CHECK(arranged.back() == surface2);
+        CHECK(!scheduler.isStale(surface2));
+    }
+
+    SUBCASE("Removed surfaces are not stale anymore")
+    {
+        scheduler.setVisibilityFilter([&](const Bismuth::Surface &surface) {
+            return surface.screen() < 1;
+        });
+
+        scheduler.schedule(surface2);
+        QCoreApplication::processEvents();
+        REQUIRE(scheduler.isStale(surface2));
+
+        scheduler.dropRemovedSurfaces([&](const Bismuth::Surface &surface) {
+            return surface.screen() < 1;
+        });
+        CHECK(!scheduler.isStale(surface2));
+    }
+
+    SUBCASE("Flush arranges right away")
+    {
+        scheduler.schedule(surface1);
+        scheduler.flush();
+        CHECK(arranged.size() == 1);
+
+        // Nothing is left for the event loop
+        QCoreApplication::processEvents();
+        CHECK(arranged.size() == 1);
+    }
+}
+
+TEST_CASE("Arrange Scheduler Session Restore")
+{
+    constexpr auto numClients = 50;
+
+    auto qmlEngine = QQmlEngine();
+    auto fakeKWinWorkspace = FakeKWinWorkspace();
+    fakeKWinWorkspace.m_currentDesktop = 1;
+    fakeKWinWorkspace.m_currentActivity = QStringLiteral("abc");
+    fakeKWinWorkspace.m_numScreens = 2;
+    qmlEngine.rootContext()->setContextProperty(QStringLiteral("workspace"), &fakeKWinWorkspace);
+
+    auto config = FakeConfig();
+    auto plasmaApi = PlasmaApi::Api(&qmlEngine);
+    auto engine = Bismuth::Engine(plasmaApi, config);
+
+    // The same as the controller does with the experimental backend
+    QObject::connect(&plasmaApi.workspace(), &PlasmaApi::Workspace::clientAdded, [&](PlasmaApi::ClientHandle client) {
+        engine.addWindow(client);
+    });
+
+    // All the windows of the session appear at once on 2 screens
+    auto clients = std::vector<std::unique_ptr<FakeKWinClient>>();
+    for (auto i = 0; i < numClients; i++) {
+        auto client = std::make_unique<FakeKWinClient>();
+        client->m_desktop = 1;
+        client->m_screen = i % 2;
+        client->m_activities = QStringList(QStringLiteral("abc"));
+        Q_EMIT fakeKWinWorkspace.clientAdded(reinterpret_cast<KWin::AbstractClient *>(client.get()));
+        clients.push_back(std::move(client));
+    }
+
+    auto &scheduler = engine.arrangeScheduler();
+    CHECK(scheduler.requestedArranges() == numClients);
+    CHECK(scheduler.executedArranges() == 0);
+
+    QCoreApplication::processEvents();
+
+    MESSAGE("Arranges requested: " << scheduler.requestedArranges() << ", executed: " << scheduler.executedArranges());
+    CHECK(scheduler.executedArranges() == 2);
+
+    // Every window got its place on its screen
+    for (auto &client : clients) {
+        auto screenArea = fakeKWinWorkspace.clientArea(FakeKWinWorkspace::PlacementArea, client->m_screen, 1);
+        CHECK(!client->m_frameGeometry.isEmpty());
+        CHECK(screenArea.contains(client->m_frameGeometry));
+    }
+
+    // Once the areas of the screens are known, KWin is not asked for them again
+    auto clientAreaCalls = fakeKWinWorkspace.m_clientAreaCalls;
+    engine.arrangeWindowsOnVisibleSurfaces();
+    QCoreApplication::processEvents();
+
+    CHECK(scheduler.executedArranges() == 4);
+    CHECK(fakeKWinWorkspace.m_clientAreaCalls == clientAreaCalls);
+}
+
+TEST_CASE("Arrange Scheduler Sticky Window")
+{
+    constexpr auto numDesktops = 10;
+    auto activities = QStringList({QStringLiteral("a"), QStringLiteral("b"), QStringLiteral("c"), QStringLiteral("d"), QStringLiteral("e")});
+
+    auto qmlEngine = QQmlEngine();
+    auto fakeKWinWorkspace = FakeKWinWorkspace();
+    fakeKWinWorkspace.m_numberOfDesktops = numDesktops;
+    fakeKWinWorkspace.m_activities = activities;
+    fakeKWinWorkspace.m_currentDesktop = 1;
+    fakeKWinWorkspace.m_currentActivity = activities.front();
+    fakeKWinWorkspace.m_numScreens = 1;
+    qmlEngine.rootContext()->setContextProperty(QStringLiteral("workspace"), &fakeKWinWorkspace);
+
+    auto config = FakeConfig();
+    auto plasmaApi = PlasmaApi::Api(&qmlEngine);
+    auto engine = Bismuth::Engine(plasmaApi, config);
+    auto &scheduler = engine.arrangeScheduler();
+
+    // On all desktops and all activities
+    auto fakeClient = FakeKWinClient();
+    fakeClient.m_onAllDesktops = true;
+    engine.addWindow(PlasmaApi::ClientHandle(&fakeClient));
+
+    QCoreApplication::processEvents();
+
+    // Only the current surface is arranged
+    CHECK(scheduler.requestedArranges() == numDesktops * activities.size());
+    CHECK(scheduler.executedArranges() == 1);
+    CHECK(scheduler.deferredArranges() == numDesktops * activities.size() - 1);
+
+    // Switching the desktop arranges the surface, that is shown now
+    fakeKWinWorkspace.m_currentDesktop = 2;
+    engine.arrangeStaleSurfaces();
+    QCoreApplication::processEvents();
+
+    CHECK(scheduler.executedArranges() == 2);
+    CHECK(!scheduler.isStale(Bismuth::Surface(2, 0, activities.front())));
+    CHECK(scheduler.isStale(Bismuth::Surface(3, 0, activities.front())));
+}
+
+TEST_CASE("Arrange Scheduler Removed Desktops")
+{
+    auto activities = QStringList({QStringLiteral("a")});
+
+    auto qmlEngine = QQmlEngine();
+    auto fakeKWinWorkspace = FakeKWinWorkspace();
+    fakeKWinWorkspace.m_numberOfDesktops = 3;
+    fakeKWinWorkspace.m_activities = activities;
+    fakeKWinWorkspace.m_currentDesktop = 1;
+    fakeKWinWorkspace.m_currentActivity = activities.front();
+    fakeKWinWorkspace.m_numScreens = 1;
+    qmlEngine.rootContext()->setContextProperty(QStringLiteral("workspace"), &fakeKWinWorkspace);
+
+    auto config = FakeConfig();
+    auto plasmaApi = PlasmaApi::Api(&qmlEngine);
+    auto engine = Bismuth::Engine(plasmaApi, config);
+    auto &scheduler = engine.arrangeScheduler();
+
+    auto fakeClient = FakeKWinClient();
+    fakeClient.m_onAllDesktops = true;
+    engine.addWindow(PlasmaApi::ClientHandle(&fakeClient));
+    QCoreApplication::processEvents();
+
+    REQUIRE(scheduler.isStale(Bismuth::Surface(3, 0, activities.front())));
+
+    fakeKWinWorkspace.m_numberOfDesktops = 2;
+    Q_EMIT fakeKWinWorkspace.numberDesktopsChanged(3);
+    engine.updateSurfaces();
+
+    CHECK(scheduler.isStale(Bismuth::Surface(2, 0, activities.front())));
+    CHECK(!scheduler.isStale(Bismuth::Surface(3, 0, activities.front())));
+}
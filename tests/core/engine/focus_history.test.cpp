@@ -0,0 +1,141 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include <doctest/doctest.h>
+
+#include <QCoreApplication>
+#include <QObject>
+#include <QQmlContext>
+#include <QQmlEngine>
+#include <QStringList>
+#include <QVariant>
+
+#include <memory>
+#include <vector>
+
+#include "config.mock.hpp"
+#include "engine/engine.hpp"
+#include "engine/focus_history.hpp"
+#include "engine/surface.hpp"
+#include "engine/window.hpp"
+#include "plasma-api/api.hpp"
+#include "plasma-api/client_handle.hpp"
+#include "plasma-api/workspace.hpp"
+
+#include "plasma-api/client.mock.hpp"
+#include "plasma-api/workspace.mock.hpp"
+
+TEST_CASE("Focus History")
+{
+    auto fakeKWinWorkspace = FakeKWinWorkspace();
+    auto workspace = PlasmaApi::Workspace(&fakeKWinWorkspace);
+
+    auto fakeClients = std::vector<std::unique_ptr<FakeKWinClient>>();
+    auto windows = std::vector<std::unique_ptr<Bismuth::Window>>();
+    for (auto i = 0; i < 3; i++) {
+        fakeClients.push_back(std::make_unique<FakeKWinClient>());
+        windows.push_back(std::make_unique<Bismuth::Window>(PlasmaApi::ClientHandle(fakeClients.back().get()), workspace));
+    }
+
+    auto surface1 = Bismuth::Surface(1, 0, QStringLiteral("abc"));
+    auto surface2 = Bismuth::Surface(2, 0, QStringLiteral("abc"));
+
+    auto history = Bismuth::FocusHistory();
+    CHECK(history.lastFocused(surface1) == nullptr);
+
+    history.touch(*windows[0], {surface1});
+    history.touch(*windows[1], {surface1});
+    history.touch(*windows[2], {surface1, surface2});
+
+    SUBCASE("Windows are ordered from the most recently focused one")
+    {
+        CHECK(history.lastFocused(surface1) == windows[2].get());
+        CHECK(history.previous(surface1, *windows[2]) == windows[1].get());
+        CHECK(history.previous(surface1, *windows[1]) == windows[0].get());
+        CHECK(history.previous(surface1, *windows[0]) == nullptr);
+
+        CHECK(history.lastFocused(surface2) == windows[2].get());
+        CHECK(history.previous(surface2, *windows[2]) == nullptr);
+
+        CHECK(history.lastUse(*windows[2]) > history.lastUse(*windows[1]));
+        CHECK(history.lastUse(*windows[1]) > history.lastUse(*windows[0]));
+    }
+
+    SUBCASE("Focusing again moves the window to the front")
+    {
+        history.touch(*windows[0], {surface1});
+
+        CHECK(history.lastFocused(surface1) == windows[0].get());
+        CHECK(history.previous(surface1, *windows[0]) == windows[2].get());
+        CHECK(history.previous(surface1, *windows[1]) == nullptr);
+    }
+
+    SUBCASE("Window leaves the surfaces, it is not on anymore")
+    {
+        history.touch(*windows[2], {surface2});
+
+        CHECK(history.lastFocused(surface1) == windows[1].get());
+        CHECK(history.previous(surface1, *windows[2]) == nullptr);
+        CHECK(history.lastFocused(surface2) == windows[2].get());
+    }
+
+    SUBCASE("Removed window is forgotten")
+    {
+        history.remove(*windows[2]);
+
+        CHECK(history.lastFocused(surface1) == windows[1].get());
+        CHECK(history.lastFocused(surface2) == nullptr);
+        CHECK(history.lastUse(*windows[2]) == 0);
+    }
+}
+
+TEST_CASE("Engine Focus History")
+{
+    auto qmlEngine = QQmlEngine();
+    auto fakeKWinWorkspace = FakeKWinWorkspace();
+    fakeKWinWorkspace.m_currentDesktop = 1;
+    fakeKWinWorkspace.m_currentActivity = QStringLiteral("abc");
+    fakeKWinWorkspace.m_numScreens = 1;
+    qmlEngine.rootContext()->setContextProperty(QStringLiteral("workspace"), &fakeKWinWorkspace);
+
+    auto config = FakeConfig();
+    auto plasmaApi = PlasmaApi::Api(&qmlEngine);
+    auto engine = Bismuth::Engine(plasmaApi, config);
+
+    // The same as the controller does with the experimental backend
+    QObject::connect(&plasmaApi.workspace(), &PlasmaApi::Workspace::clientActivated, [&](PlasmaApi::ClientHandle client) {
+        engine.windowActivated(client);
+    });
+
+    auto clients = std::vector<std::unique_ptr<FakeKWinClient>>();
+    for (auto i = 0; i < 3; i++) {
+        auto client = std::make_unique<FakeKWinClient>();
+        client->m_desktop = 1;
+        client->m_activities = QStringList(QStringLiteral("abc"));
+        engine.addWindow(PlasmaApi::ClientHandle(client.get()));
+        clients.push_back(std::move(client));
+    }
+    QCoreApplication::processEvents();
+
+    auto activeClient = [&]() {
+        return fakeKWinWorkspace.property("activeClient").value<QObject *>();
+    };
+
+    // The window had the focus, but nothing has it now, e.g. the desktop was shown
+    Q_EMIT fakeKWinWorkspace.clientActivated(reinterpret_cast<KWin::AbstractClient *>(clients[1].get()));
+    Q_EMIT fakeKWinWorkspace.clientActivated(nullptr);
+
+    SUBCASE("Focus order starts from the last focused window")
+    {
+        engine.focusWindowByOrder(Bismuth::Engine::FocusOrder::Next);
+        CHECK(activeClient() == clients[2].get());
+    }
+
+    SUBCASE("Removed window is not focused")
+    {
+        engine.removeWindow(PlasmaApi::ClientHandle(clients[1].get()));
+
+        engine.focusWindowByOrder(Bismuth::Engine::FocusOrder::Next);
+        CHECK(activeClient() == clients[2].get());
+    }
+}
@@ -0,0 +1,164 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include <doctest/doctest.h>
+
+#include <QString>
+#include <QStringList>
+#include <QTemporaryDir>
+
+#include "config.mock.hpp"
+#include "engine/layout/layout_list.hpp"
+#include "engine/layout/spiral.hpp"
+#include "engine/layout/tile.hpp"
+#include "engine/surface.hpp"
+#include "state/layout_state.hpp"
+#include "state/state_store.hpp"
+
+TEST_CASE("Layout List")
+{
+    auto config = FakeConfig();
+    auto layoutList = Bismuth::LayoutList(config);
+
+    auto surface1 = Bismuth::Surface(1, 0, QStringLiteral("abc"));
+    auto surface2 = Bismuth::Surface(1, 1, QStringLiteral("abc"));
+
+    SUBCASE("The first enabled layout is the default one")
+    {
+        CHECK(layoutList.layoutOnSurface(surface1).id() == QStringLiteral("TileLayout"));
+
+        config.setEnableTileLayout(false);
+        CHECK(layoutList.layoutOnSurface(surface2).id() == QStringLiteral("MonocleLayout"));
+    }
+
+    SUBCASE("Layouts are cycled in the order of the TS backend")
+    {
+        config.setEnableQuarterLayout(true);
+        CHECK(layoutList.layoutOrder()
+              == QStringList({QStringLiteral("TileLayout"),
+                              QStringLiteral("MonocleLayout"),
+                              QStringLiteral("ThreeColumnLayout"),
+                              QStringLiteral("SpiralLayout"),
+                              QStringLiteral("QuarterLayout")}));
+
+        CHECK(layoutList.cycleLayout(surface1, 1).id() == QStringLiteral("MonocleLayout"));
+        CHECK(layoutList.cycleLayout(surface1, 1).id() == QStringLiteral("ThreeColumnLayout"));
+        CHECK(layoutList.cycleLayout(surface1, -1).id() == QStringLiteral("MonocleLayout"));
+        CHECK(layoutList.cycleLayout(surface1, -2).id() == QStringLiteral("QuarterLayout"));
+
+        // Other surfaces are not affected
+        CHECK(layoutList.layoutOnSurface(surface2).id() == QStringLiteral("TileLayout"));
+    }
+
+    SUBCASE("Disabled layouts are skipped")
+    {
+        config.setEnableMonocleLayout(false);
+        CHECK(layoutList.cycleLayout(surface1, 1).id() == QStringLiteral("ThreeColumnLayout"));
+    }
+
+    SUBCASE("Toggling returns to the previous layout")
+    {
+        layoutList.cycleLayout(surface1, 1);
+        layoutList.cycleLayout(surface1, 1);
+
+        CHECK(layoutList.toggleLayout(surface1, QStringLiteral("QuarterLayout")).id() == QStringLiteral("QuarterLayout"));
+        CHECK(layoutList.toggleLayout(surface1, QStringLiteral("QuarterLayout")).id() == QStringLiteral("ThreeColumnLayout"));
+
+        // Not there yet
+        CHECK(layoutList.toggleLayout(surface1, QStringLiteral("FloatingLayout")).id() == QStringLiteral("ThreeColumnLayout"));
+    }
+
+    SUBCASE("Cycling after the layout, that is not in the order, starts over")
+    {
+        layoutList.cycleLayout(surface1, 1);
+        layoutList.toggleLayout(surface1, QStringLiteral("QuarterLayout"));
+
+        CHECK(layoutList.cycleLayout(surface1, 1).id() == QStringLiteral("TileLayout"));
+    }
+
+    SUBCASE("Layouts keep their parameters, while other ones are current")
+    {
+        auto &tileLayout = dynamic_cast<Bismuth::Tile &>(layoutList.layoutOnSurface(surface1));
+        tileLayout.setMasterCount(3);
+
+        layoutList.cycleLayout(surface1, 1);
+        layoutList.cycleLayout(surface1, -1);
+
+        CHECK(&layoutList.layoutOnSurface(surface1) == &tileLayout);
+        CHECK(tileLayout.masterCount() == 3);
+    }
+
+    SUBCASE("Layout state is saved and restored")
+    {
+        auto &tileLayout = dynamic_cast<Bismuth::Tile &>(layoutList.layoutOnSurface(surface1));
+        tileLayout.setRotation(90);
+        tileLayout.setMasterRatio(0.7);
+
+        auto state = layoutList.layoutState(surface1);
+        CHECK(state.classId == QStringLiteral("TileLayout"));
+        CHECK(state.rotation == 90);
+        CHECK(state.masterRatio == 0.7);
+
+        state.classId = QStringLiteral("SpiralLayout");
+        state.rotation = 180;
+
+        auto restoredList = Bismuth::LayoutList(config);
+        restoredList.restoreLayoutState(surface1, state);
+
+        auto &spiralLayout = dynamic_cast<Bismuth::Spiral &>(restoredList.layoutOnSurface(surface1));
+        CHECK(spiralLayout.rotation() == 180);
+
+        // The layouts created later get the parameters too
+        auto &restoredTile = dynamic_cast<Bismuth::Tile &>(restoredList.toggleLayout(surface1, QStringLiteral("TileLayout")));
+        CHECK(restoredTile.masterRatio() == 0.7);
+    }
+}
+
+TEST_CASE("Layout List State Store")
+{
+    auto tmpDir = QTemporaryDir();
+    auto store = Bismuth::StateStore(tmpDir.path());
+
+    auto config = FakeConfig();
+    auto layoutList = Bismuth::LayoutList(config);
+    layoutList.setStateStore(&store);
+
+    auto surface1 = Bismuth::Surface(1, 0, QStringLiteral("abc"));
+    auto surface2 = Bismuth::Surface(1, 1, QStringLiteral("abc"));
+
+    SUBCASE("Switched layouts are restored on startup")
+    {
+        layoutList.cycleLayout(surface1, 1);
+        layoutList.toggleLayout(surface2, QStringLiteral("SpiralLayout"));
+
+        auto restoredList = Bismuth::LayoutList(config);
+        restoredList.setStateStore(&store);
+
+        CHECK(restoredList.layoutOnSurface(surface1).id() == QStringLiteral("MonocleLayout"));
+        CHECK(restoredList.layoutOnSurface(surface2).id() == QStringLiteral("SpiralLayout"));
+    }
+
+    SUBCASE("Changed parameters are saved on request")
+    {
+        auto &tileLayout = dynamic_cast<Bismuth::Tile &>(layoutList.layoutOnSurface(surface1));
+        tileLayout.setMasterRatio(0.7);
+        layoutList.saveLayoutState(surface1);
+
+        auto restoredList = Bismuth::LayoutList(config);
+        restoredList.setStateStore(&store);
+
+        auto &restoredTile = dynamic_cast<Bismuth::Tile &>(restoredList.layoutOnSurface(surface1));
+        CHECK(restoredTile.masterRatio() == 0.7);
+    }
+
+    SUBCASE("Surfaces, that were used before the store was set, are restored too")
+    {
+        layoutList.cycleLayout(surface1, 1);
+
+        auto restoredList = Bismuth::LayoutList(config);
+        CHECK(restoredList.layoutOnSurface(surface1).id() == QStringLiteral("TileLayout"));
+
+        restoredList.setStateStore(&store);
+        CHECK(restoredList.layoutOnSurface(surface1).id() == QStringLiteral("MonocleLayout"));
+    }
+}
@@ -0,0 +1,74 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include <doctest/doctest.h>
+
+#include <QRect>
+
+#include <vector>
+
+#include "engine/layout/layout_parts.hpp"
+#include "engine/layout/layout_utils.hpp"
+
+using namespace Bismuth::LayoutParts;
+
+TEST_CASE("Layout Parts")
+{
+    auto area = QRect(0, 0, 1000, 600);
+
+    SUBCASE("Fill")
+    {
+        auto out = std::vector<QRect>(2);
+        Fill().apply(area, {}, out);
+
+        CHECK(out == std::vector<QRect>({area, area}));
+    }
+
+    SUBCASE("Weighted stack")
+    {
+        auto weights = std::vector<double>({1.0, 2.0});
+        auto out = std::vector<QRect>(2);
+        Stack().apply(area, weights, out);
+
+        CHECK(out == std::vector<QRect>({QRect(0, 0, 1000, 200), QRect(0, 200, 1000, 400)}));
+    }
+
+    SUBCASE("Composition")
+    {
+        auto parts = HalfSplit<Fill, Rotate<Stack>>();
+        parts.secondary.angle = 90;
+
+        auto out = std::vector<QRect>(3);
+        parts.apply(area, {}, out);
+
+        // The stack on the right is rotated, so the windows are side by side
+        CHECK(out == std::vector<QRect>({QRect(0, 0, 500, 600), QRect(500, 0, 250, 600), QRect(750, 0, 250, 600)}));
+    }
+
+    SUBCASE("Resizing a stacked window")
+    {
+        auto parts = HalfSplit<Stack, Stack>();
+        auto weights = std::vector<double>(3, 1.0);
+
+        // Grow the second window of the stack downwards
+        auto delta = parts.adjust(area, weights, 1, Bismuth::RectDelta{0, 0, 100, 0});
+
+        CHECK(weights[1] > weights[2]);
+        CHECK(weights[1] + weights[2] == doctest::Approx(2.0));
+        CHECK(parts.ratio == 0.5);
+
+        // The stack is on the right, so there is nothing to the east
+        CHECK(delta == Bismuth::RectDelta{0, 0, 0, 0});
+    }
+
+    SUBCASE("Resizing the split")
+    {
+        auto parts = HalfSplit<Stack, Stack>();
+        auto weights = std::vector<double>(2, 1.0);
+
+        // Grow the primary window to the east
+        parts.adjust(area, weights, 0, Bismuth::RectDelta{100, 0, 0, 0});
+
+        CHECK(parts.ratio == doctest::Approx(0.6));
+    }
+}
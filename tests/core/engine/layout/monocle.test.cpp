@@ -7,7 +7,7 @@
 #include "engine/layout/monocle.hpp"
 #include "engine/window.hpp"
 
-#include "plasma-api/client.hpp"
+#include "plasma-api/client_handle.hpp"
 #include "plasma-api/client.mock.hpp"
 #include "plasma-api/workspace.hpp"
 #include "plasma-api/workspace.mock.hpp"
@@ -27,14 +27,13 @@ TEST_CASE("Monocle Tiling Logic")
     fakeClient1.m_frameGeometry = QRect(18, 24, 79, 10);
 
     auto tilingArea = QRect(0, 0, 1000, 1000);
-    auto windowsToTile = std::vector<Bismuth::Window>({
-        Bismuth::Window(PlasmaApi::Client(&fakeClient1), workspace),
-        Bismuth::Window(PlasmaApi::Client(&fakeClient2), workspace),
-    });
+    auto window1 = Bismuth::Window(PlasmaApi::ClientHandle(&fakeClient1), workspace);
+    auto window2 = Bismuth::Window(PlasmaApi::ClientHandle(&fakeClient2), workspace);
+    auto windowsToTile = std::vector<Bismuth::Window *>({&window1, &window2});
 
     monocleLayout.apply(tilingArea, windowsToTile);
 
-    for (auto &window : windowsToTile) {
-        CHECK(window.geometry() == tilingArea);
+    for (auto window : windowsToTile) {
+        CHECK(window->geometry() == tilingArea);
     }
 }
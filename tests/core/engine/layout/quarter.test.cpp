@@ -0,0 +1,142 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include <doctest/doctest.h>
+
+#include <QRect>
+
+#include <memory>
+#include <vector>
+
+#include "config.mock.hpp"
+#include "engine/layout/quarter.hpp"
+#include "engine/window.hpp"
+
+#include "plasma-api/client.mock.hpp"
+#include "plasma-api/client_handle.hpp"
+#include "plasma-api/workspace.hpp"
+#include "plasma-api/workspace.mock.hpp"
+
+#include "ts_layouts.hpp"
+
+TEST_CASE("Quarter Layout")
+{
+    auto config = FakeConfig();
+    config.setTileLayoutGap(0);
+    auto quarterLayout = Bismuth::Quarter(config);
+
+    auto area = QRect(0, 0, 1000, 600);
+
+    SUBCASE("Two windows are side by side")
+    {
+        auto expected = std::vector<QRect>({QRect(0, 0, 500, 600), QRect(500, 0, 500, 600)});
+        CHECK(quarterLayout.geometries(area, 2) == expected);
+    }
+
+    SUBCASE("Four windows go clockwise")
+    {
+        auto expected = std::vector<QRect>({QRect(0, 0, 500, 300), QRect(500, 0, 500, 300), QRect(500, 300, 500, 300), QRect(0, 300, 500, 300)});
+        CHECK(quarterLayout.geometries(area, 4) == expected);
+    }
+
+    SUBCASE("Gaps between the quarters")
+    {
+        config.setTileLayoutGap(10);
+
+        auto expected = std::vector<QRect>({QRect(0, 0, 495, 295), QRect(505, 0, 495, 295), QRect(505, 305, 495, 295), QRect(0, 305, 495, 295)});
+        CHECK(quarterLayout.geometries(area, 4) == expected);
+    }
+
+    SUBCASE("Resizing moves the borders within the limits")
+    {
+        auto weights = std::vector<double>(4, 1.0);
+        quarterLayout.adjust(area, weights, 0, Bismuth::RectDelta{100, 0, 60, 0});
+
+        CHECK(quarterLayout.verticalSplit() == doctest::Approx(0.6));
+        CHECK(quarterLayout.leftHorizontalSplit() == doctest::Approx(0.6));
+        CHECK(quarterLayout.rightHorizontalSplit() == 0.5);
+
+        quarterLayout.adjust(area, weights, 0, Bismuth::RectDelta{1000, 0, 0, 0});
+        CHECK(quarterLayout.verticalSplit() == Bismuth::Quarter::maxProportion);
+    }
+
+    SUBCASE("Windows after the fourth one float")
+    {
+        auto fakeKWinWorkspace = FakeKWinWorkspace();
+        auto workspace = PlasmaApi::Workspace(&fakeKWinWorkspace);
+
+        auto fakeClients = std::vector<std::unique_ptr<FakeKWinClient>>();
+        auto windows = std::vector<Bismuth::Window>();
+        for (auto i = 0; i < 5; i++) {
+            fakeClients.push_back(std::make_unique<FakeKWinClient>());
+            windows.emplace_back(PlasmaApi::ClientHandle(fakeClients.back().get()), workspace);
+        }
+
+        auto windowPointers = std::vector<Bismuth::Window *>();
+        for (auto &window : windows) {
+            windowPointers.push_back(&window);
+        }
+
+        quarterLayout.apply(area, windowPointers);
+
+        CHECK(quarterLayout.geometries(area, 5).size() == 4);
+        CHECK(fakeClients[3]->m_frameGeometry == QRect(0, 300, 500, 300));
+        CHECK(windows[3].mode() == Bismuth::Window::Mode::Tiled);
+        CHECK(windows[4].mode() == Bismuth::Window::Mode::Floating);
+    }
+}
+
+TEST_CASE("Quarter Layout Matches The TS Backend")
+{
+    auto config = FakeConfig();
+    auto quarterLayout = Bismuth::Quarter(config);
+    auto tsLayouts = TSLayouts();
+
+    for (auto area : {QRect(0, 0, 1920, 1080), QRect(1927, 37, 1365, 731)}) {
+        for (auto gap : {0, 7}) {
+            config.setTileLayoutGap(gap);
+            for (auto count = 0; count <= 6; count++) {
+                CAPTURE(area);
+                CAPTURE(gap);
+                CAPTURE(count);
+
+                CHECK(quarterLayout.geometries(area, count) == tsLayouts.quarter(area, count, gap));
+            }
+        }
+    }
+}
+
+TEST_CASE("Quarter Layout Resizing Matches The TS Backend")
+{
+    auto config = FakeConfig();
+    auto tsLayouts = TSLayouts();
+
+    auto deltas = std::vector<Bismuth::RectDelta>({
+        {30, 0, 0, 0},
+        {0, -45, 0, 0},
+        {0, 0, 25, 0},
+        {0, 0, 0, -60},
+        {100, 200, -30, 40},
+        {-5000, 0, 3000, 0},
+    });
+
+    auto area = QRect(1927, 37, 1365, 731);
+    for (auto gap : {0, 7}) {
+        config.setTileLayoutGap(gap);
+        for (auto count = 1; count <= 6; count++) {
+            for (auto basis = 0; basis < count; basis++) {
+                for (auto delta : deltas) {
+                    CAPTURE(gap);
+                    CAPTURE(count);
+                    CAPTURE(basis);
+
+                    auto quarterLayout = Bismuth::Quarter(config);
+                    auto weights = std::vector<double>(count, 1.0);
+                    quarterLayout.adjust(area, weights, basis, delta);
+
+                    CHECK(quarterLayout.geometries(area, count) == tsLayouts.quarter(area, count, gap, basis, delta));
+                }
+            }
+        }
+    }
+}
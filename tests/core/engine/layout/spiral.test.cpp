@@ -0,0 +1,127 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include <doctest/doctest.h>
+
+#include <QRect>
+
+#include <vector>
+
+#include "config.mock.hpp"
+#include "engine/layout/spiral.hpp"
+#include "state/layout_state.hpp"
+
+#include "ts_layouts.hpp"
+
+TEST_CASE("Spiral Layout")
+{
+    auto config = FakeConfig();
+    config.setTileLayoutGap(0);
+    auto spiralLayout = Bismuth::Spiral(config);
+
+    auto area = QRect(0, 0, 1000, 600);
+
+    SUBCASE("Windows go around")
+    {
+        auto expected = std::vector<QRect>({QRect(0, 0, 500, 600), QRect(500, 0, 500, 300), QRect(750, 300, 250, 300), QRect(500, 300, 250, 300)});
+        CHECK(spiralLayout.geometries(area, 4) == expected);
+    }
+
+    SUBCASE("Only the first split is rotated")
+    {
+        spiralLayout.setRotation(180);
+
+        auto expected = std::vector<QRect>({QRect(500, 0, 500, 600), QRect(0, 0, 500, 300), QRect(0, 300, 500, 300)});
+        CHECK(spiralLayout.geometries(area, 3) == expected);
+    }
+
+    SUBCASE("Resizing moves the split next to the window")
+    {
+        auto weights = std::vector<double>(3, 1.0);
+        spiralLayout.adjust(area, weights, 1, Bismuth::RectDelta{0, 0, 60, 0});
+
+        CHECK(spiralLayout.ratio(0) == 0.5);
+        CHECK(spiralLayout.ratio(1) == doctest::Approx(0.6));
+
+        auto expected = std::vector<QRect>({QRect(0, 0, 500, 600), QRect(500, 0, 500, 360), QRect(500, 360, 500, 240)});
+        CHECK(spiralLayout.geometries(area, 3) == expected);
+    }
+
+    SUBCASE("Rotation is kept")
+    {
+        spiralLayout.setRotation(270);
+
+        auto state = Bismuth::LayoutState();
+        spiralLayout.saveState(state);
+        CHECK(state.rotation == 270);
+
+        auto restoredLayout = Bismuth::Spiral(config);
+        restoredLayout.loadState(state);
+        CHECK(restoredLayout.rotation() == 270);
+    }
+}
+
+TEST_CASE("Spiral Layout Matches The TS Backend")
+{
+    auto config = FakeConfig();
+    auto spiralLayout = Bismuth::Spiral(config);
+    auto tsLayouts = TSLayouts();
+
+    for (auto area : {QRect(0, 0, 1920, 1080), QRect(1927, 37, 1365, 731)}) {
+        for (auto gap : {0, 7}) {
+            config.setTileLayoutGap(gap);
+            for (auto rotation : {0, 90, 180, 270}) {
+                spiralLayout.setRotation(rotation);
+                for (auto count = 0; count <= 9; count++) {
+                    CAPTURE(area);
+                    CAPTURE(gap);
+                    CAPTURE(rotation);
+                    CAPTURE(count);
+
+                    CHECK(spiralLayout.geometries(area, count) == tsLayouts.spiral(area, count, rotation, gap));
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("Spiral Layout Resizing Matches The TS Backend")
+{
+    auto config = FakeConfig();
+    auto tsLayouts = TSLayouts();
+
+    auto deltas = std::vector<Bismuth::RectDelta>({
+        {30, 0, 0, 0},
+        {0, -45, 0, 0},
+        {0, 0, 25, 0},
+        {0, 0, 0, -60},
+        {100, 200, -30, 40},
+        {-5000, 0, 3000, 0},
+    });
+
+    auto area = QRect(1927, 37, 1365, 731);
+    for (auto gap : {0, 7}) {
+        config.setTileLayoutGap(gap);
+        for (auto rotation : {0, 90, 180, 270}) {
+            for (auto count = 1; count <= 6; count++) {
+                for (auto basis = 0; basis < count; basis++) {
+                    for (auto delta : deltas) {
+                        CAPTURE(gap);
+                        CAPTURE(rotation);
+                        CAPTURE(count);
+                        CAPTURE(basis);
+
+                        auto spiralLayout = Bismuth::Spiral(config);
+                        spiralLayout.setRotation(rotation);
+
+                        auto weights = std::vector<double>(count, 1.0);
+                        spiralLayout.adjust(area, weights, basis, delta);
+
+                        // The ratios are internal, so the geometries are compared
+                        CHECK(spiralLayout.geometries(area, count) == tsLayouts.spiral(area, count, rotation, gap, basis, delta));
+                    }
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,153 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include <doctest/doctest.h>
+
+#include <QRect>
+
+#include <vector>
+
+#include "config.mock.hpp"
+#include "engine/layout/three_column.hpp"
+
+#include "ts_layouts.hpp"
+
+TEST_CASE("Three Column Layout")
+{
+    auto config = FakeConfig();
+    config.setTileLayoutGap(0);
+    auto threeColumnLayout = Bismuth::ThreeColumn(config);
+
+    auto area = QRect(0, 0, 1000, 600);
+
+    SUBCASE("Single window takes the whole area")
+    {
+        CHECK(threeColumnLayout.geometries(area, 1) == std::vector<QRect>({area}));
+    }
+
+    SUBCASE("Two windows are master and stack")
+    {
+        auto expected = std::vector<QRect>({QRect(0, 0, 600, 600), QRect(600, 0, 400, 600)});
+        CHECK(threeColumnLayout.geometries(area, 2) == expected);
+    }
+
+    SUBCASE("Master in the middle, the rest on the sides")
+    {
+        auto expected = std::vector<QRect>({QRect(285, 0, 428, 600), QRect(714, 0, 285, 600), QRect(0, 0, 285, 300), QRect(0, 300, 285, 300)});
+        CHECK(threeColumnLayout.geometries(area, 4) == expected);
+    }
+
+    SUBCASE("Only masters")
+    {
+        threeColumnLayout.setMasterCount(2);
+
+        auto expected = std::vector<QRect>({QRect(0, 0, 1000, 300), QRect(0, 300, 1000, 300)});
+        CHECK(threeColumnLayout.geometries(area, 2) == expected);
+    }
+
+    SUBCASE("Gaps between the columns")
+    {
+        config.setTileLayoutGap(10);
+
+        auto expected = std::vector<QRect>({QRect(290, 0, 420, 600), QRect(720, 0, 280, 600), QRect(0, 0, 280, 600)});
+        CHECK(threeColumnLayout.geometries(area, 3) == expected);
+    }
+
+    SUBCASE("Master count is limited")
+    {
+        threeColumnLayout.setMasterCount(0);
+        CHECK(threeColumnLayout.masterCount() == 1);
+
+        threeColumnLayout.setMasterCount(11);
+        CHECK(threeColumnLayout.masterCount() == 10);
+    }
+
+    SUBCASE("Resizing the master widens the middle column")
+    {
+        auto weights = std::vector<double>(3, 1.0);
+        threeColumnLayout.adjust(area, weights, 0, Bismuth::RectDelta{50, 0, 0, 0});
+
+        CHECK(threeColumnLayout.masterRatio() > 0.6);
+    }
+}
+
+TEST_CASE("Three Column Layout Matches The TS Backend")
+{
+    auto config = FakeConfig();
+    auto threeColumnLayout = Bismuth::ThreeColumn(config);
+    auto tsLayouts = TSLayouts();
+
+    for (auto area : {QRect(0, 0, 1920, 1080), QRect(1927, 37, 1365, 731)}) {
+        for (auto gap : {0, 7}) {
+            config.setTileLayoutGap(gap);
+            for (auto masterRatio : {0.6, 0.35}) {
+                threeColumnLayout.setMasterRatio(masterRatio);
+                for (auto masterCount = 1; masterCount <= 3; masterCount++) {
+                    threeColumnLayout.setMasterCount(masterCount);
+                    for (auto count = 0; count <= 9; count++) {
+                        CAPTURE(area);
+                        CAPTURE(gap);
+                        CAPTURE(masterRatio);
+                        CAPTURE(masterCount);
+                        CAPTURE(count);
+
+                        auto weights = std::vector<double>(count, 1.0);
+                        if (count > 2) {
+                            weights[1] = 0.7;
+                            weights.back() = 1.5;
+                        }
+
+                        auto expected = tsLayouts.threeColumn(area, weights, masterCount, masterRatio, gap);
+                        auto tiles = std::vector<QRect>(count);
+                        threeColumnLayout.geometries(area, weights, tiles);
+                        CHECK(tiles == expected);
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("Three Column Layout Resizing Matches The TS Backend")
+{
+    auto config = FakeConfig();
+    auto tsLayouts = TSLayouts();
+
+    auto deltas = std::vector<Bismuth::RectDelta>({
+        {30, 0, 0, 0},
+        {0, -45, 0, 0},
+        {0, 0, 25, 0},
+        {0, 0, 0, -60},
+        {100, 200, -30, 40},
+        {-5000, 0, 3000, 0},
+    });
+
+    auto area = QRect(1927, 37, 1365, 731);
+    for (auto gap : {0, 7}) {
+        config.setTileLayoutGap(gap);
+        for (auto masterCount = 1; masterCount <= 2; masterCount++) {
+            for (auto count = 1; count <= 7; count++) {
+                for (auto basis = 0; basis < count; basis++) {
+                    for (auto delta : deltas) {
+                        CAPTURE(gap);
+                        CAPTURE(masterCount);
+                        CAPTURE(count);
+                        CAPTURE(basis);
+
+                        auto threeColumnLayout = Bismuth::ThreeColumn(config);
+                        threeColumnLayout.setMasterCount(masterCount);
+
+                        auto weights = std::vector<double>(count, 1.0);
+                        weights.back() = 1.5;
+
+                        auto expected = tsLayouts.threeColumnAdjust(area, weights, masterCount, 0.6, gap, basis, delta);
+                        threeColumnLayout.adjust(area, weights, basis, delta);
+
+                        CHECK(threeColumnLayout.masterRatio() == expected.masterRatio);
+                        CHECK(weights == expected.weights);
+                    }
+                }
+            }
+        }
+    }
+}
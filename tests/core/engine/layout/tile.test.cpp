@@ -0,0 +1,212 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include <doctest/doctest.h>
+
+#include <QElapsedTimer>
+#include <QRect>
+
+#include <vector>
+
+#include "config.mock.hpp"
+#include "engine/layout/tile.hpp"
+#include "engine/window.hpp"
+
+#include "plasma-api/client.mock.hpp"
+#include "plasma-api/client_handle.hpp"
+#include "plasma-api/workspace.hpp"
+#include "plasma-api/workspace.mock.hpp"
+
+#include "ts_layouts.hpp"
+
+TEST_CASE("Tile Layout")
+{
+    auto config = FakeConfig();
+    config.setTileLayoutGap(0);
+    auto tileLayout = Bismuth::Tile(config);
+
+    auto area = QRect(0, 0, 1000, 600);
+
+    SUBCASE("Single window takes the whole area")
+    {
+        CHECK(tileLayout.geometries(area, 1) == std::vector<QRect>({area}));
+    }
+
+    SUBCASE("Master on the left, stack on the right")
+    {
+        auto expected = std::vector<QRect>({QRect(0, 0, 500, 600), QRect(500, 0, 500, 300), QRect(500, 300, 500, 300)});
+        CHECK(tileLayout.geometries(area, 3) == expected);
+    }
+
+    SUBCASE("Master on the right")
+    {
+        tileLayout.setRotation(180);
+        tileLayout.setMasterRatio(0.6);
+
+        auto expected = std::vector<QRect>({QRect(400, 0, 600, 600), QRect(0, 0, 400, 600)});
+        CHECK(tileLayout.geometries(area, 2) == expected);
+    }
+
+    SUBCASE("Master on the top")
+    {
+        tileLayout.setRotation(90);
+
+        auto expected = std::vector<QRect>({QRect(0, 0, 1000, 300), QRect(0, 300, 500, 300), QRect(500, 300, 500, 300)});
+        CHECK(tileLayout.geometries(area, 3) == expected);
+    }
+
+    SUBCASE("Gaps between the tiles")
+    {
+        config.setTileLayoutGap(10);
+
+        auto expected = std::vector<QRect>({QRect(0, 0, 495, 600), QRect(505, 0, 495, 295), QRect(505, 305, 495, 295)});
+        CHECK(tileLayout.geometries(area, 3) == expected);
+    }
+
+    SUBCASE("Rotation is normalized")
+    {
+        tileLayout.setRotation(-90);
+        CHECK(tileLayout.rotation() == 270);
+
+        tileLayout.setRotation(450);
+        CHECK(tileLayout.rotation() == 90);
+    }
+
+    SUBCASE("Windows are placed")
+    {
+        auto fakeKWinWorkspace = FakeKWinWorkspace();
+        auto workspace = PlasmaApi::Workspace(&fakeKWinWorkspace);
+
+        auto fakeClient1 = FakeKWinClient();
+        auto fakeClient2 = FakeKWinClient();
+        auto window1 = Bismuth::Window(PlasmaApi::ClientHandle(&fakeClient1), workspace);
+        auto window2 = Bismuth::Window(PlasmaApi::ClientHandle(&fakeClient2), workspace);
+
+        tileLayout.apply(area, std::vector<Bismuth::Window *>({&window1, &window2}));
+
+        CHECK(fakeClient1.m_frameGeometry == QRect(0, 0, 500, 600));
+        CHECK(fakeClient2.m_frameGeometry == QRect(500, 0, 500, 600));
+        CHECK(window1.mode() == Bismuth::Window::Mode::Tiled);
+    }
+}
+
+TEST_CASE("Tile Layout Matches The TS Backend")
+{
+    auto config = FakeConfig();
+    auto tileLayout = Bismuth::Tile(config);
+    auto tsLayouts = TSLayouts();
+
+    for (auto area : {QRect(0, 0, 1920, 1080), QRect(1927, 37, 1365, 731)}) {
+        for (auto gap : {0, 7}) {
+            config.setTileLayoutGap(gap);
+            for (auto rotation : {0, 90, 180, 270}) {
+                tileLayout.setRotation(rotation);
+                for (auto masterRatio : {0.5, 0.35, 0.73}) {
+                    tileLayout.setMasterRatio(masterRatio);
+                    for (auto masterCount = 0; masterCount <= 3; masterCount++) {
+                        tileLayout.setMasterCount(masterCount);
+                        for (auto count = 0; count <= 9; count++) {
+                            CAPTURE(area);
+                            CAPTURE(gap);
+                            CAPTURE(rotation);
+                            CAPTURE(masterRatio);
+                            CAPTURE(masterCount);
+                            CAPTURE(count);
+
+                            auto expected = tsLayouts.tile(area, std::vector<double>(count, 1.0), masterCount, masterRatio, rotation, gap);
+                            CHECK(tileLayout.geometries(area, count) == expected);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("Tile Layout Resizing Matches The TS Backend")
+{
+    auto config = FakeConfig();
+    auto tsLayouts = TSLayouts();
+
+    auto deltas = std::vector<Bismuth::RectDelta>({
+        {30, 0, 0, 0},
+        {0, -45, 0, 0},
+        {0, 0, 25, 0},
+        {0, 0, 0, -60},
+        {100, 200, -30, 40},
+        {-5000, 0, 3000, 0},
+    });
+
+    auto area = QRect(1927, 37, 1365, 731);
+    for (auto gap : {0, 7}) {
+        config.setTileLayoutGap(gap);
+        for (auto rotation : {0, 90, 180, 270}) {
+            for (auto masterCount = 0; masterCount <= 2; masterCount++) {
+                for (auto count = 1; count <= 4; count++) {
+                    for (auto basis = 0; basis < count; basis++) {
+                        for (auto delta : deltas) {
+                            CAPTURE(gap);
+                            CAPTURE(rotation);
+                            CAPTURE(masterCount);
+                            CAPTURE(count);
+                            CAPTURE(basis);
+
+                            auto tileLayout = Bismuth::Tile(config);
+                            tileLayout.setRotation(rotation);
+                            tileLayout.setMasterCount(masterCount);
+                            tileLayout.setMasterRatio(0.35);
+
+                            auto weights = std::vector<double>(count, 1.0);
+                            weights.back() = 1.5;
+
+                            auto expected = tsLayouts.tileAdjust(area, weights, masterCount, 0.35, rotation, gap, basis, delta);
+                            tileLayout.adjust(area, weights, basis, delta);
+
+                            // The same arithmetic is done in the same order, so the results are exactly the same
+                            CHECK(tileLayout.masterRatio() == expected.masterRatio);
+                            CHECK(weights == expected.weights);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("Tile Layout Benchmark" * doctest::test_suite("benchmark") * doctest::skip())
+{
+    constexpr auto iterations = 1000;
+    constexpr auto numWindows = 20;
+
+    auto config = FakeConfig();
+    config.setTileLayoutGap(8);
+    auto tileLayout = Bismuth::Tile(config);
+    tileLayout.setMasterCount(2);
+    auto tsLayouts = TSLayouts();
+
+    auto area = QRect(0, 0, 1920, 1080);
+    auto weights = std::vector<double>(numWindows, 1.0);
+    auto tiles = std::vector<QRect>(numWindows);
+
+    auto tsTimer = QElapsedTimer();
+    tsTimer.start();
+    auto tsCount = std::size_t(0);
+    for (auto i = 0; i < iterations; i++) {
+        tsCount += tsLayouts.tile(area, weights, 2, 0.5, 0, 8).size();
+    }
+    auto tsNs = tsTimer.nsecsElapsed();
+
+    auto nativeTimer = QElapsedTimer();
+    nativeTimer.start();
+    auto nativeCount = std::size_t(0);
+    for (auto i = 0; i < iterations; i++) {
+        tileLayout.geometries(area, weights, tiles);
+        nativeCount += tiles.size();
+    }
+    auto nativeNs = nativeTimer.nsecsElapsed();
+
+    CHECK(tsCount == nativeCount);
+
+    MESSAGE("Time per layout of " << numWindows << " windows, TS backend: " << tsNs / iterations / 1000 << " us");
+    MESSAGE("Time per layout of " << numWindows << " windows, native: " << nativeNs / iterations << " ns");
+}
@@ -0,0 +1,126 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include "ts_layouts.hpp"
+
+#include <QDebug>
+#include <QString>
+
+TSLayouts::TSLayouts()
+    : m_engine()
+{
+    auto bundle = m_engine.importModule(QStringLiteral(TS_LAYOUTS_BUNDLE));
+    if (bundle.isError()) {
+        qWarning() << "Failed to load the bundle of the TS layouts:" << bundle.toString();
+    }
+
+    m_tile = bundle.property(QStringLiteral("tileLayout"));
+    m_tileAdjust = bundle.property(QStringLiteral("tileAdjust"));
+    m_threeColumn = bundle.property(QStringLiteral("threeColumnLayout"));
+    m_threeColumnAdjust = bundle.property(QStringLiteral("threeColumnAdjust"));
+    m_spiral = bundle.property(QStringLiteral("spiralLayout"));
+    m_quarter = bundle.property(QStringLiteral("quarterLayout"));
+}
+
+std::vector<QRect> TSLayouts::tile(QRect area, const std::vector<double> &weights, int masterCount, double masterRatio, int rotation, int gap)
+{
+    auto jsResult = m_tile.call({toJS(area), toJS(weights), masterCount, masterRatio, rotation, gap});
+    return rectsFromJS(jsResult);
+}
+
+TSLayouts::Adjustment
+TSLayouts::tileAdjust(QRect area, const std::vector<double> &weights, int masterCount, double masterRatio, int rotation, int gap, int basis, Bismuth::RectDelta delta)
+{
+    auto jsResult = m_tileAdjust.call({toJS(area), toJS(weights), masterCount, masterRatio, rotation, gap, basis, toJS(delta)});
+    return adjustmentFromJS(jsResult);
+}
+
+std::vector<QRect> TSLayouts::threeColumn(QRect area, const std::vector<double> &weights, int masterCount, double masterRatio, int gap)
+{
+    auto jsResult = m_threeColumn.call({toJS(area), toJS(weights), masterCount, masterRatio, gap});
+    return rectsFromJS(jsResult);
+}
+
+TSLayouts::Adjustment TSLayouts::threeColumnAdjust(QRect area,
+                                                   const std::vector<double> &weights,
+                                                   int masterCount,
+                                                   double masterRatio,
+                                                   int gap,
+                                                   int basis,
+                                                   Bismuth::RectDelta delta)
+{
+    auto jsResult = m_threeColumnAdjust.call({toJS(area), toJS(weights), masterCount, masterRatio, gap, basis, toJS(delta)});
+    return adjustmentFromJS(jsResult);
+}
+
+std::vector<QRect> TSLayouts::spiral(QRect area, int count, int rotation, int gap, int basis, Bismuth::RectDelta delta)
+{
+    auto jsResult = m_spiral.call({toJS(area), count, rotation, gap, basis, toJS(delta)});
+    return rectsFromJS(jsResult);
+}
+
+std::vector<QRect> TSLayouts::quarter(QRect area, int count, int gap, int basis, Bismuth::RectDelta delta)
+{
+    auto jsResult = m_quarter.call({toJS(area), count, gap, basis, toJS(delta)});
+    return rectsFromJS(jsResult);
+}
+
+QJSValue TSLayouts::toJS(QRect rect)
+{
+    auto result = m_engine.newObject();
+    result.setProperty(QStringLiteral("x"), rect.x());
+    result.setProperty(QStringLiteral("y"), rect.y());
+    result.setProperty(QStringLiteral("width"), rect.width());
+    result.setProperty(QStringLiteral("height"), rect.height());
+    return result;
+}
+
+QJSValue TSLayouts::toJS(const std::vector<double> &values)
+{
+    auto result = m_engine.newArray(values.size());
+    for (auto i = std::size_t(0); i < values.size(); i++) {
+        result.setProperty(static_cast<quint32>(i), values[i]);
+    }
+    return result;
+}
+
+QJSValue TSLayouts::toJS(Bismuth::RectDelta delta)
+{
+    auto result = m_engine.newObject();
+    result.setProperty(QStringLiteral("east"), delta.east);
+    result.setProperty(QStringLiteral("west"), delta.west);
+    result.setProperty(QStringLiteral("south"), delta.south);
+    result.setProperty(QStringLiteral("north"), delta.north);
+    return result;
+}
+
+std::vector<QRect> TSLayouts::rectsFromJS(const QJSValue &array)
+{
+    auto length = array.property(QStringLiteral("length")).toInt();
+    auto result = std::vector<QRect>();
+    result.reserve(length);
+
+    for (auto i = 0; i < length; i++) {
+        auto rect = array.property(i);
+        result.push_back(QRect(rect.property(QStringLiteral("x")).toInt(),
+                               rect.property(QStringLiteral("y")).toInt(),
+                               rect.property(QStringLiteral("width")).toInt(),
+                               rect.property(QStringLiteral("height")).toInt()));
+    }
+
+    return result;
+}
+
+TSLayouts::Adjustment TSLayouts::adjustmentFromJS(const QJSValue &object)
+{
+    auto result = Adjustment();
+    result.masterRatio = object.property(QStringLiteral("masterRatio")).toNumber();
+
+    auto jsWeights = object.property(QStringLiteral("weights"));
+    auto length = jsWeights.property(QStringLiteral("length")).toInt();
+    for (auto i = 0; i < length; i++) {
+        result.weights.push_back(jsWeights.property(i).toNumber());
+    }
+
+    return result;
+}
@@ -0,0 +1,83 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <QJSEngine>
+#include <QJSValue>
+#include <QRect>
+
+#include <vector>
+
+#include "engine/layout/layout_utils.hpp"
+
+/**
+ * Layouts of the TS backend, running in a JS engine the same way they do in
+ * KWin. They are loaded from the bundle, that is built from the TS sources
+ * with ts_layouts.ts as the entry point, so that the native layouts can be
+ * checked and benchmarked against them.
+ */
+class TSLayouts
+{
+public:
+    struct Adjustment {
+        double masterRatio{};
+        std::vector<double> weights{};
+    };
+
+    TSLayouts();
+
+    /**
+     * Geometries produced by the TileLayout for the windows with the @p weights
+     */
+    std::vector<QRect> tile(QRect area, const std::vector<double> &weights, int masterCount, double masterRatio, int rotation, int gap);
+
+    /**
+     * State of the TileLayout and the window weights after the @p basis window is resized by the @p delta
+     */
+    Adjustment
+    tileAdjust(QRect area, const std::vector<double> &weights, int masterCount, double masterRatio, int rotation, int gap, int basis, Bismuth::RectDelta delta);
+
+    /**
+     * Geometries produced by the ThreeColumnLayout for the windows with the @p weights
+     */
+    std::vector<QRect> threeColumn(QRect area, const std::vector<double> &weights, int masterCount, double masterRatio, int gap);
+
+    /**
+     * State of the ThreeColumnLayout and the window weights after the @p basis window is resized by the @p delta
+     */
+    Adjustment threeColumnAdjust(QRect area,
+                                 const std::vector<double> &weights,
+                                 int masterCount,
+                                 double masterRatio,
+                                 int gap,
+                                 int basis,
+                                 Bismuth::RectDelta delta);
+
+    /**
+     * Geometries produced by the SpiralLayout for the @p count windows, after
+     * the @p basis window, if any, is resized by the @p delta
+     */
+    std::vector<QRect> spiral(QRect area, int count, int rotation, int gap, int basis = -1, Bismuth::RectDelta delta = {});
+
+    /**
+     * Geometries of the tiled windows produced by the QuarterLayout for the
+     * @p count windows, after the @p basis window, if any, is resized by the @p delta
+     */
+    std::vector<QRect> quarter(QRect area, int count, int gap, int basis = -1, Bismuth::RectDelta delta = {});
+
+private:
+    QJSValue toJS(QRect);
+    QJSValue toJS(const std::vector<double> &);
+    QJSValue toJS(Bismuth::RectDelta);
+    std::vector<QRect> rectsFromJS(const QJSValue &);
+    Adjustment adjustmentFromJS(const QJSValue &);
+
+    QJSEngine m_engine;
+    QJSValue m_tile;
+    QJSValue m_tileAdjust;
+    QJSValue m_threeColumn;
+    QJSValue m_threeColumnAdjust;
+    QJSValue m_spiral;
+    QJSValue m_quarter;
+};
@@ -0,0 +1,223 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+//
+// SPDX-License-Identifier: MIT
+
+/**
+ * Entry point of the bundle, that runs the layouts of the TS backend in the
+ * tests of the native layouts. It is bundled from the same sources as the
+ * KWin script, so the native layouts are checked against the real ones.
+ */
+
+import QuarterLayout from "../../../../src/kwinscript/engine/layout/quarter_layout";
+import SpiralLayout from "../../../../src/kwinscript/engine/layout/spiral_layout";
+import ThreeColumnLayout from "../../../../src/kwinscript/engine/layout/three_column_layout";
+import TileLayout from "../../../../src/kwinscript/engine/layout/tile_layout";
+import {
+  LayoutState,
+  WindowsLayout,
+} from "../../../../src/kwinscript/engine/layout";
+import {
+  EngineWindow,
+  WindowState,
+} from "../../../../src/kwinscript/engine/window";
+
+import { Config } from "../../../../src/kwinscript/config";
+import { Controller } from "../../../../src/kwinscript/controller";
+import { TSProxy } from "../../../../src/kwinscript/extern/proxy";
+import { Rect, RectDelta } from "../../../../src/kwinscript/util/rect";
+
+interface PlainRect {
+  x: number;
+  y: number;
+  width: number;
+  height: number;
+}
+
+interface PlainDelta {
+  east: number;
+  west: number;
+  south: number;
+  north: number;
+}
+
+interface Adjustment {
+  masterRatio: number;
+  weights: number[];
+}
+
+const surfaceId = "0:1";
+
+function config(gap: number): Config {
+  return { tileLayoutGap: gap } as Config;
+}
+
+/**
+ * Proxy, that only keeps the layout state in memory
+ */
+function proxy(
+  rotation: number,
+  masterCount: number,
+  masterRatio: number
+): TSProxy {
+  const state = {
+    classID: "",
+    rotation: rotation,
+    numMasterTiles: masterCount,
+    masterRatio: masterRatio,
+  } as LayoutState;
+
+  return { layoutState: () => state } as unknown as TSProxy;
+}
+
+function tiles(weights: number[]): EngineWindow[] {
+  return weights.map((weight) => ({ weight: weight } as EngineWindow));
+}
+
+function rect(area: PlainRect): Rect {
+  return new Rect(area.x, area.y, area.width, area.height);
+}
+
+function rectDelta(delta: PlainDelta): RectDelta {
+  return new RectDelta(delta.east, delta.west, delta.south, delta.north);
+}
+
+/**
+ * Geometries of the tiled windows after the layout is applied, optionally
+ * after the basis window was resized by the delta
+ */
+function geometries(
+  layout: WindowsLayout,
+  area: PlainRect,
+  tileables: EngineWindow[],
+  basis: number,
+  delta: PlainDelta
+): Rect[] {
+  if (basis >= 0 && layout.adjust) {
+    layout.adjust(rect(area), tileables, tileables[basis], rectDelta(delta));
+  }
+
+  layout.apply(null as unknown as Controller, tileables, rect(area));
+
+  return tileables
+    .filter((tile) => tile.state === WindowState.Tiled)
+    .map((tile) => tile.geometry);
+}
+
+export function tileLayout(
+  area: PlainRect,
+  weights: number[],
+  masterCount: number,
+  masterRatio: number,
+  rotation: number,
+  gap: number
+): Rect[] {
+  const layout = new TileLayout(
+    config(gap),
+    proxy(rotation, masterCount, masterRatio),
+    surfaceId
+  );
+  return geometries(layout, area, tiles(weights), -1, {} as PlainDelta);
+}
+
+export function tileAdjust(
+  area: PlainRect,
+  weights: number[],
+  masterCount: number,
+  masterRatio: number,
+  rotation: number,
+  gap: number,
+  basis: number,
+  delta: PlainDelta
+): Adjustment {
+  const layout = new TileLayout(
+    config(gap),
+    proxy(rotation, masterCount, masterRatio),
+    surfaceId
+  );
+  const tileables = tiles(weights);
+  layout.adjust(rect(area), tileables, tileables[basis], rectDelta(delta));
+
+  return {
+    masterRatio: layout["masterRatio"],
+    weights: tileables.map((tile) => tile.weight),
+  };
+}
+
+function threeColumn(
+  masterCount: number,
+  masterRatio: number,
+  gap: number
+): ThreeColumnLayout {
+  const layout = new ThreeColumnLayout(config(gap));
+  layout["masterSize"] = masterCount;
+  layout["masterRatio"] = masterRatio;
+  return layout;
+}
+
+export function threeColumnLayout(
+  area: PlainRect,
+  weights: number[],
+  masterCount: number,
+  masterRatio: number,
+  gap: number
+): Rect[] {
+  const layout = threeColumn(masterCount, masterRatio, gap);
+  return geometries(layout, area, tiles(weights), -1, {} as PlainDelta);
+}
+
+export function threeColumnAdjust(
+  area: PlainRect,
+  weights: number[],
+  masterCount: number,
+  masterRatio: number,
+  gap: number,
+  basis: number,
+  delta: PlainDelta
+): Adjustment {
+  const layout = threeColumn(masterCount, masterRatio, gap);
+  const tileables = tiles(weights);
+  layout.adjust(rect(area), tileables, tileables[basis], rectDelta(delta));
+
+  return {
+    masterRatio: layout["masterRatio"],
+    weights: tileables.map((tile) => tile.weight),
+  };
+}
+
+export function spiralLayout(
+  area: PlainRect,
+  count: number,
+  rotation: number,
+  gap: number,
+  basis: number,
+  delta: PlainDelta
+): Rect[] {
+  const layout = new SpiralLayout(
+    config(gap),
+    proxy(rotation, 1, 0.5),
+    surfaceId
+  );
+  const tileables = tiles(new Array(count).fill(1));
+
+  // Adjusting needs the parts, that are created by applying
+  layout.apply(null as unknown as Controller, tileables, rect(area));
+
+  return geometries(layout, area, tileables, basis, delta);
+}
+
+export function quarterLayout(
+  area: PlainRect,
+  count: number,
+  gap: number,
+  basis: number,
+  delta: PlainDelta
+): Rect[] {
+  const layout = new QuarterLayout(config(gap));
+  return geometries(
+    layout,
+    area,
+    tiles(new Array(count).fill(1)),
+    basis,
+    delta
+  );
+}
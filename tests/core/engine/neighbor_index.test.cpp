@@ -0,0 +1,283 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include <doctest/doctest.h>
+
+#include <QCoreApplication>
+#include <QQmlContext>
+#include <QQmlEngine>
+#include <QRandomGenerator>
+#include <QRect>
+#include <QStringList>
+#include <QVariant>
+
+#include <algorithm>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "config.mock.hpp"
+#include "engine/engine.hpp"
+#include "engine/neighbor_index.hpp"
+#include "engine/window.hpp"
+#include "plasma-api/api.hpp"
+#include "plasma-api/client_handle.hpp"
+
+#include "plasma-api/client.mock.hpp"
+#include "plasma-api/workspace.hpp"
+#include "plasma-api/workspace.mock.hpp"
+
+namespace
+{
+/**
+ * Tiled windows with the given geometries
+ */
+struct TiledWindows {
+    TiledWindows(PlasmaApi::Workspace &workspace, const std::vector<QRect> &geometries)
+    {
+        for (auto geometry : geometries) {
+            auto client = std::make_unique<FakeKWinClient>();
+            client->m_frameGeometry = geometry;
+
+            auto window = std::make_unique<Bismuth::Window>(PlasmaApi::ClientHandle(client.get()), workspace);
+            window->setMode(Bismuth::Window::Mode::Tiled);
+
+            pointers.push_back(window.get());
+            clients.push_back(std::move(client));
+            windows.push_back(std::move(window));
+        }
+    }
+
+    Bismuth::Window &operator[](std::size_t index)
+    {
+        return *windows[index];
+    }
+
+    std::vector<std::unique_ptr<FakeKWinClient>> clients;
+    std::vector<std::unique_ptr<Bismuth::Window>> windows;
+    std::vector<Bismuth::Window *> pointers;
+};
+
+/**
+ * The same search as getNeighborByDirection() of the TS backend, which checks every window
+ */
+Bismuth::Window *linearNeighbor(const std::vector<Bismuth::Window *> &windows,
+                                QRect basis,
+                                Bismuth::Direction direction,
+                                const Bismuth::NeighborIndex::RecencyFunction &recency)
+{
+    auto overlap = [](int min1, int max1, int min2, int max2) {
+        return std::max(0, std::min(max1, max2) - std::max(min1, min2)) > 0;
+    };
+
+    auto vertical = direction == Bismuth::Direction::Up || direction == Bismuth::Direction::Down;
+    auto forward = direction == Bismuth::Direction::Down || direction == Bismuth::Direction::Right;
+
+    // Edges facing the basis
+    auto nearEdge = [&](QRect rect) {
+        if (vertical) {
+            return forward ? rect.y() : rect.y() + rect.height();
+        }
+        return forward ? rect.x() : rect.x() + rect.width();
+    };
+
+    auto candidates = std::vector<Bismuth::Window *>();
+    for (auto window : windows) {
+        auto rect = window->geometry();
+        auto isCandidate = false;
+        if (vertical) {
+            isCandidate = (forward ? rect.y() > basis.y() : rect.y() < basis.y())
+                && overlap(basis.x(), basis.x() + basis.width(), rect.x(), rect.x() + rect.width());
+        } else {
+            isCandidate = (forward ? rect.x() > basis.x() : rect.x() < basis.x())
+                && overlap(basis.y(), basis.y() + basis.height(), rect.y(), rect.y() + rect.height());
+        }
+        if (isCandidate) {
+            candidates.push_back(window);
+        }
+    }
+
+    if (candidates.empty()) {
+        return nullptr;
+    }
+
+    auto closestEdge = nearEdge(candidates.front()->geometry());
+    for (auto window : candidates) {
+        auto edge = nearEdge(window->geometry());
+        closestEdge = forward ? std::min(closestEdge, edge) : std::max(closestEdge, edge);
+    }
+
+    Bismuth::Window *result = nullptr;
+    for (auto window : candidates) {
+        auto edge = nearEdge(window->geometry());
+        auto isClosest = forward ? edge < closestEdge + Bismuth::NeighborIndex::edgeTolerance : edge > closestEdge - Bismuth::NeighborIndex::edgeTolerance;
+        if (isClosest && (!result || recency(*window) > recency(*result))) {
+            result = window;
+        }
+    }
+    return result;
+}
+}
+
+TEST_CASE("Neighbor Index")
+{
+    auto fakeKWinWorkspace = FakeKWinWorkspace();
+    auto workspace = PlasmaApi::Workspace(&fakeKWinWorkspace);
+
+    auto uses = std::unordered_map<const Bismuth::Window *, quint64>();
+    auto recency = [&](const Bismuth::Window &window) -> quint64 {
+        auto it = uses.find(&window);
+        return it != uses.end() ? it->second : 0;
+    };
+
+    // Master on the left, two windows in the stack on the right
+    auto windows = TiledWindows(workspace, {QRect(0, 0, 960, 1080), QRect(960, 0, 960, 540), QRect(960, 540, 960, 540)});
+    auto index = Bismuth::NeighborIndex();
+    index.commit(windows.pointers);
+
+    CHECK(index.size() == 3);
+
+    SUBCASE("Neighbors in every direction")
+    {
+        CHECK(index.neighbor(windows[1].geometry(), Bismuth::Direction::Down, recency) == &windows[2]);
+        CHECK(index.neighbor(windows[2].geometry(), Bismuth::Direction::Up, recency) == &windows[1]);
+        CHECK(index.neighbor(windows[1].geometry(), Bismuth::Direction::Left, recency) == &windows[0]);
+        CHECK(index.neighbor(windows[2].geometry(), Bismuth::Direction::Left, recency) == &windows[0]);
+
+        CHECK(index.neighbor(windows[0].geometry(), Bismuth::Direction::Left, recency) == nullptr);
+        CHECK(index.neighbor(windows[0].geometry(), Bismuth::Direction::Up, recency) == nullptr);
+        CHECK(index.neighbor(windows[1].geometry(), Bismuth::Direction::Right, recency) == nullptr);
+    }
+
+    SUBCASE("Ties are broken by recency")
+    {
+        uses[&windows[2]] = 1;
+        CHECK(index.neighbor(windows[0].geometry(), Bismuth::Direction::Right, recency) == &windows[2]);
+
+        uses[&windows[1]] = 2;
+        CHECK(index.neighbor(windows[0].geometry(), Bismuth::Direction::Right, recency) == &windows[1]);
+    }
+
+    SUBCASE("Edges within the tolerance are equally close")
+    {
+        windows[2].setGeometry(QRect(964, 540, 956, 540));
+        index.commit(windows.pointers);
+
+        uses[&windows[2]] = 1;
+        CHECK(index.neighbor(windows[0].geometry(), Bismuth::Direction::Right, recency) == &windows[2]);
+
+        windows[2].setGeometry(QRect(965, 540, 955, 540));
+        index.commit(windows.pointers);
+
+        CHECK(index.neighbor(windows[0].geometry(), Bismuth::Direction::Right, recency) == &windows[1]);
+    }
+
+    SUBCASE("Windows, that are not tiled, are removed")
+    {
+        windows[1].setMode(Bismuth::Window::Mode::Floating);
+        index.commit(windows.pointers);
+
+        CHECK(index.size() == 2);
+        CHECK(index.neighbor(windows[0].geometry(), Bismuth::Direction::Right, recency) == &windows[2]);
+
+        index.remove(windows[2]);
+        CHECK(index.size() == 1);
+        CHECK(index.neighbor(windows[0].geometry(), Bismuth::Direction::Right, recency) == nullptr);
+    }
+}
+
+TEST_CASE("Neighbor Index Matches The TS Backend")
+{
+    auto fakeKWinWorkspace = FakeKWinWorkspace();
+    auto workspace = PlasmaApi::Workspace(&fakeKWinWorkspace);
+    auto random = QRandomGenerator(42);
+
+    // Random grids with the jittered edges, some of them within the tolerance
+    auto geometries = std::vector<QRect>();
+    for (auto row = 0; row < 8; row++) {
+        for (auto column = 0; column < 8; column++) {
+            auto x = column * 240 + random.bounded(-8, 8);
+            auto y = row * 135 + random.bounded(-8, 8);
+            geometries.push_back(QRect(x, y, 240 + random.bounded(-8, 8), 135 + random.bounded(-8, 8)));
+        }
+    }
+
+    auto windows = TiledWindows(workspace, geometries);
+    auto uses = std::unordered_map<const Bismuth::Window *, quint64>();
+    for (auto window : windows.pointers) {
+        uses[window] = random.bounded(1000);
+    }
+    auto recency = [&](const Bismuth::Window &window) -> quint64 {
+        return uses.at(&window);
+    };
+
+    auto index = Bismuth::NeighborIndex();
+    index.commit(windows.pointers);
+
+    for (auto window : windows.pointers) {
+        for (auto direction : {Bismuth::Direction::Up, Bismuth::Direction::Down, Bismuth::Direction::Left, Bismuth::Direction::Right}) {
+            auto expected = linearNeighbor(windows.pointers, window->geometry(), direction, recency);
+            auto actual = index.neighbor(window->geometry(), direction, recency);
+
+            // Equally recent windows could be chosen in any order
+            if (actual != expected) {
+                REQUIRE(actual);
+                REQUIRE(expected);
+                CHECK(recency(*actual) == recency(*expected));
+            }
+        }
+    }
+}
+
+TEST_CASE("Engine Directional Focus")
+{
+    auto qmlEngine = QQmlEngine();
+    auto fakeKWinWorkspace = FakeKWinWorkspace();
+    fakeKWinWorkspace.m_currentDesktop = 1;
+    fakeKWinWorkspace.m_currentActivity = QStringLiteral("abc");
+    fakeKWinWorkspace.m_numScreens = 1;
+    qmlEngine.rootContext()->setContextProperty(QStringLiteral("workspace"), &fakeKWinWorkspace);
+
+    auto config = FakeConfig();
+    auto plasmaApi = PlasmaApi::Api(&qmlEngine);
+    auto engine = Bismuth::Engine(plasmaApi, config);
+
+    auto clients = std::vector<std::unique_ptr<FakeKWinClient>>();
+    for (auto i = 0; i < 2; i++) {
+        auto client = std::make_unique<FakeKWinClient>();
+        client->m_desktop = 1;
+        client->m_activities = QStringList(QStringLiteral("abc"));
+        engine.addWindow(PlasmaApi::ClientHandle(client.get()));
+        clients.push_back(std::move(client));
+    }
+
+    auto activeClient = [&]() {
+        return fakeKWinWorkspace.property("activeClient").value<QObject *>();
+    };
+
+    // The master is on the left, the other window is on the right
+    QCoreApplication::processEvents();
+    REQUIRE(clients[0]->m_frameGeometry.x() < clients[1]->m_frameGeometry.x());
+
+    fakeKWinWorkspace.setProperty("activeClient", QVariant::fromValue(static_cast<QObject *>(clients[0].get())));
+
+    SUBCASE("Focus")
+    {
+        engine.focusWindowByDirection(Bismuth::Engine::FocusDirection::Right);
+        CHECK(activeClient() == clients[1].get());
+
+        engine.focusWindowByDirection(Bismuth::Engine::FocusDirection::Left);
+        CHECK(activeClient() == clients[0].get());
+    }
+
+    SUBCASE("Swap")
+    {
+        auto masterGeometry = clients[0]->m_frameGeometry;
+
+        engine.swapWindowByDirection(Bismuth::Engine::FocusDirection::Right);
+        QCoreApplication::processEvents();
+
+        CHECK(clients[1]->m_frameGeometry == masterGeometry);
+        CHECK(clients[0]->m_frameGeometry.x() > clients[1]->m_frameGeometry.x());
+    }
+}
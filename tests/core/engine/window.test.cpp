@@ -8,7 +8,7 @@
 
 #include "engine/surface.hpp"
 #include "engine/window.hpp"
-#include "plasma-api/client.hpp"
+#include "plasma-api/client_handle.hpp"
 
 #include "plasma-api/client.mock.hpp"
 #include "plasma-api/workspace.hpp"
@@ -18,7 +18,7 @@ TEST_CASE("Window Visibility")
 {
     auto fakeKWinClient = FakeKWinClient();
     auto fakeKwinWorkspace = FakeKWinWorkspace();
-    auto client = PlasmaApi::Client(&fakeKWinClient);
+    auto client = PlasmaApi::ClientHandle(&fakeKWinClient);
     auto workspace = PlasmaApi::Workspace(&fakeKwinWorkspace);
     auto window = Bismuth::Window(client, workspace);
 
@@ -117,7 +117,7 @@ TEST_CASE("Desktops List")
 {
     auto fakeKWinClient = FakeKWinClient();
     auto fakeKWinWorkspace = FakeKWinWorkspace();
-    auto client = PlasmaApi::Client(&fakeKWinClient);
+    auto client = PlasmaApi::ClientHandle(&fakeKWinClient);
     auto workspace = PlasmaApi::Workspace(&fakeKWinWorkspace);
     auto window = Bismuth::Window(client, workspace);
 
@@ -153,7 +153,7 @@ TEST_CASE("Activities List")
 {
     auto fakeKWinClient = FakeKWinClient();
     auto fakeKWinWorkspace = FakeKWinWorkspace();
-    auto client = PlasmaApi::Client(&fakeKWinClient);
+    auto client = PlasmaApi::ClientHandle(&fakeKWinClient);
     auto workspace = PlasmaApi::Workspace(&fakeKWinWorkspace);
     auto window = Bismuth::Window(client, workspace);
 
@@ -194,3 +194,77 @@ TEST_CASE("Activities List")
         CHECK(activities.back() == QStringLiteral("diamond-is-unbreakable"));
     }
 }
+
+TEST_CASE("Window Snapshot")
+{
+    auto fakeKWinClient = FakeKWinClient();
+    auto fakeKWinWorkspace = FakeKWinWorkspace();
+    auto client = PlasmaApi::ClientHandle(&fakeKWinClient);
+    auto workspace = PlasmaApi::Workspace(&fakeKWinWorkspace);
+
+    fakeKWinClient.m_desktop = 1;
+    auto window = Bismuth::Window(client, workspace);
+    auto surface = Bismuth::Surface(1, 0, "");
+
+    REQUIRE(window.visibleOn(surface) == true);
+
+    SUBCASE("Properties are read once")
+    {
+        // Changed behind the back, no notification
+        fakeKWinClient.m_desktop = 2;
+
+        CHECK(window.visibleOn(surface) == true);
+    }
+
+    SUBCASE("Change notification invalidates the snapshot")
+    {
+        fakeKWinClient.setProperty("desktop", 2);
+
+        CHECK(window.visibleOn(surface) == false);
+    }
+
+    SUBCASE("Copies share the snapshot")
+    {
+        auto copy = window;
+        fakeKWinClient.setProperty("minimized", true);
+
+        CHECK(copy.visibleOn(surface) == false);
+        CHECK(window.snapshot().minimized == true);
+    }
+
+    SUBCASE("Geometry is read back after the change")
+    {
+        window.setGeometry(QRect(10, 20, 300, 400));
+
+        CHECK(window.geometry() == QRect(10, 20, 300, 400));
+    }
+
+    SUBCASE("Geometry change reads only the geometry again")
+    {
+        // Changed behind the back, no notification
+        fakeKWinClient.m_desktop = 2;
+
+        window.setGeometry(QRect(10, 20, 300, 400));
+        CHECK(window.geometry() == QRect(10, 20, 300, 400));
+
+        fakeKWinClient.setProperty("frameGeometry", QRect(0, 0, 100, 100));
+        CHECK(window.geometry() == QRect(0, 0, 100, 100));
+
+        CHECK(window.visibleOn(surface) == true);
+    }
+
+    SUBCASE("Finished user resize is reported with the new geometry")
+    {
+        auto finished = 0;
+        window.onUserMoveResizeFinished([&finished]() {
+            finished++;
+        });
+
+        // KWin notifies about the geometry only when the resize is finished
+        fakeKWinClient.m_frameGeometry = QRect(0, 0, 200, 100);
+        Q_EMIT fakeKWinClient.clientFinishUserMovedResized(&fakeKWinClient);
+
+        CHECK(finished == 1);
+        CHECK(window.geometry() == QRect(0, 0, 200, 100));
+    }
+}
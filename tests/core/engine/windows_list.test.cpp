@@ -0,0 +1,528 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include <doctest/doctest.h>
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QObject>
+#include <QQmlContext>
+#include <QQmlEngine>
+#include <QString>
+#include <QVariant>
+
+#include <algorithm>
+#include <memory>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "config.mock.hpp"
+#include "engine/engine.hpp"
+#include "engine/surface.hpp"
+#include "engine/windows_list.hpp"
+#include "plasma-api/api.hpp"
+#include "plasma-api/client_handle.hpp"
+
+#include "plasma-api/client.mock.hpp"
+#include "plasma-api/workspace.hpp"
+#include "plasma-api/workspace.mock.hpp"
+
+namespace
+{
+/**
+ * Spread the clients over 2 screens and 2 desktops of the "abc" activity
+ */
+std::vector<std::unique_ptr<FakeKWinClient>> fakeClients(int count)
+{
+    auto result = std::vector<std::unique_ptr<FakeKWinClient>>();
+    for (auto i = 0; i < count; i++) {
+        auto client = std::make_unique<FakeKWinClient>();
+        client->m_screen = i % 2;
+        client->m_desktop = 1 + (i / 2) % 2;
+        client->m_activities = QStringList(QStringLiteral("abc"));
+        client->m_minimized = i % 10 == 0;
+        client->m_frameGeometry = QRect(0, 0, 100, 100);
+        result.push_back(std::move(client));
+    }
+    return result;
+}
+}
+
+TEST_CASE("Windows List Visible Windows")
+{
+    auto fakeKWinWorkspace = FakeKWinWorkspace();
+    auto workspace = PlasmaApi::Workspace(&fakeKWinWorkspace);
+    auto windowsList = Bismuth::WindowsList(workspace);
+
+    auto clients = fakeClients(20);
+    for (auto &client : clients) {
+        windowsList.add(PlasmaApi::ClientHandle(client.get()));
+    }
+
+    // Clients 0, 4, 8, 12 and 16 are there, but 0 is minimized
+    auto visible = windowsList.visibleWindowsOn(Bismuth::Surface(1, 0, QStringLiteral("abc")));
+    CHECK(visible.size() == 4);
+
+    auto otherActivity = windowsList.visibleWindowsOn(Bismuth::Surface(1, 0, QStringLiteral("xyz")));
+    CHECK(otherActivity.empty());
+}
+
+TEST_CASE("Windows List Follows The Windows")
+{
+    auto fakeKWinWorkspace = FakeKWinWorkspace();
+    auto workspace = PlasmaApi::Workspace(&fakeKWinWorkspace);
+    auto windowsList = Bismuth::WindowsList(workspace);
+
+    auto fakeClient = FakeKWinClient();
+    fakeClient.m_desktop = 1;
+    fakeClient.m_activities = QStringList(QStringLiteral("abc"));
+    auto client = PlasmaApi::ClientHandle(&fakeClient);
+
+    auto &window = windowsList.add(client);
+    auto desktop1 = Bismuth::Surface(1, 0, QStringLiteral("abc"));
+    auto desktop2 = Bismuth::Surface(2, 0, QStringLiteral("abc"));
+
+    REQUIRE(windowsList.visibleWindowsOn(desktop1).size() == 1);
+    CHECK(&windowsList.visibleWindowsOn(desktop1).front() == &window);
+
+    SUBCASE("Window moved to another desktop")
+    {
+        fakeClient.setProperty("desktop", 2);
+
+        CHECK(windowsList.visibleWindowsOn(desktop1).empty());
+        CHECK(windowsList.visibleWindowsOn(desktop2).size() == 1);
+    }
+
+    SUBCASE("Window minimized and restored")
+    {
+        fakeClient.setProperty("minimized", true);
+        CHECK(windowsList.visibleWindowsOn(desktop1).empty());
+
+        fakeClient.setProperty("minimized", false);
+        CHECK(windowsList.visibleWindowsOn(desktop1).size() == 1);
+    }
+
+    SUBCASE("Window on all desktops")
+    {
+        fakeKWinWorkspace.m_numberOfDesktops = 2;
+        Q_EMIT fakeKWinWorkspace.numberDesktopsChanged(1);
+        fakeClient.setProperty("onAllDesktops", true);
+
+        CHECK(windowsList.visibleWindowsOn(desktop1).size() == 1);
+        CHECK(windowsList.visibleWindowsOn(desktop2).size() == 1);
+    }
+
+    SUBCASE("Removed window")
+    {
+        windowsList.remove(client);
+        CHECK(windowsList.visibleWindowsOn(desktop1).empty());
+
+        // Is not indexed again on change
+        fakeClient.setProperty("desktop", 2);
+        CHECK(windowsList.visibleWindowsOn(desktop2).empty());
+    }
+}
+
+TEST_CASE("Windows List Tiling Order")
+{
+    auto fakeKWinWorkspace = FakeKWinWorkspace();
+    auto workspace = PlasmaApi::Workspace(&fakeKWinWorkspace);
+    auto windowsList = Bismuth::WindowsList(workspace);
+
+    auto clients = std::vector<std::unique_ptr<FakeKWinClient>>();
+    auto windows = std::vector<Bismuth::Window *>();
+    for (auto i = 0; i < 4; i++) {
+        auto client = std::make_unique<FakeKWinClient>();
+        client->m_desktop = 1;
+        client->m_activities = QStringList(QStringLiteral("abc"));
+        windows.push_back(&windowsList.add(PlasmaApi::ClientHandle(client.get())));
+        clients.push_back(std::move(client));
+    }
+
+    auto desktop1 = Bismuth::Surface(1, 0, QStringLiteral("abc"));
+    auto desktop2 = Bismuth::Surface(2, 0, QStringLiteral("abc"));
+
+    auto order = [&](const Bismuth::Surface &surface) {
+        auto result = std::vector<Bismuth::Window *>();
+        for (auto &window : windowsList.visibleWindowsOn(surface)) {
+            result.push_back(&window);
+        }
+        return result;
+    };
+
+    auto [w0, w1, w2, w3] = std::make_tuple(windows[0], windows[1], windows[2], windows[3]);
+
+    CHECK(order(desktop1) == std::vector({w0, w1, w2, w3}));
+
+    SUBCASE("Swap")
+    {
+        windowsList.swap(*w0, *w3);
+        CHECK(order(desktop1) == std::vector({w3, w1, w2, w0}));
+    }
+
+    SUBCASE("Move before and after")
+    {
+        windowsList.moveBefore(*w3, *w1);
+        CHECK(order(desktop1) == std::vector({w0, w3, w1, w2}));
+
+        windowsList.moveAfter(*w0, *w2);
+        CHECK(order(desktop1) == std::vector({w3, w1, w2, w0}));
+
+        // Already there
+        windowsList.moveAfter(*w0, *w2);
+        CHECK(order(desktop1) == std::vector({w3, w1, w2, w0}));
+    }
+
+    SUBCASE("Push to master")
+    {
+        windowsList.pushToMaster(*w2);
+        CHECK(order(desktop1) == std::vector({w2, w0, w1, w3}));
+    }
+
+    SUBCASE("Window keeps its place, when it comes back to the surface")
+    {
+        clients[1]->setProperty("desktop", 2);
+        CHECK(order(desktop1) == std::vector({w0, w2, w3}));
+        CHECK(order(desktop2) == std::vector({w1}));
+
+        // Moved while away
+        windowsList.moveAfter(*w1, *w2);
+
+        clients[1]->setProperty("desktop", 1);
+        CHECK(order(desktop1) == std::vector({w0, w2, w1, w3}));
+    }
+
+    SUBCASE("Many moves to the same place")
+    {
+        // Every move halves the space between the neighbors, until it runs out
+        for (auto i = 0; i < 200; i++) {
+            windowsList.moveAfter(i % 2 ? *w2 : *w3, *w0);
+        }
+        CHECK(order(desktop1) == std::vector({w0, w2, w3, w1}));
+    }
+
+    SUBCASE("Stepping through the windows of the surface wraps around")
+    {
+        CHECK(windowsList.firstWindowOn(desktop1) == w0);
+        CHECK(windowsList.nextWindowOn(desktop1, *w1) == w2);
+        CHECK(windowsList.nextWindowOn(desktop1, *w3) == w0);
+        CHECK(windowsList.previousWindowOn(desktop1, *w1) == w0);
+        CHECK(windowsList.previousWindowOn(desktop1, *w0) == w3);
+
+        // Windows on other surfaces are skipped
+        clients[2]->setProperty("desktop", 2);
+        CHECK(windowsList.nextWindowOn(desktop1, *w1) == w3);
+        CHECK(windowsList.nextWindowOn(desktop1, *w2) == nullptr);
+        CHECK(windowsList.nextWindowOn(desktop2, *w2) == w2);
+        CHECK(windowsList.firstWindowOn(Bismuth::Surface(3, 0, QStringLiteral("abc"))) == nullptr);
+    }
+
+    SUBCASE("Removed and added again window goes to the end")
+    {
+        windowsList.remove(PlasmaApi::ClientHandle(clients[0].get()));
+        w0 = &windowsList.add(PlasmaApi::ClientHandle(clients[0].get()));
+        CHECK(order(desktop1) == std::vector({w1, w2, w3, w0}));
+    }
+}
+
+TEST_CASE("Engine New Window Spawn Location")
+{
+    auto qmlEngine = QQmlEngine();
+    auto fakeKWinWorkspace = FakeKWinWorkspace();
+    fakeKWinWorkspace.m_currentDesktop = 1;
+    fakeKWinWorkspace.m_currentActivity = QStringLiteral("abc");
+    fakeKWinWorkspace.m_numScreens = 1;
+    qmlEngine.rootContext()->setContextProperty(QStringLiteral("workspace"), &fakeKWinWorkspace);
+
+    auto config = FakeConfig();
+    auto plasmaApi = PlasmaApi::Api(&qmlEngine);
+
+    auto clients = std::vector<std::unique_ptr<FakeKWinClient>>();
+    for (auto i = 0; i < 4; i++) {
+        auto client = std::make_unique<FakeKWinClient>();
+        client->m_desktop = 1;
+        client->m_activities = QStringList(QStringLiteral("abc"));
+        clients.push_back(std::move(client));
+    }
+
+    // The master of the tile layout is on the left, the stack is ordered from the top
+    auto tilingOrder = [&]() {
+        auto result = std::vector<FakeKWinClient *>();
+        for (auto &client : clients) {
+            result.push_back(client.get());
+        }
+        std::sort(result.begin(), result.end(), [](FakeKWinClient *lhs, FakeKWinClient *rhs) {
+            auto lhsGeometry = lhs->m_frameGeometry;
+            auto rhsGeometry = rhs->m_frameGeometry;
+            return std::make_pair(lhsGeometry.x(), lhsGeometry.y()) < std::make_pair(rhsGeometry.x(), rhsGeometry.y());
+        });
+        return result;
+    };
+
+    auto spawn = [&](const QString &location) {
+        config.setNewWindowSpawnLocation(location);
+        fakeKWinWorkspace.setProperty("activeClient", QVariant::fromValue(static_cast<QObject *>(nullptr)));
+        auto engine = Bismuth::Engine(plasmaApi, config);
+
+        for (auto i = 0; i < 3; i++) {
+            engine.addWindow(PlasmaApi::ClientHandle(clients[i].get()));
+        }
+
+        // The second window has the focus, when the last one appears
+        fakeKWinWorkspace.setProperty("activeClient", QVariant::fromValue(static_cast<QObject *>(clients[1].get())));
+        engine.addWindow(PlasmaApi::ClientHandle(clients[3].get()));
+
+        QCoreApplication::processEvents();
+        return tilingOrder();
+    };
+
+    auto [c0, c1, c2, c3] = std::make_tuple(clients[0].get(), clients[1].get(), clients[2].get(), clients[3].get());
+
+    CHECK(spawn(QStringLiteral("end")) == std::vector({c0, c1, c2, c3}));
+    CHECK(spawn(QStringLiteral("master")) == std::vector({c3, c0, c1, c2}));
+    CHECK(spawn(QStringLiteral("beforeFocused")) == std::vector({c0, c3, c1, c2}));
+    CHECK(spawn(QStringLiteral("afterFocused")) == std::vector({c0, c1, c3, c2}));
+}
+
+TEST_CASE("Engine Surfaces Follow The Desktops")
+{
+    auto qmlEngine = QQmlEngine();
+    auto fakeKWinWorkspace = FakeKWinWorkspace();
+    fakeKWinWorkspace.m_numberOfDesktops = 2;
+    fakeKWinWorkspace.m_currentDesktop = 1;
+    fakeKWinWorkspace.m_currentActivity = QStringLiteral("abc");
+    fakeKWinWorkspace.m_numScreens = 1;
+    qmlEngine.rootContext()->setContextProperty(QStringLiteral("workspace"), &fakeKWinWorkspace);
+
+    auto config = FakeConfig();
+    auto plasmaApi = PlasmaApi::Api(&qmlEngine);
+    auto engine = Bismuth::Engine(plasmaApi, config);
+
+    // The same as the controller does with the experimental backend
+    QObject::connect(&plasmaApi.workspace(), &PlasmaApi::Workspace::numberDesktopsChanged, [&](uint) {
+        engine.updateSurfaces();
+    });
+
+    // On all desktops
+    auto stickyClient = FakeKWinClient();
+    stickyClient.m_onAllDesktops = true;
+    stickyClient.m_activities = QStringList(QStringLiteral("abc"));
+    engine.addWindow(PlasmaApi::ClientHandle(&stickyClient));
+    QCoreApplication::processEvents();
+
+    auto activeClient = [&]() {
+        return fakeKWinWorkspace.property("activeClient").value<QObject *>();
+    };
+
+    // Only the windows on the current desktop are focused
+    auto focusOnDesktop = [&](int desktop) {
+        fakeKWinWorkspace.m_currentDesktop = desktop;
+        fakeKWinWorkspace.setProperty("activeClient", QVariant::fromValue(static_cast<QObject *>(nullptr)));
+        engine.focusWindowByOrder(Bismuth::Engine::FocusOrder::Next);
+        return activeClient() == &stickyClient;
+    };
+
+    REQUIRE(focusOnDesktop(2));
+    CHECK(!focusOnDesktop(3));
+
+    SUBCASE("Desktop added")
+    {
+        fakeKWinWorkspace.m_numberOfDesktops = 3;
+        Q_EMIT fakeKWinWorkspace.numberDesktopsChanged(2);
+
+        CHECK(focusOnDesktop(3));
+    }
+
+    SUBCASE("Desktop removed")
+    {
+        fakeKWinWorkspace.m_numberOfDesktops = 1;
+        Q_EMIT fakeKWinWorkspace.numberDesktopsChanged(2);
+
+        CHECK(!focusOnDesktop(2));
+        CHECK(focusOnDesktop(1));
+    }
+}
+
+TEST_CASE("Windows List visibleWindowsOn Benchmark" * doctest::test_suite("benchmark") * doctest::skip())
+{
+    constexpr auto iterations = 1000;
+    constexpr auto numClients = 500;
+
+    auto fakeKWinWorkspace = FakeKWinWorkspace();
+    auto workspace = PlasmaApi::Workspace(&fakeKWinWorkspace);
+    auto windowsList = Bismuth::WindowsList(workspace);
+
+    auto clients = fakeClients(numClients);
+    for (auto &client : clients) {
+        windowsList.add(PlasmaApi::ClientHandle(client.get()));
+    }
+
+    auto surface = Bismuth::Surface(1, 0, QStringLiteral("abc"));
+
+    // What the property wrappers did before: look every property up by its name
+    auto byNameTimer = QElapsedTimer();
+    byNameTimer.start();
+    auto byNameCount = 0;
+    for (auto i = 0; i < iterations; i++) {
+        for (auto &client : clients) {
+            auto visible = !client->property("minimized").toBool()
+                && (client->property("onAllDesktops").toBool() || client->property("desktop").toInt() == surface.desktop())
+                && client->property("screen").toInt() == surface.screen()
+                && client->property("activities").toStringList().contains(surface.activity());
+            byNameCount += visible;
+        }
+    }
+    auto byNameNs = byNameTimer.nsecsElapsed();
+
+    auto listTimer = QElapsedTimer();
+    listTimer.start();
+    auto resolvedCount = 0;
+    for (auto i = 0; i < iterations; i++) {
+        resolvedCount += windowsList.visibleWindowsOn(surface).size();
+    }
+    auto listNs = listTimer.nsecsElapsed();
+
+    CHECK(byNameCount == resolvedCount);
+
+    MESSAGE("Time per visibleWindowsOn over " << numClients << " clients, properties by name: " << byNameNs / iterations / 1000 << " us");
+    MESSAGE("Time per visibleWindowsOn over " << numClients << " clients, windows list: " << listNs / iterations / 1000 << " us");
+}
+
+TEST_CASE("Windows List Surfaces Scaling Benchmark" * doctest::test_suite("benchmark") * doctest::skip())
+{
+    constexpr auto iterations = 100;
+    constexpr auto numDesktops = 10;
+    constexpr auto numScreens = 4;
+    constexpr auto numClients = 300;
+
+    auto fakeKWinWorkspace = FakeKWinWorkspace();
+    fakeKWinWorkspace.m_numberOfDesktops = numDesktops;
+    auto workspace = PlasmaApi::Workspace(&fakeKWinWorkspace);
+    auto windowsList = Bismuth::WindowsList(workspace);
+
+    auto clients = std::vector<std::unique_ptr<FakeKWinClient>>();
+    auto windows = std::vector<Bismuth::Window>();
+    for (auto i = 0; i < numClients; i++) {
+        auto client = std::make_unique<FakeKWinClient>();
+        client->m_desktop = 1 + i % numDesktops;
+        client->m_screen = (i / numDesktops) % numScreens;
+        client->m_activities = QStringList(QStringLiteral("abc"));
+        windowsList.add(PlasmaApi::ClientHandle(client.get()));
+        windows.push_back(Bismuth::Window(PlasmaApi::ClientHandle(client.get()), workspace));
+        clients.push_back(std::move(client));
+    }
+
+    auto surfaces = std::vector<Bismuth::Surface>();
+    for (auto desktop = 1; desktop <= numDesktops; desktop++) {
+        for (auto screen = 0; screen < numScreens; screen++) {
+            surfaces.push_back(Bismuth::Surface(desktop, screen, QStringLiteral("abc")));
+        }
+    }
+
+    // What arranging all the surfaces did before: scan and copy all the windows for every surface
+    auto scanTimer = QElapsedTimer();
+    scanTimer.start();
+    auto scanCount = std::size_t(0);
+    for (auto i = 0; i < iterations; i++) {
+        for (auto &surface : surfaces) {
+            auto result = std::vector<Bismuth::Window>();
+            for (auto window : windows) {
+                if (window.visibleOn(surface)) {
+                    result.push_back(window);
+                }
+            }
+            scanCount += result.size();
+        }
+    }
+    auto scanNs = scanTimer.nsecsElapsed();
+
+    auto indexTimer = QElapsedTimer();
+    indexTimer.start();
+    auto indexCount = std::size_t(0);
+    for (auto i = 0; i < iterations; i++) {
+        for (auto &surface : surfaces) {
+            indexCount += windowsList.visibleWindowsOn(surface).size();
+        }
+    }
+    auto indexNs = indexTimer.nsecsElapsed();
+
+    CHECK(scanCount == indexCount);
+
+    // Keeping the index up to date
+    auto moveTimer = QElapsedTimer();
+    moveTimer.start();
+    for (auto i = 0; i < numClients; i++) {
+        clients[i]->setProperty("desktop", 1 + (i + 1) % numDesktops);
+    }
+    auto moveNs = moveTimer.nsecsElapsed();
+
+    MESSAGE("Time to query " << surfaces.size() << " surfaces with " << numClients << " windows, scan: " << scanNs / iterations / 1000 << " us");
+    MESSAGE("Time to query " << surfaces.size() << " surfaces with " << numClients << " windows, index: " << indexNs / iterations / 1000 << " us");
+    MESSAGE("Time to move a window to another desktop: " << moveNs / numClients << " ns");
+}
+
+TEST_CASE("Windows List Drag Reorder Benchmark" * doctest::test_suite("benchmark") * doctest::skip())
+{
+    constexpr auto iterations = 100;
+    constexpr auto numClients = 200;
+
+    auto fakeKWinWorkspace = FakeKWinWorkspace();
+    auto workspace = PlasmaApi::Workspace(&fakeKWinWorkspace);
+    auto windowsList = Bismuth::WindowsList(workspace);
+
+    auto clients = std::vector<std::unique_ptr<FakeKWinClient>>();
+    auto windows = std::vector<Bismuth::Window *>();
+    for (auto i = 0; i < numClients; i++) {
+        auto client = std::make_unique<FakeKWinClient>();
+        client->m_desktop = 1;
+        client->m_activities = QStringList(QStringLiteral("abc"));
+        windows.push_back(&windowsList.add(PlasmaApi::ClientHandle(client.get())));
+        clients.push_back(std::move(client));
+    }
+
+    auto surface = Bismuth::Surface(1, 0, QStringLiteral("abc"));
+
+    // What the TS backend does: find both windows and splice the array on every step
+    auto array = windows;
+    auto spliceTimer = QElapsedTimer();
+    spliceTimer.start();
+    for (auto i = 0; i < iterations; i++) {
+        // Drag the first window over all the others to the end
+        auto dragged = array.front();
+        for (auto step = 1; step < numClients; step++) {
+            auto target = array[step];
+            auto draggedIt = std::find(array.begin(), array.end(), dragged);
+            array.erase(draggedIt);
+            auto targetIt = std::find(array.begin(), array.end(), target);
+            array.insert(targetIt + 1, dragged);
+        }
+    }
+    auto spliceNs = spliceTimer.nsecsElapsed();
+
+    auto listTimer = QElapsedTimer();
+    listTimer.start();
+    for (auto i = 0; i < iterations; i++) {
+        auto dragged = &windowsList.visibleWindowsOn(surface).front();
+        for (auto step = 1; step < numClients; step++) {
+            windowsList.moveAfter(*dragged, windowsList.visibleWindowsOn(surface)[step]);
+        }
+    }
+    auto listNs = listTimer.nsecsElapsed();
+
+    // Without the views in between, like the moves of the same event
+    auto movesTimer = QElapsedTimer();
+    movesTimer.start();
+    for (auto i = 0; i < iterations; i++) {
+        auto dragged = windows[i % numClients];
+        for (auto step = 1; step < numClients; step++) {
+            windowsList.moveAfter(*dragged, *windows[(i + step) % numClients]);
+        }
+    }
+    auto movesNs = movesTimer.nsecsElapsed();
+
+    auto steps = iterations * (numClients - 1);
+    MESSAGE("Time per drag step over " << numClients << " windows, array splice: " << spliceNs / steps << " ns");
+    MESSAGE("Time per drag step over " << numClients << " windows, windows list with the view: " << listNs / steps << " ns");
+    MESSAGE("Time per drag step over " << numClients << " windows, windows list: " << movesNs / steps << " ns");
+}
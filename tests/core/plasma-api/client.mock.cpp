@@ -11,6 +11,7 @@ FakeKWinClient &FakeKWinClient::operator=(const FakeKWinClient &rhs)
         m_desktop = rhs.m_desktop;
         m_screen = rhs.m_screen;
         m_activities = rhs.m_activities;
+        m_windowId = rhs.m_windowId;
     }
 
     return *this;
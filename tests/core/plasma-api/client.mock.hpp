@@ -11,12 +11,13 @@ class FakeKWinClient : public QObject
 {
     Q_OBJECT
 
-    Q_PROPERTY(bool minimized MEMBER m_minimized)
-    Q_PROPERTY(bool onAllDesktops MEMBER m_onAllDesktops)
-    Q_PROPERTY(int desktop MEMBER m_desktop)
-    Q_PROPERTY(int screen MEMBER m_screen)
-    Q_PROPERTY(QStringList activities MEMBER m_activities)
-    Q_PROPERTY(QRect frameGeometry MEMBER m_frameGeometry)
+    Q_PROPERTY(bool minimized MEMBER m_minimized NOTIFY minimizedChanged)
+    Q_PROPERTY(bool onAllDesktops MEMBER m_onAllDesktops NOTIFY desktopPresenceChanged)
+    Q_PROPERTY(int desktop MEMBER m_desktop NOTIFY desktopChanged)
+    Q_PROPERTY(int screen MEMBER m_screen NOTIFY screenChanged)
+    Q_PROPERTY(QStringList activities MEMBER m_activities NOTIFY activitiesChanged)
+    Q_PROPERTY(QRect frameGeometry MEMBER m_frameGeometry NOTIFY frameGeometryChanged)
+    Q_PROPERTY(quint32 windowId MEMBER m_windowId)
 
 public:
     FakeKWinClient &operator=(const FakeKWinClient &);
@@ -27,4 +28,14 @@ public:
     int m_screen{};
     QStringList m_activities{};
     QRect m_frameGeometry{};
+    quint32 m_windowId{};
+
+Q_SIGNALS:
+    void minimizedChanged();
+    void desktopPresenceChanged();
+    void desktopChanged();
+    void screenChanged();
+    void activitiesChanged();
+    void frameGeometryChanged();
+    void clientFinishUserMovedResized(QObject *client);
 };
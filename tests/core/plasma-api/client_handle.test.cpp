@@ -0,0 +1,92 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include <doctest/doctest.h>
+
+#include <QSet>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <unordered_set>
+
+#include "plasma-api/client.hpp"
+#include "plasma-api/client_handle.hpp"
+#include "plasma-api/workspace.hpp"
+
+#include "plasma-api/client.mock.hpp"
+#include "plasma-api/workspace.mock.hpp"
+
+namespace
+{
+std::atomic<std::size_t> allocationCount{};
+}
+
+// Count the heap allocations of the whole test runner
+void *operator new(std::size_t size)
+{
+    allocationCount++;
+    if (auto ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+TEST_CASE("Client Handle Identity")
+{
+    auto fakeClient1 = FakeKWinClient();
+    auto fakeClient2 = FakeKWinClient();
+
+    auto handle1 = PlasmaApi::ClientHandle(&fakeClient1);
+    auto handle2 = PlasmaApi::ClientHandle(&fakeClient2);
+
+    CHECK(handle1 == PlasmaApi::Client(&fakeClient1).handle());
+    CHECK(handle1 != handle2);
+    CHECK((handle1 < handle2) != (handle2 < handle1));
+    CHECK(PlasmaApi::ClientHandle().isNull());
+
+    CHECK(QSet<PlasmaApi::ClientHandle>({handle1, handle2, handle1}).size() == 2);
+    CHECK(std::unordered_set<PlasmaApi::ClientHandle>({handle1, handle2, handle1}).size() == 2);
+
+    fakeClient1.m_desktop = 3;
+    CHECK(handle1.desktop() == 3);
+}
+
+TEST_CASE("Client Signals Do Not Allocate")
+{
+    auto fakeKWinWorkspace = FakeKWinWorkspace();
+    auto workspace = PlasmaApi::Workspace(&fakeKWinWorkspace);
+
+    auto fakeClient = FakeKWinClient();
+    auto kwinClient = reinterpret_cast<KWin::AbstractClient *>(&fakeClient);
+
+    auto received = PlasmaApi::ClientHandle();
+    QObject::connect(&workspace, &PlasmaApi::Workspace::clientAdded, [&](PlasmaApi::ClientHandle client) {
+        received = client;
+    });
+    QObject::connect(&workspace, &PlasmaApi::Workspace::clientMaximizeSet, [&](PlasmaApi::ClientHandle client, bool, bool) {
+        received = client;
+    });
+
+    // Warm up, in case Qt allocates anything on the first dispatch
+    Q_EMIT fakeKWinWorkspace.clientAdded(kwinClient);
+    received = {};
+
+    auto allocationsBefore = allocationCount.load();
+    Q_EMIT fakeKWinWorkspace.clientAdded(kwinClient);
+    Q_EMIT fakeKWinWorkspace.clientMaximizeSet(kwinClient, true, true);
+    auto allocations = allocationCount.load() - allocationsBefore;
+
+    CHECK(allocations == 0);
+    CHECK(received == PlasmaApi::ClientHandle(&fakeClient));
+}
@@ -9,3 +9,9 @@ FakeKWinWorkspace &FakeKWinWorkspace::operator=(const FakeKWinWorkspace &rhs)
 
     return *this;
 }
+
+QRect FakeKWinWorkspace::clientArea(ClientAreaOption, int screen, int)
+{
+    m_clientAreaCalls++;
+    return QRect(screen * 1920, 0, 1920, 1080);
+}
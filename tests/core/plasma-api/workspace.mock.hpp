@@ -4,6 +4,7 @@
 #pragma once
 
 #include <QObject>
+#include <QRect>
 
 namespace KWin
 {
@@ -16,16 +17,44 @@ class FakeKWinWorkspace : public QObject
 
     Q_PROPERTY(int desktops MEMBER m_numberOfDesktops)
     Q_PROPERTY(QStringList activities MEMBER m_activities)
+    Q_PROPERTY(int currentDesktop MEMBER m_currentDesktop)
+    Q_PROPERTY(QString currentActivity MEMBER m_currentActivity)
+    Q_PROPERTY(int numScreens MEMBER m_numScreens)
 
 public:
+    enum ClientAreaOption {
+        PlacementArea,
+        MovementArea,
+        MaximizeArea,
+        MaximizeFullArea,
+        FullScreenArea,
+        WorkArea,
+        FullArea,
+        ScreenArea,
+    };
+    Q_ENUM(ClientAreaOption)
+
     FakeKWinWorkspace &operator=(const FakeKWinWorkspace &);
 
+    /**
+     * Screens are 1920x1080 and placed from left to right. The calls are
+     * counted in m_clientAreaCalls.
+     */
+    Q_INVOKABLE QRect clientArea(ClientAreaOption option, int screen, int desktop);
+
     int m_numberOfDesktops{};
     QStringList m_activities{};
+    int m_currentDesktop{};
+    QString m_currentActivity{};
+    int m_numScreens{};
+    int m_clientAreaCalls{};
 
 Q_SIGNALS:
     void numberScreensChanged(int count);
     void screenResized(int screen);
+    void numberDesktopsChanged(uint oldNumberOfDesktops);
+    void activityAdded(const QString &id);
+    void activityRemoved(const QString &id);
     void currentActivityChanged(const QString &id);
     void clientAdded(KWin::AbstractClient *);
     void clientMaximizeSet(KWin::AbstractClient *, bool h, bool v);
@@ -33,4 +62,5 @@ Q_SIGNALS:
     void clientRemoved(KWin::AbstractClient *);
     void clientUnminimized(KWin::AbstractClient *);
     void currentDesktopChanged(int desktop, KWin::AbstractClient *kwinClient);
+    void clientActivated(KWin::AbstractClient *);
 };
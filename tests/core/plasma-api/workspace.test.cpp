@@ -3,15 +3,19 @@
 
 #include <doctest/doctest.h>
 
+#include <QElapsedTimer>
 #include <QObject>
 #include <QQmlContext>
 #include <QQmlEngine>
 #include <QSignalSpy>
 
 #include "plasma-api/api.hpp"
-#include "plasma-api/client.hpp"
+#include "plasma-api/client_handle.hpp"
 #include "plasma-api/workspace.hpp"
 
+#include "plasma-api/client.mock.hpp"
+#include "plasma-api/workspace.mock.hpp"
+
 // Mock KWin Objects. This is for tests only.
 namespace KWin
 {
@@ -42,6 +46,9 @@ Q_SIGNALS:
     // Not all signals are used, some of them declared to avoid warnings
     void numberScreensChanged(int);
     void screenResized(int);
+    void numberDesktopsChanged(uint);
+    void activityAdded(const QString &);
+    void activityRemoved(const QString &);
     void currentActivityChanged(const QString &);
     void clientAdded(KWin::AbstractClient *);
     void clientRemoved(KWin::AbstractClient *);
@@ -103,7 +110,7 @@ TEST_CASE("Workspace Properties Signals")
     SUBCASE("currentDesktop")
     {
         qRegisterMetaType<KWin::AbstractClient *>();
-        auto signalSpy = QSignalSpy(&workspace, SIGNAL(currentDesktopChanged(int, PlasmaApi::Client)));
+        auto signalSpy = QSignalSpy(&workspace, SIGNAL(currentDesktopChanged(int, PlasmaApi::ClientHandle)));
         auto mockKWinClient = KWin::AbstractClient();
 
         // Act
@@ -117,8 +124,181 @@ TEST_CASE("Workspace Properties Signals")
         auto clientVariant = signal.at(1);
 
         CHECK(desktopNum == 69);
-        CHECK(clientVariant.canConvert<PlasmaApi::Client>());
+        CHECK(clientVariant.canConvert<PlasmaApi::ClientHandle>());
+    }
+}
+
+TEST_CASE("Workspace Methods")
+{
+    auto fakeKWinWorkspace = FakeKWinWorkspace();
+    auto workspace = PlasmaApi::Workspace(&fakeKWinWorkspace);
+
+    SUBCASE("clientArea")
+    {
+        CHECK(workspace.clientArea(PlasmaApi::Workspace::MaximizeArea, 1, 1) == QRect(1920, 0, 1920, 1080));
+
+        // Second call goes through the resolved method
+        CHECK(workspace.clientArea(PlasmaApi::Workspace::MaximizeArea, 0, 1) == QRect(0, 0, 1920, 1080));
+    }
+
+    SUBCASE("Another implementation is resolved separately")
+    {
+        workspace.clientArea(PlasmaApi::Workspace::MaximizeArea, 1, 1);
+
+        // This implementation has no such method
+        auto mockWorkspace = MockWorkspaceJS();
+        auto otherWorkspace = PlasmaApi::Workspace(&mockWorkspace);
+        CHECK(otherWorkspace.clientArea(PlasmaApi::Workspace::MaximizeArea, 1, 1) == QRect());
+
+        CHECK(workspace.clientArea(PlasmaApi::Workspace::MaximizeArea, 1, 1) == QRect(1920, 0, 1920, 1080));
+    }
+}
+
+TEST_CASE("Workspace Topology Cache")
+{
+    auto fakeKWinWorkspace = FakeKWinWorkspace();
+    fakeKWinWorkspace.m_numScreens = 1;
+    fakeKWinWorkspace.m_numberOfDesktops = 2;
+    fakeKWinWorkspace.m_activities = QStringList({QStringLiteral("a")});
+    auto workspace = PlasmaApi::Workspace(&fakeKWinWorkspace);
+
+    auto area = [&](int screen) {
+        return workspace.clientArea(PlasmaApi::Workspace::PlacementArea, screen, 1);
+    };
+
+    CHECK(area(0) == QRect(0, 0, 1920, 1080));
+    CHECK(area(1) == QRect(1920, 0, 1920, 1080));
+    CHECK(workspace.numScreens() == 1);
+    CHECK(workspace.desktops() == 2);
+    CHECK(workspace.activities().size() == 1);
+
+    fakeKWinWorkspace.m_clientAreaCalls = 0;
+
+    SUBCASE("Topology is read once")
+    {
+        for (auto i = 0; i < 10; i++) {
+            area(0);
+            area(1);
+        }
+        CHECK(fakeKWinWorkspace.m_clientAreaCalls == 0);
+
+        // Without a signal the change is not noticed
+        fakeKWinWorkspace.m_numScreens = 2;
+        fakeKWinWorkspace.m_numberOfDesktops = 3;
+        CHECK(workspace.numScreens() == 1);
+        CHECK(workspace.desktops() == 2);
+    }
+
+    SUBCASE("Screen resize")
+    {
+        Q_EMIT fakeKWinWorkspace.screenResized(0);
+
+        area(0);
+        CHECK(fakeKWinWorkspace.m_clientAreaCalls == 1);
+    }
+
+    SUBCASE("Number of screens changed")
+    {
+        fakeKWinWorkspace.m_numScreens = 2;
+
+        // The handlers of the forwarded signal see the new topology
+        auto numScreensInHandler = 0;
+        QObject::connect(&workspace, &PlasmaApi::Workspace::numberScreensChanged, [&](int) {
+            numScreensInHandler = workspace.numScreens();
+        });
+        Q_EMIT fakeKWinWorkspace.numberScreensChanged(2);
+
+        CHECK(numScreensInHandler == 2);
+        area(0);
+        CHECK(fakeKWinWorkspace.m_clientAreaCalls == 1);
+    }
+
+    SUBCASE("Number of desktops changed")
+    {
+        fakeKWinWorkspace.m_numberOfDesktops = 3;
+        Q_EMIT fakeKWinWorkspace.numberDesktopsChanged(2);
+
+        CHECK(workspace.desktops() == 3);
+        area(0);
+        CHECK(fakeKWinWorkspace.m_clientAreaCalls == 1);
+
+        workspace.setDesktops(4);
+        CHECK(workspace.desktops() == 4);
     }
+
+    SUBCASE("Activity added")
+    {
+        fakeKWinWorkspace.m_activities.append(QStringLiteral("b"));
+        Q_EMIT fakeKWinWorkspace.activityAdded(QStringLiteral("b"));
+
+        CHECK(workspace.activities().size() == 2);
+
+        // Activities do not change the areas
+        area(0);
+        CHECK(fakeKWinWorkspace.m_clientAreaCalls == 0);
+    }
+
+    SUBCASE("Panels change the areas")
+    {
+        auto panel = FakeKWinClient();
+        panel.setProperty("dock", true);
+        auto panelClient = reinterpret_cast<KWin::AbstractClient *>(&panel);
+
+        Q_EMIT fakeKWinWorkspace.clientAdded(panelClient);
+        area(0);
+        CHECK(fakeKWinWorkspace.m_clientAreaCalls == 1);
+
+        Q_EMIT panel.frameGeometryChanged();
+        area(0);
+        CHECK(fakeKWinWorkspace.m_clientAreaCalls == 2);
+
+        Q_EMIT fakeKWinWorkspace.clientRemoved(panelClient);
+        area(0);
+        CHECK(fakeKWinWorkspace.m_clientAreaCalls == 3);
+
+        // Other windows do not change the areas
+        auto window = FakeKWinClient();
+        Q_EMIT fakeKWinWorkspace.clientAdded(reinterpret_cast<KWin::AbstractClient *>(&window));
+        Q_EMIT window.frameGeometryChanged();
+        area(0);
+        CHECK(fakeKWinWorkspace.m_clientAreaCalls == 3);
+    }
+}
+
+TEST_CASE("Workspace clientArea Benchmark" * doctest::test_suite("benchmark") * doctest::skip())
+{
+    constexpr auto iterations = 100000;
+
+    auto fakeKWinWorkspace = FakeKWinWorkspace();
+    auto workspace = PlasmaApi::Workspace(&fakeKWinWorkspace);
+    auto option = PlasmaApi::Workspace::MaximizeArea;
+
+    // What BI_METHOD_IMPL_WRAP did before: resolve the method on every call
+    auto resolvingTimer = QElapsedTimer();
+    resolvingTimer.start();
+    for (auto i = 0; i < iterations; i++) {
+        auto implMeta = fakeKWinWorkspace.metaObject();
+        auto normSignature = QMetaObject::normalizedSignature("clientArea(ClientAreaOption, int, int)");
+        auto method = implMeta->method(implMeta->indexOfMethod(normSignature));
+        auto result = QRect();
+        method.invoke(&fakeKWinWorkspace,
+                      Qt::DirectConnection,
+                      Q_RETURN_ARG(QRect, result),
+                      Q_ARG(PlasmaApi::Workspace::ClientAreaOption, option),
+                      Q_ARG(int, i % 4),
+                      Q_ARG(int, 1));
+    }
+    auto resolvingNs = resolvingTimer.nsecsElapsed();
+
+    auto cachedTimer = QElapsedTimer();
+    cachedTimer.start();
+    for (auto i = 0; i < iterations; i++) {
+        workspace.clientArea(option, i % 4, 1);
+    }
+    auto cachedNs = cachedTimer.nsecsElapsed();
+
+    MESSAGE("Time per clientArea call, resolved on each call: " << resolvingNs / iterations << " ns");
+    MESSAGE("Time per clientArea call, cached: " << cachedNs / iterations << " ns");
 }
 
 #include "workspace.test.moc"
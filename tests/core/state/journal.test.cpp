@@ -0,0 +1,99 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include <doctest/doctest.h>
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+
+#include "state/journal.hpp"
+
+TEST_CASE("Journal")
+{
+    auto tmpDir = QTemporaryDir();
+    auto journalPath = QDir(tmpDir.path()).filePath(QStringLiteral("test.journal"));
+
+    auto records = std::vector<Bismuth::StateRecord>({
+        {Bismuth::StateRecord::Kind::WindowState, QStringLiteral("42"), QByteArrayLiteral("state")},
+        {Bismuth::StateRecord::Kind::LayoutState, QStringLiteral("TileLayout"), QByteArrayLiteral("{}")},
+    });
+
+    SUBCASE("Appended records are replayed in order")
+    {
+        {
+            auto journal = Bismuth::Journal(journalPath);
+            journal.replay();
+            REQUIRE(journal.append(records));
+        }
+
+        auto journal = Bismuth::Journal(journalPath);
+        auto replayed = journal.replay();
+
+        REQUIRE(replayed.size() == 2);
+        CHECK(replayed[0].kind == Bismuth::StateRecord::Kind::WindowState);
+        CHECK(replayed[0].key == QStringLiteral("42"));
+        CHECK(replayed[0].value == QByteArrayLiteral("state"));
+        CHECK(replayed[1].kind == Bismuth::StateRecord::Kind::LayoutState);
+        CHECK(replayed[1].key == QStringLiteral("TileLayout"));
+    }
+
+    SUBCASE("Torn tail is discarded")
+    {
+        {
+            auto journal = Bismuth::Journal(journalPath);
+            journal.replay();
+            REQUIRE(journal.append(records));
+        }
+
+        auto intactSize = QFileInfo(journalPath).size();
+
+        // Cut the last record in half, as if the write was interrupted
+        {
+            auto lastRecord = Bismuth::Journal(QDir(tmpDir.path()).filePath(QStringLiteral("last.journal")));
+            lastRecord.replay();
+            lastRecord.append({records.back()});
+            REQUIRE(QFile::resize(journalPath, intactSize - lastRecord.size() / 2));
+        }
+
+        auto journal = Bismuth::Journal(journalPath);
+        auto replayed = journal.replay();
+
+        REQUIRE(replayed.size() == 1);
+        CHECK(replayed[0].key == QStringLiteral("42"));
+
+        // New records go right after the intact ones
+        REQUIRE(journal.append({records.back()}));
+        CHECK(Bismuth::Journal(journalPath).replay().size() == 2);
+    }
+
+    SUBCASE("Corrupted record is discarded")
+    {
+        {
+            auto journal = Bismuth::Journal(journalPath);
+            journal.replay();
+            REQUIRE(journal.append(records));
+        }
+
+        {
+            auto file = QFile(journalPath);
+            REQUIRE(file.open(QIODevice::ReadWrite));
+            file.seek(file.size() - 1);
+            file.write("X");
+        }
+
+        CHECK(Bismuth::Journal(journalPath).replay().size() == 1);
+    }
+
+    SUBCASE("Cleared journal is empty")
+    {
+        auto journal = Bismuth::Journal(journalPath);
+        journal.replay();
+        REQUIRE(journal.append(records));
+        journal.clear();
+
+        CHECK(journal.size() == 0);
+        CHECK(Bismuth::Journal(journalPath).replay().empty());
+    }
+}
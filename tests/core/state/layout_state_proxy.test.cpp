@@ -0,0 +1,54 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include <doctest/doctest.h>
+
+#include <QDir>
+#include <QFileInfo>
+#include <QTemporaryDir>
+
+#include "state/layout_state_proxy.hpp"
+#include "state/state_store.hpp"
+
+TEST_CASE("Layout State Proxy")
+{
+    auto tmpDir = QTemporaryDir();
+    auto store = Bismuth::StateStore(tmpDir.path());
+    auto layoutState = Bismuth::LayoutStateProxy(store, QStringLiteral("0:1"));
+
+    SUBCASE("Unknown layout state has the defaults")
+    {
+        CHECK(layoutState.property("classID").toString().isEmpty());
+        CHECK(layoutState.property("rotation").toInt() == 0);
+        CHECK(layoutState.property("numMasterTiles").toInt() == 1);
+        CHECK(layoutState.property("masterRatio").toDouble() == doctest::Approx(0.5));
+    }
+
+    SUBCASE("Properties are written to the store")
+    {
+        layoutState.setProperty("classID", QStringLiteral("TileLayout"));
+        layoutState.setProperty("rotation", 270);
+        layoutState.setProperty("numMasterTiles", 3);
+        layoutState.setProperty("masterRatio", 0.65);
+
+        auto state = store.layoutState(QStringLiteral("0:1"));
+        CHECK(state.classId == QStringLiteral("TileLayout"));
+        CHECK(state.rotation == 270);
+        CHECK(state.masterCount == 3);
+        CHECK(state.masterRatio == doctest::Approx(0.65));
+    }
+
+    SUBCASE("Unchanged value is not written")
+    {
+        layoutState.setProperty("rotation", 90);
+        store.flush();
+
+        auto journalPath = QDir(tmpDir.path()).filePath(QStringLiteral("kwin-bismuth-state.journal"));
+        auto journalSize = QFileInfo(journalPath).size();
+
+        layoutState.setProperty("rotation", 90);
+        store.flush();
+
+        CHECK(QFileInfo(journalPath).size() == journalSize);
+    }
+}
@@ -0,0 +1,69 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include <doctest/doctest.h>
+
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+
+#include "state/snapshot.hpp"
+
+TEST_CASE("Mapped Snapshot")
+{
+    auto tmpDir = QTemporaryDir();
+    auto snapshotPath = QDir(tmpDir.path()).filePath(QStringLiteral("test.snapshot"));
+    auto payload = QByteArrayLiteral("tiling state");
+
+    auto writeSnapshot = [&](const QByteArray &contents) {
+        auto file = QFile(snapshotPath);
+        REQUIRE(file.open(QIODevice::WriteOnly));
+        file.write(contents);
+    };
+
+    SUBCASE("Packed payload is read back")
+    {
+        writeSnapshot(Bismuth::MappedSnapshot::pack(payload));
+
+        auto snapshot = Bismuth::MappedSnapshot(snapshotPath);
+        REQUIRE(snapshot.isValid());
+        CHECK(snapshot.fileVersion() == Bismuth::MappedSnapshot::version);
+        CHECK(snapshot.payload() == payload);
+    }
+
+    SUBCASE("Missing snapshot is invalid")
+    {
+        auto snapshot = Bismuth::MappedSnapshot(snapshotPath);
+        CHECK(snapshot.isValid() == false);
+    }
+
+    SUBCASE("Snapshot with a damaged payload is invalid")
+    {
+        auto contents = Bismuth::MappedSnapshot::pack(payload);
+        contents[contents.size() - 1] = 'X';
+        writeSnapshot(contents);
+
+        auto snapshot = Bismuth::MappedSnapshot(snapshotPath);
+        CHECK(snapshot.isValid() == false);
+    }
+
+    SUBCASE("Truncated snapshot is invalid")
+    {
+        writeSnapshot(Bismuth::MappedSnapshot::pack(payload).chopped(1));
+
+        auto snapshot = Bismuth::MappedSnapshot(snapshotPath);
+        CHECK(snapshot.isValid() == false);
+    }
+
+    SUBCASE("Snapshot of another version is read with its version")
+    {
+        auto contents = Bismuth::MappedSnapshot::pack(payload);
+        contents[4] = static_cast<char>(Bismuth::MappedSnapshot::version + 1);
+        writeSnapshot(contents);
+
+        auto snapshot = Bismuth::MappedSnapshot(snapshotPath);
+        REQUIRE(snapshot.isValid());
+        CHECK(snapshot.fileVersion() == Bismuth::MappedSnapshot::version + 1);
+        CHECK(snapshot.payload() == payload);
+    }
+}
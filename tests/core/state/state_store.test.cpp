@@ -0,0 +1,642 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include <doctest/doctest.h>
+
+#include <QDataStream>
+#include <QDeadlineTimer>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRect>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QThread>
+
+#include "state/snapshot.hpp"
+#include "state/state_store.hpp"
+#include "state/window_fingerprint.hpp"
+
+TEST_CASE("State Store Window States")
+{
+    auto tmpDir = QTemporaryDir();
+    auto journalPath = QDir(tmpDir.path()).filePath(QStringLiteral("kwin-bismuth-state.journal"));
+
+    auto state = Bismuth::WindowState();
+    state.group = 4;
+
+    SUBCASE("Reads are answered from memory before the write")
+    {
+        auto store = Bismuth::StateStore(tmpDir.path());
+        store.setWindowState(QStringLiteral("42"), state);
+
+        CHECK(store.windowState(QStringLiteral("42")) == state);
+        CHECK(QFileInfo(journalPath).size() == 0);
+    }
+
+    SUBCASE("Flushed states are loaded on startup")
+    {
+        {
+            auto store = Bismuth::StateStore(tmpDir.path());
+            store.setWindowState(QStringLiteral("42"), state);
+            store.flush();
+        }
+
+        auto store = Bismuth::StateStore(tmpDir.path());
+        CHECK(store.windowState(QStringLiteral("42")) == state);
+    }
+
+    SUBCASE("Pending states are written on destruction")
+    {
+        {
+            auto store = Bismuth::StateStore(tmpDir.path());
+            store.setWindowState(QStringLiteral("42"), state);
+        }
+
+        auto store = Bismuth::StateStore(tmpDir.path());
+        CHECK(store.windowState(QStringLiteral("42")) == state);
+    }
+
+    SUBCASE("Unknown window has an empty state")
+    {
+        auto store = Bismuth::StateStore(tmpDir.path());
+        CHECK(store.windowState(QStringLiteral("69")) == Bismuth::WindowState());
+    }
+
+    SUBCASE("Single field changes keep the other fields")
+    {
+        auto store = Bismuth::StateStore(tmpDir.path());
+        store.setWindowState(QStringLiteral("42"), state);
+        store.setWindowMinimized(QStringLiteral("42"), true);
+
+        CHECK(store.windowGroup(QStringLiteral("42")) == 4);
+        CHECK(store.windowMinimized(QStringLiteral("42")) == true);
+    }
+}
+
+TEST_CASE("State Store Surface Groups")
+{
+    auto tmpDir = QTemporaryDir();
+
+    SUBCASE("Unassigned surface has no group")
+    {
+        auto store = Bismuth::StateStore(tmpDir.path());
+        CHECK(store.surfaceGroup(1, 0) == 0);
+        CHECK(store.surfaceGroup(0, 0) == 0);
+        CHECK(store.surfaceGroup(1, -1) == 0);
+    }
+
+    SUBCASE("Adding a screen keeps the groups of the other surfaces")
+    {
+        auto store = Bismuth::StateStore(tmpDir.path());
+        store.setSurfaceGroup(1, 0, 4);
+        store.setSurfaceGroup(2, 0, 9);
+        store.setSurfaceGroup(2, 3, 7);
+
+        CHECK(store.surfaceGroup(1, 0) == 4);
+        CHECK(store.surfaceGroup(2, 0) == 9);
+        CHECK(store.surfaceGroup(2, 3) == 7);
+        CHECK(store.surfaceGroup(1, 3) == 0);
+    }
+
+    SUBCASE("Group change is signaled once")
+    {
+        auto store = Bismuth::StateStore(tmpDir.path());
+        auto signalSpy = QSignalSpy(&store, &Bismuth::StateStore::surfaceGroupChanged);
+
+        store.setSurfaceGroup(2, 1, 5);
+        store.setSurfaceGroup(2, 1, 5);
+
+        REQUIRE(signalSpy.count() == 1);
+        auto signal = signalSpy.takeFirst();
+        CHECK(signal.at(0).toInt() == 2);
+        CHECK(signal.at(1).toInt() == 1);
+        CHECK(signal.at(2).toInt() == 5);
+    }
+
+    SUBCASE("Surfaces out of range are ignored")
+    {
+        {
+            auto legacyFile = QFile(QDir(tmpDir.path()).filePath(QStringLiteral("kwin-bismuth-surfacegroups.json")));
+            REQUIRE(legacyFile.open(QIODevice::WriteOnly | QIODevice::Text));
+            legacyFile.write(R"({"Surfaces": {"100000000:0": {"group": 3}, "2:100000000": {"group": 4}, "2:1": {"group": 5}}})");
+        }
+
+        auto store = Bismuth::StateStore(tmpDir.path());
+        CHECK(store.surfaceGroup(2, 1) == 5);
+        CHECK(store.surfaceGroup(100000000, 0) == 0);
+
+        store.setSurfaceGroup(1000, 0, 6);
+        CHECK(store.surfaceGroup(1000, 0) == 0);
+    }
+
+    SUBCASE("Flushed groups are loaded on startup")
+    {
+        {
+            auto store = Bismuth::StateStore(tmpDir.path());
+            store.setSurfaceGroup(3, 2, 11);
+        }
+
+        auto store = Bismuth::StateStore(tmpDir.path());
+        CHECK(store.surfaceGroup(3, 2) == 11);
+    }
+}
+
+TEST_CASE("State Store Persistence")
+{
+    auto tmpDir = QTemporaryDir();
+    auto journalPath = QDir(tmpDir.path()).filePath(QStringLiteral("kwin-bismuth-state.journal"));
+    auto snapshotPath = QDir(tmpDir.path()).filePath(QStringLiteral("kwin-bismuth-state.snapshot"));
+
+    auto layoutState = Bismuth::LayoutState();
+    layoutState.classId = QStringLiteral("TileLayout");
+    layoutState.rotation = 90;
+    layoutState.masterCount = 2;
+
+    auto windowList = QStringList({QStringLiteral("42"), QStringLiteral("69")});
+
+    SUBCASE("Layout states and window list are loaded on startup")
+    {
+        {
+            auto store = Bismuth::StateStore(tmpDir.path());
+            store.setLayoutState(QStringLiteral("TileLayout"), layoutState);
+            store.setWindowList(windowList);
+        }
+
+        auto store = Bismuth::StateStore(tmpDir.path());
+        CHECK(store.layoutState(QStringLiteral("TileLayout")) == layoutState);
+        CHECK(store.windowList() == windowList);
+    }
+
+    SUBCASE("Window ids and window fingerprints are kept apart")
+    {
+        auto windowOrder = Bismuth::windowFingerprints({Bismuth::WindowIdentity()});
+
+        {
+            auto store = Bismuth::StateStore(tmpDir.path());
+            store.setWindowList(windowList);
+            store.setWindowOrder(windowOrder);
+        }
+
+        {
+            auto store = Bismuth::StateStore(tmpDir.path());
+            CHECK(store.windowList() == windowList);
+            CHECK(store.windowOrder() == windowOrder);
+
+            store.compact();
+            store.flush();
+        }
+
+        auto store = Bismuth::StateStore(tmpDir.path());
+        CHECK(store.windowList() == windowList);
+        CHECK(store.windowOrder() == windowOrder);
+    }
+
+    SUBCASE("Fingerprints saved as the window list are moved to the window order")
+    {
+        auto windowOrder = Bismuth::windowFingerprints({Bismuth::WindowIdentity()});
+
+        {
+            auto value = QByteArray();
+            auto stream = QDataStream(&value, QIODevice::WriteOnly);
+            stream.setVersion(Bismuth::stateStreamVersion);
+            stream << windowOrder;
+
+            auto journal = Bismuth::Journal(journalPath);
+            REQUIRE(journal.append({{Bismuth::StateRecord::Kind::WindowList, {}, value}}));
+        }
+
+        auto store = Bismuth::StateStore(tmpDir.path());
+        CHECK(store.windowList().isEmpty());
+        CHECK(store.windowOrder() == windowOrder);
+    }
+
+    SUBCASE("Compaction moves the journal into the snapshot")
+    {
+        {
+            auto store = Bismuth::StateStore(tmpDir.path());
+            store.setWindowGroup(QStringLiteral("42"), 3);
+            store.setWindowFloatGeometry(QStringLiteral("42"), QRect(10, 20, 300, 400));
+            store.setSurfaceGroup(1, 1, 3);
+            store.setLayoutState(QStringLiteral("TileLayout"), layoutState);
+            store.setWindowList(windowList);
+            store.compact();
+            store.flush();
+
+            CHECK(QFileInfo(journalPath).size() == 0);
+            CHECK(QFile::exists(snapshotPath));
+        }
+
+        auto store = Bismuth::StateStore(tmpDir.path());
+        CHECK(store.windowGroup(QStringLiteral("42")) == 3);
+        CHECK(store.windowFloatGeometry(QStringLiteral("42")) == QRect(10, 20, 300, 400));
+        CHECK(store.surfaceGroup(1, 1) == 3);
+        CHECK(store.layoutState(QStringLiteral("TileLayout")) == layoutState);
+        CHECK(store.windowList() == windowList);
+    }
+
+    SUBCASE("Journal is replayed on top of the snapshot")
+    {
+        {
+            auto store = Bismuth::StateStore(tmpDir.path());
+            store.setWindowGroup(QStringLiteral("42"), 3);
+            store.compact();
+            store.flush();
+            store.setWindowGroup(QStringLiteral("42"), 5);
+        }
+
+        auto store = Bismuth::StateStore(tmpDir.path());
+        CHECK(store.windowGroup(QStringLiteral("42")) == 5);
+    }
+
+    SUBCASE("Torn journal tail keeps the intact changes")
+    {
+        {
+            auto store = Bismuth::StateStore(tmpDir.path());
+            store.setWindowGroup(QStringLiteral("42"), 3);
+        }
+
+        {
+            auto journal = QFile(journalPath);
+            REQUIRE(journal.open(QIODevice::WriteOnly | QIODevice::Append));
+            journal.write("\x20\x00\x00\x00garbage", 11);
+        }
+
+        auto store = Bismuth::StateStore(tmpDir.path());
+        CHECK(store.windowGroup(QStringLiteral("42")) == 3);
+    }
+
+    SUBCASE("Snapshot of another version is kept")
+    {
+        {
+            auto store = Bismuth::StateStore(tmpDir.path());
+            store.setWindowGroup(QStringLiteral("42"), 3);
+            store.compact();
+            store.flush();
+        }
+
+        auto contents = QByteArray();
+        {
+            auto snapshot = QFile(snapshotPath);
+            REQUIRE(snapshot.open(QIODevice::ReadWrite));
+            contents = snapshot.readAll();
+            contents[4] = static_cast<char>(Bismuth::MappedSnapshot::version + 1);
+            snapshot.seek(0);
+            snapshot.write(contents);
+        }
+
+        {
+            auto store = Bismuth::StateStore(tmpDir.path());
+            CHECK(store.windowGroup(QStringLiteral("42")) == 0);
+
+            store.setWindowGroup(QStringLiteral("42"), 5);
+            store.compact();
+        }
+
+        auto keptSnapshot = QFile(QStringLiteral("%1.v%2").arg(snapshotPath).arg(Bismuth::MappedSnapshot::version + 1));
+        REQUIRE(keptSnapshot.open(QIODevice::ReadOnly));
+        CHECK(keptSnapshot.readAll() == contents);
+    }
+
+    SUBCASE("Damaged snapshot falls back to the legacy files")
+    {
+        {
+            auto store = Bismuth::StateStore(tmpDir.path());
+            store.setWindowGroup(QStringLiteral("42"), 3);
+            store.compact();
+            store.flush();
+        }
+
+        {
+            auto snapshot = QFile(snapshotPath);
+            REQUIRE(snapshot.open(QIODevice::ReadWrite));
+            snapshot.seek(snapshot.size() - 1);
+            snapshot.write("X");
+        }
+
+        {
+            auto legacyFile = QFile(QDir(tmpDir.path()).filePath(QStringLiteral("kwin-bismuth-windowstates.json")));
+            REQUIRE(legacyFile.open(QIODevice::WriteOnly | QIODevice::Text));
+            legacyFile.write(R"({"WindowStates": {"42": {"group": 7, "minimized": false}}})");
+        }
+
+        auto store = Bismuth::StateStore(tmpDir.path());
+        CHECK(store.windowGroup(QStringLiteral("42")) == 7);
+    }
+
+    SUBCASE("Legacy files are imported without a snapshot")
+    {
+        {
+            auto legacyFile = QFile(QDir(tmpDir.path()).filePath(QStringLiteral("kwin-bismuth-windowlist.json")));
+            REQUIRE(legacyFile.open(QIODevice::WriteOnly | QIODevice::Text));
+            legacyFile.write(R"({"WindowList": ["42", "69"]})");
+        }
+
+        auto store = Bismuth::StateStore(tmpDir.path());
+        CHECK(store.windowList() == windowList);
+        store.flush();
+
+        // The next start reads the snapshot instead of the legacy files
+        CHECK(QFile::exists(snapshotPath));
+    }
+
+    SUBCASE("State is compacted on shutdown")
+    {
+        {
+            auto store = Bismuth::StateStore(tmpDir.path());
+            store.setWindowGroup(QStringLiteral("42"), 3);
+        }
+
+        CHECK(QFileInfo(journalPath).size() == 0);
+        CHECK(QFile::exists(snapshotPath));
+
+        auto store = Bismuth::StateStore(tmpDir.path());
+        CHECK(store.windowGroup(QStringLiteral("42")) == 3);
+    }
+
+    SUBCASE("Legacy file changed externally is journaled")
+    {
+        auto legacyPath = QDir(tmpDir.path()).filePath(QStringLiteral("kwin-bismuth-windowstates.json"));
+
+        auto store = Bismuth::StateStore(tmpDir.path());
+        store.setWindowGroup(QStringLiteral("69"), 1);
+
+        {
+            auto legacyFile = QFile(legacyPath);
+            REQUIRE(legacyFile.open(QIODevice::WriteOnly | QIODevice::Text));
+            legacyFile.write(R"({"WindowStates": {"42": {"group": 7}, "69": {"group": 8}}})");
+        }
+        QMetaObject::invokeMethod(&store, "onLegacyFileChanged", Q_ARG(QString, legacyPath));
+        store.flush();
+
+        CHECK(store.windowGroup(QStringLiteral("42")) == 7);
+
+        // The change, that was not on disk yet, is newer than the file
+        CHECK(store.windowGroup(QStringLiteral("69")) == 1);
+
+        auto journaledGroups = QHash<QString, int>();
+        for (auto &journalRecord : Bismuth::Journal(journalPath).replay()) {
+            if (journalRecord.kind == Bismuth::StateRecord::Kind::WindowState) {
+                journaledGroups.insert(journalRecord.key, Bismuth::WindowState::deserialize(journalRecord.value).group);
+            }
+        }
+        CHECK(journaledGroups.value(QStringLiteral("42")) == 7);
+        CHECK(journaledGroups.value(QStringLiteral("69")) == 1);
+    }
+}
+
+TEST_CASE("State Store Repeated Changes Are Coalesced")
+{
+    auto tmpDir = QTemporaryDir();
+    auto journalPath = QDir(tmpDir.path()).filePath(QStringLiteral("kwin-bismuth-state.journal"));
+
+    auto store = Bismuth::StateStore(tmpDir.path());
+    for (auto group = 1; group <= 100; group++) {
+        store.setWindowGroup(QStringLiteral("42"), group);
+    }
+    store.flush();
+
+    auto journal = Bismuth::Journal(journalPath);
+    auto records = journal.replay();
+
+    REQUIRE(records.size() == 1);
+    CHECK(Bismuth::WindowState::deserialize(records[0].value).group == 100);
+}
+
+TEST_CASE("State Store Transactions")
+{
+    auto tmpDir = QTemporaryDir();
+    auto journalPath = QDir(tmpDir.path()).filePath(QStringLiteral("kwin-bismuth-state.journal"));
+
+    // The events are not processed here, so only the commit can start the write
+    auto waitForJournal = [&]() {
+        auto deadline = QDeadlineTimer(5000);
+        while (QFileInfo(journalPath).size() == 0 && !deadline.hasExpired()) {
+            QThread::msleep(1);
+        }
+        return QFileInfo(journalPath).size() > 0;
+    };
+
+    auto store = Bismuth::StateStore(tmpDir.path());
+
+    SUBCASE("Changes are written once the transaction is committed")
+    {
+        {
+            auto transaction = Bismuth::StateTransaction(store);
+            store.setWindowGroup(QStringLiteral("42"), 1);
+            store.setWindowGroup(QStringLiteral("42"), 2);
+            store.setSurfaceGroup(1, 0, 3);
+            store.setWindowList({QStringLiteral("42")});
+        }
+
+        REQUIRE(waitForJournal());
+        store.flush();
+
+        auto records = Bismuth::Journal(journalPath).replay();
+        CHECK(records.size() == 3);
+    }
+
+    SUBCASE("Nested transaction is written by the outermost one")
+    {
+        {
+            auto outer = Bismuth::StateTransaction(store);
+            {
+                auto inner = Bismuth::StateTransaction(store);
+                store.setWindowGroup(QStringLiteral("42"), 1);
+            }
+
+            QThread::msleep(50);
+            CHECK(QFileInfo(journalPath).size() == 0);
+        }
+
+        CHECK(waitForJournal());
+    }
+
+    SUBCASE("Unmatched commit is ignored")
+    {
+        store.commitTransaction();
+
+        store.beginTransaction();
+        store.setWindowGroup(QStringLiteral("42"), 1);
+        store.commitTransaction();
+
+        CHECK(waitForJournal());
+    }
+}
+
+TEST_CASE("State Store Garbage Collection")
+{
+    auto tmpDir = QTemporaryDir();
+
+    // More closed windows, than the store retains
+    constexpr auto numClosedWindows = 100;
+
+    auto store = Bismuth::StateStore(tmpDir.path());
+    store.setWindowGroup(QStringLiteral("live"), 1);
+    for (auto i = 0; i < numClosedWindows; i++) {
+        store.setWindowGroup(QString::number(i), 1);
+    }
+
+    auto knownStatesCount = [&store]() {
+        auto count = 0;
+        for (auto i = 0; i < numClosedWindows; i++) {
+            count += store.windowGroup(QString::number(i)) != 0 ? 1 : 0;
+        }
+        return count;
+    };
+
+    SUBCASE("Live windows keep their states")
+    {
+        store.setLiveWindows({QStringLiteral("live")});
+        store.collectGarbage();
+
+        CHECK(store.windowGroup(QStringLiteral("live")) == 1);
+        CHECK(knownStatesCount() < numClosedWindows);
+        CHECK(knownStatesCount() > 0);
+    }
+
+    SUBCASE("Most recently closed windows keep their states")
+    {
+        store.setLiveWindows({QStringLiteral("live")});
+        store.windowAdded(QStringLiteral("closed"));
+        store.setWindowGroup(QStringLiteral("closed"), 1);
+        store.windowRemoved(QStringLiteral("closed"));
+        store.collectGarbage();
+
+        CHECK(store.windowGroup(QStringLiteral("closed")) == 1);
+    }
+
+    SUBCASE("Reopened window is not collected")
+    {
+        store.setLiveWindows({QStringLiteral("live")});
+        store.windowAdded(QStringLiteral("0"));
+        store.collectGarbage();
+
+        CHECK(store.windowGroup(QStringLiteral("0")) == 1);
+    }
+
+    SUBCASE("Nothing is collected on window removal alone")
+    {
+        store.setLiveWindows({});
+        for (auto i = 0; i < numClosedWindows; i++) {
+            store.windowRemoved(QString::number(i));
+        }
+
+        CHECK(knownStatesCount() == numClosedWindows);
+    }
+
+    SUBCASE("Collected states stay forgotten after restart")
+    {
+        store.setLiveWindows({QStringLiteral("live")});
+        store.collectGarbage();
+        auto countBeforeRestart = knownStatesCount();
+        store.flush();
+
+        auto restartedStore = Bismuth::StateStore(tmpDir.path());
+        auto countAfterRestart = 0;
+        for (auto i = 0; i < numClosedWindows; i++) {
+            countAfterRestart += restartedStore.windowGroup(QString::number(i)) != 0 ? 1 : 0;
+        }
+
+        CHECK(countAfterRestart == countBeforeRestart);
+    }
+
+    SUBCASE("Least recently closed windows are forgotten after restart")
+    {
+        auto allWindows = QStringList({QStringLiteral("live")});
+        for (auto i = 0; i < numClosedWindows; i++) {
+            allWindows.append(QString::number(i));
+        }
+
+        // KWin quits and removes the windows one by one
+        store.setLiveWindows(allWindows);
+        for (auto i = 0; i < numClosedWindows; i++) {
+            store.windowRemoved(QString::number(i));
+        }
+        store.flush();
+
+        auto restartedStore = Bismuth::StateStore(tmpDir.path());
+        restartedStore.setLiveWindows({QStringLiteral("live")});
+        restartedStore.collectGarbage();
+
+        CHECK(restartedStore.windowGroup(QString::number(0)) == 0);
+        for (auto i = numClosedWindows - 64; i < numClosedWindows; i++) {
+            CHECK(restartedStore.windowGroup(QString::number(i)) == 1);
+        }
+    }
+
+    SUBCASE("Nothing is collected on write, while the windows are going away")
+    {
+        auto allWindows = QStringList({QStringLiteral("live")});
+        for (auto i = 0; i < numClosedWindows; i++) {
+            allWindows.append(QString::number(i));
+        }
+
+        store.setLiveWindows(allWindows);
+        for (auto i = 0; i < numClosedWindows; i++) {
+            store.windowRemoved(QString::number(i));
+            QMetaObject::invokeMethod(&store, "onWriteTimeout");
+        }
+
+        CHECK(knownStatesCount() == numClosedWindows);
+
+        // Once the number of windows is stable, the collection goes on
+        QMetaObject::invokeMethod(&store, "onWriteTimeout");
+        CHECK(knownStatesCount() < numClosedWindows);
+    }
+}
+
+TEST_CASE("State Store putWindowList Benchmark" * doctest::test_suite("benchmark") * doctest::skip())
+{
+    constexpr auto iterations = 1000;
+    constexpr auto numWindows = 200;
+
+    auto tmpDir = QTemporaryDir();
+
+    auto windowIds = QJsonArray();
+    for (auto i = 0; i < numWindows; i++) {
+        windowIds.append(QString::number(0x4000000 + i));
+    }
+    auto listJson = QString::fromUtf8(QJsonDocument(windowIds).toJson());
+
+    // What TSProxy::putWindowList did before: read, patch and rewrite the file on every call
+    auto syncPath = QDir(tmpDir.path()).filePath(QStringLiteral("kwin-bismuth-windowlist.json"));
+    auto syncTimer = QElapsedTimer();
+    syncTimer.start();
+    for (auto i = 0; i < iterations; i++) {
+        auto file = QFile(syncPath);
+        file.open(QIODevice::ReadOnly | QIODevice::Text);
+        auto root = QJsonDocument::fromJson(file.readAll()).object();
+        file.close();
+
+        root[QStringLiteral("WindowList")] = QJsonDocument::fromJson(listJson.toUtf8()).array();
+
+        file.open(QIODevice::WriteOnly | QIODevice::Text);
+        file.write(QJsonDocument(root).toJson());
+        file.close();
+    }
+    auto syncNs = syncTimer.nsecsElapsed();
+
+    auto store = Bismuth::StateStore(tmpDir.path());
+    auto storeTimer = QElapsedTimer();
+    storeTimer.start();
+    for (auto i = 0; i < iterations; i++) {
+        auto list = QStringList();
+        for (auto windowId : QJsonDocument::fromJson(listJson.toUtf8()).array()) {
+            list.append(windowId.toString());
+        }
+
+        // Make every call an actual change
+        list.swapItemsAt(0, 1 + i % (numWindows - 1));
+        store.setWindowList(list);
+    }
+    auto storeNs = storeTimer.nsecsElapsed();
+    store.flush();
+
+    MESSAGE("Main thread time per putWindowList, synchronous file: " << syncNs / iterations / 1000 << " us");
+    MESSAGE("Main thread time per putWindowList, state store: " << storeNs / iterations / 1000 << " us");
+}
@@ -0,0 +1,99 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include <doctest/doctest.h>
+
+#include <algorithm>
+
+#include "state/window_fingerprint.hpp"
+
+namespace
+{
+Bismuth::WindowIdentity konsole(int pid, quint32 windowId, const QString &caption = QStringLiteral("~ : bash — Konsole"))
+{
+    auto result = Bismuth::WindowIdentity();
+    result.resourceClass = QStringLiteral("konsole");
+    result.resourceName = QStringLiteral("konsole");
+    result.caption = caption;
+    result.pid = pid;
+    result.windowId = windowId;
+    return result;
+}
+}
+
+TEST_CASE("Normalized Caption")
+{
+    CHECK(Bismuth::normalizedCaption(QStringLiteral("~ : bash — Konsole")) == QStringLiteral("konsole"));
+    CHECK(Bismuth::normalizedCaption(QStringLiteral("*notes.txt - Kate <2>")) == QStringLiteral("kate"));
+    CHECK(Bismuth::normalizedCaption(QStringLiteral("Inbox (12)")) == QStringLiteral("inbox ()"));
+}
+
+TEST_CASE("Window Fingerprints")
+{
+    SUBCASE("Fingerprints ignore the changing parts of the caption")
+    {
+        auto before = Bismuth::windowFingerprints({konsole(100, 1, QStringLiteral("~ : bash — Konsole"))});
+        auto after = Bismuth::windowFingerprints({konsole(200, 2, QStringLiteral("~/src : vim — Konsole"))});
+
+        CHECK(before == after);
+    }
+
+    SUBCASE("Similar windows are told apart by the process start order")
+    {
+        auto before = Bismuth::windowFingerprints({konsole(100, 1), konsole(300, 2)});
+        // After restart the processes got new ids and the windows are listed in other order
+        auto after = Bismuth::windowFingerprints({konsole(700, 9), konsole(500, 8)});
+
+        CHECK(before[0] != before[1]);
+        CHECK(before[0] == after[1]);
+        CHECK(before[1] == after[0]);
+    }
+}
+
+TEST_CASE("Window Fingerprint Cache")
+{
+    auto windows = std::vector<Bismuth::WindowIdentity>({konsole(300, 2), konsole(100, 1)});
+    auto windowIds = std::vector<quint32>({2, 1});
+
+    auto cache = Bismuth::WindowFingerprintCache();
+    auto identityReads = 0;
+    auto identity = [&](int index) {
+        identityReads++;
+        return windows[index];
+    };
+
+    SUBCASE("Cached fingerprints are the same as computed ones")
+    {
+        CHECK(cache.fingerprints(windowIds, identity) == Bismuth::windowFingerprints(windows));
+        CHECK(identityReads == 2);
+
+        // Nothing is read again, even in the other order
+        std::reverse(windows.begin(), windows.end());
+        std::reverse(windowIds.begin(), windowIds.end());
+        CHECK(cache.fingerprints(windowIds, identity) == Bismuth::windowFingerprints(windows));
+        CHECK(identityReads == 2);
+    }
+
+    SUBCASE("Invalidated window is read again")
+    {
+        cache.fingerprints(windowIds, identity);
+
+        windows[0] = konsole(300, 2, QStringLiteral("Settings — Dolphin"));
+        cache.invalidate(2);
+
+        CHECK(cache.fingerprints(windowIds, identity) == Bismuth::windowFingerprints(windows));
+        CHECK(identityReads == 3);
+    }
+}
+
+TEST_CASE("Window Order Restore")
+{
+    auto saved = QStringList({QStringLiteral("c"), QStringLiteral("gone"), QStringLiteral("a"), QStringLiteral("b")});
+    auto present = QStringList({QStringLiteral("a"), QStringLiteral("b"), QStringLiteral("c"), QStringLiteral("new")});
+
+    auto result = Bismuth::restoreWindowOrder(saved, present);
+
+    CHECK(result.order == std::vector<int>({2, 0, 1}));
+    CHECK(result.hits == 3);
+    CHECK(result.misses == 1);
+}